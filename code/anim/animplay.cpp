@@ -746,7 +746,8 @@ anim *anim_load(const char *real_filename, int cf_dir_type, int file_mapped)
 		ptr->cfile_ptr = NULL;
 
 		if ( file_mapped == PAGE_FROM_MEM) {
-			// Try mapping the file to memory 
+			// Try mapping the file to memory.  This only works for loose files; the frames are then read through
+			// ptr->data straight from the read-only mapping like from a loaded copy, and anim_free() closes the mapping.
 			ptr->flags |= ANF_MEM_MAPPED;
 			ptr->cfile_ptr = cfopen(name, "rb", CFILE_MEMORY_MAPPED, cf_dir_type);
 		}
@@ -0,0 +1,177 @@
+#include "bmpman/bm_cache.h"
+
+#include "cfile/cfilecache.h"
+#include "cmdline/cmdline.h"
+#include "parse/parselo.h"
+
+#include <climits>
+
+namespace {
+
+const cf_cache_type BM_CACHE_TYPE = { "bm_cache-", 0x434D4246 /* "FBMC" */, 1 };
+
+struct bm_cache_header {
+	cf_cache_header base;
+
+	// The key, to protect against hash collisions
+	uint source_checksum;
+	int source_size;
+	int type;
+	int w;
+	int h;
+	int bpp;
+	int flags;
+	int compression;
+
+	// Information about the stored data
+	int data_bpp;
+	int data_flags;
+	uint data_size;
+};
+
+void fill_header(bm_cache_header* header, const bm_cache_key& key)
+{
+	memset(header, 0, sizeof(*header));
+
+	cf_cache_fill_header(&header->base, BM_CACHE_TYPE);
+	header->source_checksum = key.source_checksum;
+	header->source_size     = key.source_size;
+	header->type            = key.type;
+	header->w               = key.w;
+	header->h               = key.h;
+	header->bpp             = key.bpp;
+	header->flags           = key.flags;
+	header->compression     = key.compression;
+}
+
+bool header_matches(const bm_cache_header& header, const bm_cache_key& key, size_t size)
+{
+	bm_cache_header expected;
+	fill_header(&expected, key);
+
+	return cf_cache_header_matches(header.base, BM_CACHE_TYPE)
+		&& header.source_checksum == expected.source_checksum && header.source_size == expected.source_size
+		&& header.type == expected.type && header.w == expected.w && header.h == expected.h
+		&& header.bpp == expected.bpp && header.flags == expected.flags && header.compression == expected.compression && header.data_size == size;
+}
+
+SCP_string get_cache_filename(const bm_cache_key& key)
+{
+	SCP_string key_string;
+	sprintf(key_string, "%08x:%d:%d:%dx%d:%d:%d:%d", key.source_checksum, key.source_size, (int)key.type, key.w, key.h,
+	        key.bpp, (int)key.flags, key.compression);
+
+	return cf_cache_get_filename(BM_CACHE_TYPE, key_string);
+}
+
+void apply_header(const bm_cache_header& header, bitmap* bmp)
+{
+	bmp->bpp   = header.data_bpp;
+	bmp->flags = (ushort)header.data_flags;
+}
+
+} // namespace
+
+bool bm_cache_enabled()
+{
+	return Cmdline_bitmap_cache;
+}
+
+void bm_cache_make_key(bm_cache_key* key, CFILE* source, BM_TYPE type, const bitmap* bmp, ushort flags)
+{
+	Assertion(key != nullptr, "Invalid key pointer!");
+
+	*key = bm_cache_key();
+
+	key->source_size = cfilelength(source);
+	cf_chksum_long(source, &key->source_checksum);
+
+	key->type  = type;
+	key->w     = bmp->w;
+	key->h     = bmp->h;
+	key->bpp   = bmp->bpp;
+	key->flags = flags;
+}
+
+bool bm_cache_read(const bm_cache_key& key, bitmap* bmp, void* data, size_t size)
+{
+	auto filename = get_cache_filename(key);
+
+	// Try memory mapping first since that avoids copying the data through the cfile buffers
+	auto cfp = cf_cache_open_read(filename, CFILE_MEMORY_MAPPED);
+	if (cfp != nullptr) {
+		auto length = static_cast<size_t>(cfilelength(cfp));
+		auto file_data = static_cast<const ubyte*>(cf_returndata(cfp));
+
+		bm_cache_header header;
+		bool valid = false;
+
+		if (length == sizeof(header) + size) {
+			memcpy(&header, file_data, sizeof(header));
+
+			if (header_matches(header, key, size)) {
+				memcpy(data, file_data + sizeof(header), size);
+				apply_header(header, bmp);
+				valid = true;
+			}
+		}
+
+		cfclose(cfp);
+
+		if (!valid) {
+			nprintf(("BmpCache", "Cache file %s does not match its key.\n", filename.c_str()));
+		}
+		return valid;
+	}
+
+	cfp = cf_cache_open_read(filename);
+	if (cfp == nullptr) {
+		return false;
+	}
+
+	bm_cache_header header;
+	bool valid = false;
+
+	if (static_cast<size_t>(cfilelength(cfp)) == sizeof(header) + size
+		&& cfread(&header, sizeof(header), 1, cfp) == 1 && header_matches(header, key, size)
+		&& cfread(data, (int)size, 1, cfp) == 1) {
+		apply_header(header, bmp);
+		valid = true;
+	}
+
+	cfclose(cfp);
+
+	if (!valid) {
+		nprintf(("BmpCache", "Cache file %s does not match its key.\n", filename.c_str()));
+	}
+	return valid;
+}
+
+void bm_cache_write(const bm_cache_key& key, const bitmap* bmp, const void* data, size_t size)
+{
+	if (size > UINT_MAX) {
+		return;
+	}
+
+	auto filename = get_cache_filename(key);
+
+	auto cfp = cf_cache_open_write(filename);
+	if (cfp == nullptr) {
+		return;
+	}
+
+	bm_cache_header header;
+	fill_header(&header, key);
+	header.data_bpp   = bmp->bpp;
+	header.data_flags = bmp->flags;
+	header.data_size  = (uint)size;
+
+	bool success = cfwrite(&header, sizeof(header), 1, cfp) == 1 && cfwrite(data, (int)size, 1, cfp) == 1;
+
+	cf_cache_close_write(cfp, filename, success);
+}
+
+void bm_cache_purge_old()
+{
+	cf_cache_purge_old(BM_CACHE_TYPE);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "bmpman/bmpman.h"
+#include "cfile/cfile.h"
+
+/**
+ * @brief Identifies one decoded image in the texture disk cache
+ *
+ * The key contains a checksum of the source file so a cache entry automatically becomes invalid once the source file
+ * changes. Old entries are removed by bm_cache_purge_old().
+ */
+struct bm_cache_key {
+	uint source_checksum = 0;
+	int source_size      = 0;
+	BM_TYPE type         = BM_TYPE_NONE;
+	int w                = 0;
+	int h                = 0;
+	int bpp              = 0;  //!< The bit depth the data was requested in
+	ushort flags         = 0;  //!< The load flags that influence the decoded data
+	int compression      = 0;  //!< The DDS_* block compression applied to the data, 0 if uncompressed
+};
+
+/**
+ * @brief Checks if the texture disk cache should be used
+ */
+bool bm_cache_enabled();
+
+/**
+ * @brief Builds the cache key for a source image
+ *
+ * @param[out] key   The key to fill in
+ * @param[in] source The opened source file. The read position is not changed.
+ * @param[in] type   The image type of the source file
+ * @param[in] bmp    The bitmap with the dimensions and the requested bit depth
+ * @param[in] flags  The load flags that change the decoded data
+ */
+void bm_cache_make_key(bm_cache_key* key, CFILE* source, BM_TYPE type, const bitmap* bmp, ushort flags);
+
+/**
+ * @brief Reads decoded data from the cache
+ *
+ * @param[in] key    The key of the image
+ * @param[out] bmp   On success, the bpp and flags members are updated
+ * @param[out] data  The buffer which receives the data
+ * @param[in] size   The size of the buffer. The cache entry must have exactly this size.
+ *
+ * @returns true if the data was found in the cache
+ */
+bool bm_cache_read(const bm_cache_key& key, bitmap* bmp, void* data, size_t size);
+
+/**
+ * @brief Stores decoded data in the cache
+ *
+ * @param[in] key   The key of the image
+ * @param[in] bmp   The bitmap whose bpp and flags should be restored on the next read
+ * @param[in] data  The decoded data
+ * @param[in] size  The size of the data
+ */
+void bm_cache_write(const bm_cache_key& key, const bitmap* bmp, const void* data, size_t size);
+
+/**
+ * @brief Removes cache entries which have not been written in a long time
+ */
+void bm_cache_purge_old();
@@ -66,6 +66,7 @@ struct bitmap_entry {
 	// compressed bitmap stuff (.dds) - RT please take a look at this and tell me if we really need it
 	size_t mem_taken;          //!< How much memory does this bitmap use? - UnknownPlayer
 	int num_mipmaps;        //!< number of mipmap levels, we need to read all of them
+	bool data_compressed;   //!< If set, bm.data holds the data of a PNG, JPG or TGA which was block compressed at load time
 
 	// Stuff to keep track of usage
 	ubyte preloaded;        //!< If set, then this was loaded from the lst file
@@ -77,11 +78,20 @@ struct bitmap_entry {
 
 	bm_extra_info info;     //!< Data for animations and user bitmaps
 
+	// residency tracking
+	size_t data_size;       //!< How much system memory the data of this bitmap uses
+	size_t texture_size;    //!< How much texture memory the graphics API reported for this bitmap
+	int   last_used_frame;  //!< The bmpman frame this bitmap was last locked or bound in
+	bool  pinned;           //!< If set, the residency manager will never evict this bitmap
+
+	// mipmap streaming
+	int   stream_skip_levels; //!< Number of the largest mipmap levels which are not loaded yet, 0 if the full data is used
+	bool  stream_requested;   //!< If set, the full data was requested from the background reader
+
 #ifdef BMPMAN_NDEBUG
 	// bookeeping
 	ubyte used_last_frame;  // If set, then it was used last frame
 	ubyte used_this_frame;  // If set, then it was used this frame
-	size_t data_size;        // How much data this bitmap uses
 	int   used_count;       // How many times it was accessed
 #endif
 };
@@ -15,7 +15,9 @@
 
 #include "anim/animplay.h"
 #include "anim/packunpack.h"
+#include "bmpman/bm_cache.h"
 #include "bmpman/bm_internal.h"
+#include "cmdline/cmdline.h"
 #include "ddsutils/ddsutils.h"
 #include "debugconsole/console.h"
 #include "globalincs/systemvars.h"
@@ -32,9 +34,13 @@
 #include "tgautils/tgautils.h"
 #include "tracing/Monitor.h"
 #include "tracing/tracing.h"
+#include "utils/ThreadPool.h"
 
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <climits>
+#include <deque>
 #include <iomanip>
 #include <memory>
 
@@ -55,6 +61,7 @@ MONITOR(SizeBitmapPage)
 int ENVMAP = -1;
 
 size_t bm_texture_ram = 0;
+size_t bm_texture_vram = 0;
 int Bm_paging = 0;
 
 // Extension type lists
@@ -84,13 +91,28 @@ static int Bm_low_mem = 0;
 SCP_map<int,ubyte*> bm_lookup_cache;
 
 /**
- * How much RAM bmpman can use for textures.
+ * How much RAM bmpman can use for bitmap data.
  *
- * @details Set to <1 to make it use all it wants.
+ * @details Set to 0 to make it use all it wants.
  *
  * @note was initialized to 16*1024*1024 at some point to "use only 16MB for textures"
  */
-static int Bm_max_ram = 0;
+static size_t Bm_max_ram = 0;
+
+/**
+ * How much texture memory the graphics API can use before bmpman starts evicting textures. Set to 0 for no limit.
+ */
+static size_t Bm_max_texture_ram = 0;
+
+static int Bm_frame_count = 1;	// 0 is reserved for "never used"
+static int Bm_num_evicted = 0;
+
+/**
+ * Streamed textures keep only the mipmaps up to this size in memory until the full data is requested
+ */
+static const int BM_STREAM_RESIDENT_SIZE = 128;
+
+static int Bm_num_streamed = 0;
 
 static int Bm_ignore_duplicates = 0;
 static int Bm_ignore_load_count = 0;
@@ -237,6 +259,28 @@ static int bm_load_sub_slow(const char *real_filename, const int num_ext, const
  */
 static int bm_load_sub_fast(const char *real_filename, int *handle, int dir_type = CF_TYPE_ANY, bool animated_type = false);
 
+/**
+ * Returns the DDS_* compression that should be applied when loading the image data of a bitmap
+ *
+ * @returns DDS_UNCOMPRESSED if the file should be loaded as it is
+ */
+static int bm_get_load_compression(const bitmap_entry *be, ushort flags);
+
+/**
+ * Loads a PNG, JPG or TGA image which was selected for block compression by bm_select_load_compression()
+ */
+static void bm_lock_compressed(int handle, bitmap_slot *bs, bitmap *bmp, BM_TYPE type, ushort flags);
+
+/**
+ * Replaces the data of streamed textures whose full mipmap chain has finished loading
+ */
+static void bm_stream_update();
+
+/**
+ * Waits for the background reader of streamed textures and frees all data it still holds
+ */
+static void bm_stream_close();
+
 /**
  * @brief Finds a start handle to a block of contiguous bitmap slots
  *
@@ -271,12 +315,16 @@ static void allocate_new_block() {
 		entry.dir_type = CF_TYPE_ANY;
 		entry.info.user.data = nullptr;
 		entry.mem_taken = 0;
+		entry.data_compressed = false;
 		entry.bm.data = 0;
 		entry.bm.palette = nullptr;
 		entry.info.ani.eff.type = BM_TYPE_NONE;
 		entry.info.ani.eff.filename[0] = '\0';
-#ifdef BMPMAN_NDEBUG
 		entry.data_size = 0;
+		entry.texture_size = 0;
+		entry.last_used_frame = 0;
+		entry.pinned = false;
+#ifdef BMPMAN_NDEBUG
 		entry.used_count = 0;
 		entry.used_last_frame = 0;
 		entry.used_this_frame = 0;
@@ -299,7 +347,9 @@ DCF(bm_frag, "Shows BmpMan fragmentation") {
 		dc_printf("\tGray  : NONE\n");
 		dc_printf("\tRed   : PCXn");
 		dc_printf("\tGreen : USER, TGA, PNG, DDS, other\n");
-		dc_printf("\tBlue  : ANI, EFF\n\n");
+		dc_printf("\tBlue  : ANI, EFF\n");
+		dc_printf("\tYellow: Pinned, never evicted\n");
+		dc_printf("Loaded bitmaps which are currently evicted (no data or texture resident) are drawn darker.\n\n");
 
 		dc_printf("Once done reviewing the graphic, press any key to return to the console\n");
 		return;
@@ -313,28 +363,35 @@ DCF(bm_frag, "Shows BmpMan fragmentation") {
 
 	for (auto& block : bm_blocks) {
 		for (size_t i = 0; i < BM_BLOCK_SIZE; ++i) {
-			switch (block[i].entry.type) {
+			auto& entry = block[i].entry;
+			int r, g, b;
+
+			switch (entry.type) {
 			case BM_TYPE_NONE:
-				gr_set_color(128, 128, 128);
+				r = g = b = 128;
 				break;
 			case BM_TYPE_PCX:
-				gr_set_color(255, 0, 0);
-				break;
-			case BM_TYPE_USER:
-			case BM_TYPE_TGA:
-			case BM_TYPE_PNG:
-			case BM_TYPE_DDS:
-				gr_set_color(0, 255, 0);
+				r = 255; g = 0; b = 0;
 				break;
 			case BM_TYPE_ANI:
 			case BM_TYPE_EFF:
-				gr_set_color(0, 0, 255);
+				r = 0; g = 0; b = 255;
 				break;
 			default:
-				gr_set_color(0, 255, 0);
+				r = 0; g = 255; b = 0;
 				break;
 			}
 
+			if (entry.type != BM_TYPE_NONE) {
+				if (entry.pinned) {
+					r = g = 255; b = 0;
+				} else if (entry.data_size == 0 && entry.texture_size == 0) {
+					r /= 3; g /= 3; b /= 3;
+				}
+			}
+
+			gr_set_color(r, g, b);
+
 			gr_rect(x + xs, y + ys, w, h);
 			x += w + xs + xs;
 			if (x > 639) {
@@ -453,6 +510,7 @@ DCF(bmpman, "Shows/changes bitmap caching parameters and usage") {
 		dc_printf("Usage: BmpMan [arg]\nWhere arg can be any of the following:\n");
 		dc_printf("\tflush    Unloads all bitmaps.\n");
 		dc_printf("\tram [x]  Sets max mem usage to x MB. (Set to 0 to have no limit.)\n");
+		dc_printf("\tvram [x] Sets max texture mem usage to x MB before textures get evicted. (Set to 0 to have no limit.)\n");
 		dc_printf("\t?        Displays status of Bitmap manager.\n");
 		return;
 	}
@@ -460,15 +518,44 @@ DCF(bmpman, "Shows/changes bitmap caching parameters and usage") {
 	if (dc_optional_string_either("status", "--status") || dc_optional_string_either("?", "--?")) {
 		dc_printf("Total RAM usage: " SIZE_T_ARG " bytes\n", bm_texture_ram);
 
-		if (Bm_max_ram > 1024 * 1024) {
-			dc_printf("\tMax RAM allowed: %.1f MB\n", i2fl(Bm_max_ram) / (1024.0f*1024.0f));
-		} else if (Bm_max_ram > 1024) {
-			dc_printf("\tMax RAM allowed: %.1f KB\n", i2fl(Bm_max_ram) / (1024.0f));
-		} else if (Bm_max_ram > 0) {
-			dc_printf("\tMax RAM allowed: %d bytes\n", Bm_max_ram);
+		if (Bm_max_ram > 0) {
+			dc_printf("\tMax RAM allowed: %.1f MB\n", (float)Bm_max_ram / (1024.0f*1024.0f));
 		} else {
 			dc_printf("\tNo RAM limit\n");
 		}
+
+		dc_printf("Total texture memory usage: " SIZE_T_ARG " bytes\n", bm_texture_vram);
+
+		if (Bm_max_texture_ram > 0) {
+			dc_printf("\tMax texture memory allowed: %.1f MB\n", (float)Bm_max_texture_ram / (1024.0f*1024.0f));
+		} else {
+			dc_printf("\tNo texture memory limit\n");
+		}
+
+		int resident = 0, evicted = 0, pinned = 0;
+		for (auto& block : bm_blocks) {
+			for (auto& slot : block) {
+				auto& entry = slot.entry;
+
+				if (entry.type == BM_TYPE_NONE) {
+					continue;
+				}
+
+				if (entry.pinned) {
+					pinned++;
+				}
+
+				if (entry.data_size > 0 || entry.texture_size > 0) {
+					resident++;
+				} else {
+					evicted++;
+				}
+			}
+		}
+
+		dc_printf("Bitmaps resident: %d, not resident: %d, pinned: %d\n", resident, evicted, pinned);
+		dc_printf("Bitmaps evicted since startup: %d\n", Bm_num_evicted);
+		dc_printf("Textures streamed in since startup: %d\n", Bm_num_streamed);
 		return;
 	}
 
@@ -484,13 +571,28 @@ DCF(bmpman, "Shows/changes bitmap caching parameters and usage") {
 		}
 		dc_printf("Total RAM after flush: " SIZE_T_ARG " bytes\n", bm_texture_ram);
 	} else if (dc_optional_string("ram")) {
-		dc_stuff_int(&Bm_max_ram);
+		int max_ram;
+		dc_stuff_int(&max_ram);
 
-		if (Bm_max_ram > 0) {
-			dc_printf("BmpMan limited to %i, MB's\n", Bm_max_ram);
-			Bm_max_ram *= 1024 * 1024;
-		} else if (Bm_max_ram == 0) {
+		if (max_ram > 0) {
+			dc_printf("BmpMan limited to %i, MB's\n", max_ram);
+			Bm_max_ram = (size_t)max_ram * 1024 * 1024;
+		} else if (max_ram == 0) {
 			dc_printf("!!BmpMan memory is unlimited!!\n");
+			Bm_max_ram = 0;
+		} else {
+			dc_printf("Illegal value. Must be non-negative.");
+		}
+	} else if (dc_optional_string("vram")) {
+		int max_texture_ram;
+		dc_stuff_int(&max_texture_ram);
+
+		if (max_texture_ram > 0) {
+			dc_printf("BmpMan texture memory limited to %i, MB's\n", max_texture_ram);
+			Bm_max_texture_ram = (size_t)max_texture_ram * 1024 * 1024;
+		} else if (max_texture_ram == 0) {
+			dc_printf("!!BmpMan texture memory is unlimited!!\n");
+			Bm_max_texture_ram = 0;
 		} else {
 			dc_printf("Illegal value. Must be non-negative.");
 		}
@@ -512,6 +614,8 @@ DCF(bmpslots, "Writes bitmap slot info to fs2_open.log") {
 // Definition of all functions, in alphabetical order
 void bm_close() {
 	if (bm_inited) {
+		bm_stream_close();
+
 		for (auto& block : bm_blocks) {
 			for (auto& slot : block) {
 				bm_free_data(&slot);            // clears flags, bbp, data, etc
@@ -614,6 +718,139 @@ void bm_convert_format(bitmap *bmp, ushort flags) {
 	}
 }
 
+namespace {
+struct bm_eviction_candidate {
+	int first_handle;
+	int num_frames;
+	int last_used_frame;
+	size_t ram;
+	size_t texture_ram;
+};
+
+bool bm_over_ram_budget() { return Bm_max_ram > 0 && bm_texture_ram > Bm_max_ram; }
+
+bool bm_over_texture_budget() { return Bm_max_texture_ram > 0 && bm_texture_vram > Bm_max_texture_ram; }
+
+/**
+ * Collects every bitmap (or animation) that currently occupies memory and may be evicted
+ */
+void bm_get_eviction_candidates(SCP_vector<bm_eviction_candidate>& candidates)
+{
+	for (auto& block : bm_blocks) {
+		for (auto& slot : block) {
+			auto& entry = slot.entry;
+
+			switch (entry.type) {
+			case BM_TYPE_NONE:
+			case BM_TYPE_USER:
+			case BM_TYPE_RENDER_TARGET_STATIC:
+			case BM_TYPE_RENDER_TARGET_DYNAMIC:
+				continue;
+			default:
+				break;
+			}
+
+			// Animations are only evicted as a whole so they are handled by their first frame
+			int num_frames = 1;
+			if (bm_is_anim(&entry)) {
+				if (entry.handle != entry.info.ani.first_frame) {
+					continue;
+				}
+				num_frames = entry.info.ani.num_frames;
+			}
+
+			bm_eviction_candidate candidate{entry.handle, num_frames, 0, 0, 0};
+			bool evictable = true;
+
+			for (int i = 0; i < num_frames; ++i) {
+				auto frame_entry = bm_get_entry(entry.handle + i);
+
+				if (frame_entry->ref_count > 0 || frame_entry->pinned) {
+					evictable = false;
+					break;
+				}
+
+				candidate.last_used_frame = std::max(candidate.last_used_frame, frame_entry->last_used_frame);
+				candidate.ram += frame_entry->data_size;
+				candidate.texture_ram += frame_entry->texture_size;
+			}
+
+			if (!evictable || candidate.last_used_frame >= Bm_frame_count) {
+				continue;
+			}
+
+			if (candidate.ram == 0 && candidate.texture_ram == 0) {
+				// Nothing resident
+				continue;
+			}
+
+			candidates.push_back(candidate);
+		}
+	}
+}
+}
+
+static void bm_evict_unused()
+{
+
+	SCP_vector<bm_eviction_candidate> candidates;
+	bm_get_eviction_candidates(candidates);
+
+	std::sort(candidates.begin(), candidates.end(), [](const bm_eviction_candidate& left, const bm_eviction_candidate& right) {
+		if (left.last_used_frame != right.last_used_frame) {
+			return left.last_used_frame < right.last_used_frame;
+		}
+		return left.first_handle < right.first_handle;
+	});
+
+	int num_evicted = 0;
+	size_t ram_before = bm_texture_ram;
+	size_t texture_ram_before = bm_texture_vram;
+
+	for (auto& candidate : candidates) {
+		bool free_ram = bm_over_ram_budget() && candidate.ram > 0;
+		bool free_texture = bm_over_texture_budget() && candidate.texture_ram > 0;
+
+		if (!free_ram && !free_texture) {
+			if (!bm_over_ram_budget() && !bm_over_texture_budget()) {
+				break;
+			}
+			continue;
+		}
+
+		for (int i = 0; i < candidate.num_frames; ++i) {
+			if (free_texture) {
+				gr_bm_free_data(bm_get_slot(candidate.first_handle + i), true);
+			}
+			bm_free_data_fast(candidate.first_handle + i);
+		}
+
+		++num_evicted;
+	}
+
+	if (num_evicted > 0) {
+		Bm_num_evicted += num_evicted;
+
+		nprintf(("BmpMan", "Evicted %d bitmaps, RAM " SIZE_T_ARG " -> " SIZE_T_ARG ", texture memory " SIZE_T_ARG " -> " SIZE_T_ARG "\n",
+			num_evicted, ram_before, bm_texture_ram, texture_ram_before, bm_texture_vram));
+	}
+}
+
+void bm_end_frame()
+{
+	bm_stream_update();
+
+	// Level loading touches a lot of bitmaps without drawing them so the usage information is meaningless until the
+	// level actually runs
+	if (!Bm_paging && (bm_over_ram_budget() || bm_over_texture_budget())) {
+		// The bitmaps used in the frame which is ending still carry the current frame number so they are kept
+		bm_evict_unused();
+	}
+
+	// Everything that is used from now on is newer than anything before it
+	++Bm_frame_count;
+}
+
 void bm_free_data(bitmap_slot* bs, bool release)
 {
 	bitmap *bmp;
@@ -631,27 +868,21 @@ void bm_free_data(bitmap_slot* bs, bool release)
 	// Don't free up memory for user defined bitmaps, since
 	// BmpMan isn't the one in charge of allocating/deallocing them.
 	if (be->type==BM_TYPE_USER) {
-#ifdef BMPMAN_NDEBUG
 		if ( be->data_size != 0 )
 			bm_texture_ram -= be->data_size;
-#endif
 		goto SkipFree;
 	}
 
 	// If this bitmap doesn't have any data to free, skip
 	// the freeing it part of this.
 	if (bmp->data == 0) {
-#ifdef BMPMAN_NDEBUG
 		if ( be->data_size != 0 )
 			bm_texture_ram -= be->data_size;
-#endif
 		goto SkipFree;
 	}
 
 	// Free up the data now!
-#ifdef BMPMAN_NDEBUG
 	bm_texture_ram -= be->data_size;
-#endif
 	vm_free((void *)bmp->data);
 
 	// reset the load_count to at least 1, don't do this in SkipFree though
@@ -665,9 +896,8 @@ SkipFree:
 	bmp->bpp = 0;
 	bmp->data = 0;
 	bmp->palette = NULL;
-#ifdef BMPMAN_NDEBUG
 	be->data_size = 0;
-#endif
+	be->data_compressed = false;
 	be->signature = Bm_next_signature++;
 }
 
@@ -687,30 +917,25 @@ void bm_free_data_fast(int handle)
 	// Don't free up memory for user defined bitmaps, since
 	// BmpMan isn't the one in charge of allocating/deallocing them.
 	if (be->type == BM_TYPE_USER) {
-#ifdef BMPMAN_NDEBUG
 		if ( be->data_size != 0 )
 			bm_texture_ram -= be->data_size;
-#endif
 		return;
 	}
 
 	// If this bitmap doesn't have any data to free, skip
 	// the freeing it part of this.
 	if (bmp->data == 0) {
-#ifdef BMPMAN_NDEBUG
 		if ( be->data_size != 0 ) {
 			bm_texture_ram -= be->data_size;
 			be->data_size = 0;
 		}
-#endif
 		return;
 	}
 
 	// Free up the data now!
-#ifdef BMPMAN_NDEBUG
 	bm_texture_ram -= be->data_size;
 	be->data_size = 0;
-#endif
+	be->data_compressed = false;
 	vm_free((void *)bmp->data);
 	bmp->data = 0;
 }
@@ -894,6 +1119,10 @@ int bm_get_info(int handle, int *w, int * h, ushort* flags, int *nframes, int *f
 	}
 }
 
+int bm_get_stream_skip_levels(int handle) {
+	return bm_get_entry(handle)->stream_skip_levels;
+}
+
 int bm_get_num_mipmaps(int num) {
 	auto entry = bm_get_entry(num);
 
@@ -947,6 +1176,12 @@ void bm_init() {
 	// Allocate one block by default
 	allocate_new_block();
 
+	bm_set_memory_budget((size_t)Cmdline_bitmap_ram_budget * 1024 * 1024, (size_t)Cmdline_texture_budget * 1024 * 1024);
+
+	if (bm_cache_enabled()) {
+		bm_cache_purge_old();
+	}
+
 	bm_inited = true;
 }
 
@@ -1335,6 +1570,15 @@ static int bm_load_image_data(int handle, int bpp, ushort flags, bool nodebug)
 	else
 		true_bpp = bpp;
 
+	// images which are block compressed at load time are only handed out compressed to the locks asking for it
+	bool load_compressed = bm_get_load_compression(be, flags) != DDS_UNCOMPRESSED;
+
+	// data in the other format has to be read again, bm_lock() already refused this if somebody else has it locked
+	if ((bmp->data != 0) && (be->data_compressed != load_compressed)) {
+		Assert(be->ref_count == 1);
+		bm_free_data_fast(handle);
+	}
+
 	// don't do a bpp check here since it could be different in OGL - taylor
 	if (bmp->data == 0) {
 		Assert(be->ref_count == 1);
@@ -1376,7 +1620,11 @@ static int bm_load_image_data(int handle, int bpp, ushort flags, bool nodebug)
 			break;
 
 		case BM_TYPE_TGA:
-			bm_lock_tga(handle, bs, bmp, true_bpp, flags);
+			if (load_compressed) {
+				bm_lock_compressed(handle, bs, bmp, c_type, flags);
+			} else {
+				bm_lock_tga(handle, bs, bmp, true_bpp, flags);
+			}
 			break;
 
 		case BM_TYPE_PNG:
@@ -1384,13 +1632,20 @@ static int bm_load_image_data(int handle, int bpp, ushort flags, bool nodebug)
 			if (be->info.ani.apng.is_apng == true) {
 				bm_lock_apng( handle, bs, bmp, true_bpp, flags );
 			}
+			else if (load_compressed) {
+				bm_lock_compressed(handle, bs, bmp, c_type, flags);
+			}
 			else {
 				bm_lock_png( handle, bs, bmp, true_bpp, flags );
 			}
 			break;
 
 		case BM_TYPE_JPG:
-			bm_lock_jpg(handle, bs, bmp, true_bpp, flags);
+			if (load_compressed) {
+				bm_lock_compressed(handle, bs, bmp, c_type, flags);
+			} else {
+				bm_lock_jpg(handle, bs, bmp, true_bpp, flags);
+			}
 			break;
 
 		case BM_TYPE_DDS:
@@ -1905,12 +2160,23 @@ bitmap * bm_lock(int handle, int bpp, ushort flags, bool nodebug) {
 	// as it gets read in
 
 	// Mark this bitmap as used this frame
+	be->last_used_frame = Bm_frame_count;
 #ifdef BMPMAN_NDEBUG
 	if (be->used_this_frame < 255) {
 		be->used_this_frame++;
 	}
 #endif
 
+	// the data of an image which is block compressed at load time can only be exchanged for the other format if
+	// nobody else is using it right now
+	if ((be->bm.data != 0) && (be->ref_count > 1)
+		&& (be->data_compressed != (bm_get_load_compression(be, flags) != DDS_UNCOMPRESSED))) {
+		mprintf(("Bitmap %s is already locked in a different format!\n", be->filename));
+		bm_unlock(handle);
+
+		return NULL;
+	}
+
 	// read the file data
 	if (bm_load_image_data(handle, bpp, flags, nodebug) == -1) {
 		// oops, this isn't good - reset and return NULL
@@ -2148,18 +2414,24 @@ void bm_lock_dds(int handle, bitmap_slot *bs, bitmap *bmp, int /*bpp*/, ushort /
 	Assert(be->mem_taken > 0);
 	Assert(&be->bm == bmp);
 
-	data = (ubyte*)bm_malloc(handle, be->mem_taken);
+	// streamed textures only load the smaller mipmaps until the full data was requested
+	size_t data_size = be->mem_taken;
+	if (be->stream_skip_levels > 0) {
+		data_size -= dds_compressed_size(bmp->w, bmp->h, be->stream_skip_levels, bm_is_compressed(handle));
+	}
+
+	data = (ubyte*)bm_malloc(handle, data_size);
 
 	if (data == NULL)
 		return;
 
-	memset(data, 0, be->mem_taken);
+	memset(data, 0, data_size);
 
 	// make sure we are using the correct filename in the case of an EFF.
 	// this will populate filename[] whether it's EFF or not
 	EFF_FILENAME_CHECK;
 
-	error = dds_read_bitmap(filename, data, &dds_bpp, be->dir_type);
+	error = dds_read_bitmap(filename, data, &dds_bpp, be->dir_type, be->stream_skip_levels);
 
 #if BYTE_ORDER == BIG_ENDIAN
 	// same as with TGA, we need to byte swap 16 & 32-bit, uncompressed, DDS images
@@ -2198,73 +2470,326 @@ void bm_lock_dds(int handle, bitmap_slot *bs, bitmap *bmp, int /*bpp*/, ushort /
 #endif
 }
 
-void bm_lock_jpg(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort /*flags*/) {
-	ubyte *data = NULL;
-	int d_size = 0;
-	int jpg_error = JPEG_ERROR_INVALID;
-	char filename[MAX_FILENAME_LEN];
+/**
+ * Opens the image file of a bitmap using the extension of the given type
+ */
+static CFILE* bm_open_image_file(const char* filename, BM_TYPE type, int dir_type)
+{
+	char open_name[MAX_FILENAME_LEN];
+	strcpy_s(open_name, filename);
+	auto p = strchr(open_name, '.');
+	if (p) {
+		*p = '\0';
+	}
+	for (int i = 0; i < BM_NUM_TYPES; ++i) {
+		if (bm_type_list[i] == type) {
+			strcat_s(open_name, bm_ext_list[i]);
+			break;
+		}
+	}
 
-	auto be = &bs->entry;
+	return cfopen(open_name, "rb", CFILE_NORMAL, dir_type);
+}
 
-	// Unload any existing data
-	bm_free_data(bs);
+/**
+ * The load flags which change the decoded data of the given image type
+ */
+static ushort bm_cache_flags(BM_TYPE type, ushort flags)
+{
+	// Only targa data is passed through bm_convert_format()
+	return (type == BM_TYPE_TGA) ? (flags & (BMP_AABITMAP | BMP_TEX_XPARENT)) : 0;
+}
 
-	// JPEG actually only support 24 bits per pixel so we enforce that here
-	bpp = 24;
+/**
+ * Tries to load the decoded data of a bitmap from the disk cache
+ *
+ * @param[out] img_cfp If the data was not cached this is set to the opened image file which should be passed to the
+ *   image reader and then to bm_cache_finish(). It is nullptr if the cache is disabled.
+ *
+ * @returns true if the data was read from the cache
+ */
+static bool bm_cache_lookup(const char* filename, BM_TYPE type, int dir_type, bitmap* bmp, ushort flags, size_t size,
+                            bm_cache_key* key, CFILE** img_cfp)
+{
+	*img_cfp = nullptr;
 
-	d_size = (bpp >> 3);
+	if (!bm_cache_enabled()) {
+		return false;
+	}
 
-	// allocate bitmap data
-	Assert(be->mem_taken > 0);
-	data = (ubyte*)bm_malloc(handle, be->mem_taken);
+	*img_cfp = bm_open_image_file(filename, type, dir_type);
+	if (*img_cfp == nullptr) {
+		// Let the image reader report the error
+		return false;
+	}
 
-	if (data == NULL)
-		return;
+	bm_cache_make_key(key, *img_cfp, type, bmp, bm_cache_flags(type, flags));
 
-	memset(data, 0, be->mem_taken);
+	if (bm_cache_read(*key, bmp, reinterpret_cast<void*>(bmp->data), size)) {
+		cfclose(*img_cfp);
+		*img_cfp = nullptr;
+		return true;
+	}
 
-	bmp->bpp = bpp;
-	bmp->data = (ptr_u)data;
-	bmp->palette = NULL;
+	return false;
+}
 
-	Assert(&be->bm == bmp);
+/**
+ * Stores the decoded data in the disk cache if bm_cache_lookup() missed and closes the image file
+ */
+static void bm_cache_finish(CFILE* img_cfp, const bm_cache_key& key, const bitmap* bmp, size_t size, bool success)
+{
+	if (img_cfp == nullptr) {
+		return;
+	}
 
-	// make sure we are using the correct filename in the case of an EFF.
-	// this will populate filename[] whether it's EFF or not
-	EFF_FILENAME_CHECK;
+	if (success) {
+		bm_cache_write(key, bmp, reinterpret_cast<const void*>(bmp->data), size);
+	}
+
+	cfclose(img_cfp);
+}
 
-	jpg_error = jpeg_read_bitmap(filename, data, NULL, d_size, be->dir_type);
+static int bm_get_load_compression(const bitmap_entry *be, ushort flags)
+{
+	BM_TYPE type = (be->type == BM_TYPE_EFF) ? be->info.ani.eff.type : be->type;
 
-	if (jpg_error != JPEG_ERROR_NONE) {
-		bm_free_data(bs);
-		return;
+	if ((type != BM_TYPE_PNG) && (type != BM_TYPE_JPG) && (type != BM_TYPE_TGA)) {
+		return DDS_UNCOMPRESSED;
 	}
 
-#ifdef BMPMAN_NDEBUG
-	Assert(be->data_size > 0);
-#endif
+	// everybody else gets the plain pixels of the image file, the same as before it was selected for compression
+	switch (be->comp_type) {
+	case BM_TYPE_DXT1:
+		return (flags & BMP_TEX_DXT1) ? DDS_DXT1 : DDS_UNCOMPRESSED;
+	case BM_TYPE_DXT5:
+		return (flags & BMP_TEX_DXT5) ? DDS_DXT5 : DDS_UNCOMPRESSED;
+	default:
+		return DDS_UNCOMPRESSED;
+	}
 }
 
-void bm_lock_pcx(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags) {
-	ubyte *data;
-	int pcx_error;
-	char filename[MAX_FILENAME_LEN];
+/**
+ * Decodes an image file into bmp->data which must be large enough for bmp->bpp
+ *
+ * This does not touch any bmpman state so it may be called from a worker thread.
+ */
+static bool bm_decode_image(BM_TYPE type, const char *filename, CFILE *img_cfp, bitmap *bmp, ushort flags)
+{
+	auto data = reinterpret_cast<ubyte*>(bmp->data);
 
-	auto be = &bs->entry;
+	switch (type) {
+	case BM_TYPE_PNG: {
+		int bpp = 32;
+		if (png_read_bitmap(filename, data, &bpp, 4, CF_TYPE_ANY, img_cfp) != PNG_ERROR_NONE) {
+			return false;
+		}
+		bmp->bpp = (ubyte)bpp;
+		return true;
+	}
 
-	// Unload any existing data
-	bm_free_data(bs);
+	case BM_TYPE_JPG:
+		return jpeg_read_bitmap(filename, data, nullptr, 3, CF_TYPE_ANY, img_cfp) == JPEG_ERROR_NONE;
 
-	be->mem_taken = (bmp->w * bmp->h * (bpp >> 3));
-	data = (ubyte *)bm_malloc(handle, be->mem_taken);
-	bmp->bpp = bpp;
-	bmp->data = (ptr_u)data;
-	bmp->palette = NULL;
-	memset(data, 0, be->mem_taken);
+	case BM_TYPE_TGA:
+		if (targa_read_bitmap(filename, data, nullptr, bmp->bpp >> 3, CF_TYPE_ANY, img_cfp) != TARGA_ERROR_NONE) {
+			return false;
+		}
+		bm_convert_format(bmp, flags);
+		return true;
 
-	Assert(&be->bm == bmp);
-#ifdef BMPMAN_NDEBUG
-	Assert(be->data_size > 0);
+	default:
+		return false;
+	}
+}
+
+/**
+ * Decodes an image file and block compresses it, including all mipmap levels, into dest
+ *
+ * This does not touch any bmpman state so it may be called from a worker thread.
+ */
+static bool bm_decode_and_compress(BM_TYPE type, const char *filename, CFILE *img_cfp, int w, int h, int true_bpp,
+                                   int compression, int levels, ubyte *dest)
+{
+	bitmap raw;
+	memset(&raw, 0, sizeof(raw));
+	raw.w = (short)w;
+	raw.h = (short)h;
+	raw.rowsize = (short)w;
+	raw.true_bpp = (ubyte)true_bpp;
+
+	// These need to match what the bm_lock_* functions allocate
+	switch (type) {
+	case BM_TYPE_PNG:
+		raw.bpp = 32;
+		break;
+	case BM_TYPE_JPG:
+		raw.bpp = 24;
+		break;
+	default:
+		raw.bpp = (ubyte)true_bpp;
+		break;
+	}
+
+	SCP_vector<ubyte> buffer((size_t)w * h * (raw.bpp >> 3));
+	raw.data = (ptr_u)buffer.data();
+
+	if (!bm_decode_image(type, filename, img_cfp, &raw, 0)) {
+		return false;
+	}
+
+	if ((raw.bpp != 24) && (raw.bpp != 32)) {
+		return false;
+	}
+
+	dds_compress_image(buffer.data(), w, h, raw.bpp, levels, compression, dest);
+	return true;
+}
+
+static void bm_lock_compressed(int handle, bitmap_slot *bs, bitmap *bmp, BM_TYPE type, ushort flags)
+{
+	char filename[MAX_FILENAME_LEN];
+
+	auto be = &bs->entry;
+	int compression = bm_get_load_compression(be, flags);
+
+	// free any existing data
+	bm_free_data(bs);
+
+	Assert(be->mem_taken > 0);
+	Assert(&be->bm == bmp);
+
+	auto data = (ubyte*)bm_malloc(handle, be->mem_taken);
+
+	if (data == NULL)
+		return;
+
+	memset(data, 0, be->mem_taken);
+
+	// make sure we are using the correct filename in the case of an EFF.
+	// this will populate filename[] whether it's EFF or not
+	EFF_FILENAME_CHECK;
+
+	bmp->bpp = (compression == DDS_DXT1) ? 24 : 32;
+	bmp->data = (ptr_u)data;
+	bmp->flags = 0;
+	be->data_compressed = true;
+
+	bm_cache_key key;
+	CFILE* img_cfp = nullptr;
+
+	if (bm_cache_enabled()) {
+		img_cfp = bm_open_image_file(filename, type, be->dir_type);
+
+		if (img_cfp != nullptr) {
+			bm_cache_make_key(&key, img_cfp, type, bmp, 0);
+			key.compression = compression;
+
+			if (bm_cache_read(key, bmp, data, be->mem_taken)) {
+				cfclose(img_cfp);
+				return;
+			}
+		}
+	}
+
+	bool success = bm_decode_and_compress(type, filename, img_cfp, bmp->w, bmp->h, bmp->true_bpp, compression,
+	                                      be->num_mipmaps, data);
+
+	if (img_cfp != nullptr) {
+		if (success) {
+			bm_cache_write(key, bmp, data, be->mem_taken);
+		}
+		cfclose(img_cfp);
+	}
+
+	if (!success) {
+		bm_free_data(bs);
+		return;
+	}
+
+#ifdef BMPMAN_NDEBUG
+	Assert(be->data_size > 0);
+#endif
+}
+
+void bm_lock_jpg(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort /*flags*/) {
+	ubyte *data = NULL;
+	int d_size = 0;
+	int jpg_error = JPEG_ERROR_INVALID;
+	char filename[MAX_FILENAME_LEN];
+
+	auto be = &bs->entry;
+
+	// Unload any existing data
+	bm_free_data(bs);
+
+	// JPEG actually only support 24 bits per pixel so we enforce that here
+	bpp = 24;
+
+	d_size = (bpp >> 3);
+
+	// mem_taken is the compressed size if the image was selected for compression at load time
+	size_t size = static_cast<size_t>(bmp->w) * bmp->h * d_size;
+
+	// allocate bitmap data
+	Assert(size > 0);
+	data = (ubyte*)bm_malloc(handle, size);
+
+	if (data == NULL)
+		return;
+
+	memset(data, 0, size);
+
+	bmp->bpp = bpp;
+	bmp->data = (ptr_u)data;
+	bmp->palette = NULL;
+
+	Assert(&be->bm == bmp);
+
+	// make sure we are using the correct filename in the case of an EFF.
+	// this will populate filename[] whether it's EFF or not
+	EFF_FILENAME_CHECK;
+
+	bm_cache_key cache_key;
+	CFILE* img_cfp;
+	if (bm_cache_lookup(filename, BM_TYPE_JPG, be->dir_type, bmp, 0, size, &cache_key, &img_cfp)) {
+		return;
+	}
+
+	jpg_error = jpeg_read_bitmap(filename, data, NULL, d_size, be->dir_type, img_cfp);
+
+	bm_cache_finish(img_cfp, cache_key, bmp, size, jpg_error == JPEG_ERROR_NONE);
+
+	if (jpg_error != JPEG_ERROR_NONE) {
+		bm_free_data(bs);
+		return;
+	}
+
+#ifdef BMPMAN_NDEBUG
+	Assert(be->data_size > 0);
+#endif
+}
+
+void bm_lock_pcx(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags) {
+	ubyte *data;
+	int pcx_error;
+	char filename[MAX_FILENAME_LEN];
+
+	auto be = &bs->entry;
+
+	// Unload any existing data
+	bm_free_data(bs);
+
+	be->mem_taken = (bmp->w * bmp->h * (bpp >> 3));
+	data = (ubyte *)bm_malloc(handle, be->mem_taken);
+	bmp->bpp = bpp;
+	bmp->data = (ptr_u)data;
+	bmp->palette = NULL;
+	memset(data, 0, be->mem_taken);
+
+	Assert(&be->bm == bmp);
+#ifdef BMPMAN_NDEBUG
+	Assert(be->data_size > 0);
 #endif
 
 	// some sanity checks on flags
@@ -2322,8 +2847,18 @@ void bm_lock_png(int handle, bitmap_slot *bs, bitmap *bmp, int /*bpp*/, ushort /
 	// this will populate filename[] whether it's EFF or not
 	EFF_FILENAME_CHECK;
 
+	size_t size = static_cast<size_t>(bmp->w * bmp->h * d_size);
+
+	bm_cache_key cache_key;
+	CFILE* img_cfp;
+	if (bm_cache_lookup(filename, BM_TYPE_PNG, be->dir_type, bmp, 0, size, &cache_key, &img_cfp)) {
+		return;
+	}
+
 	//bmp->bpp gets set correctly in here after reading into memory
-	png_error = png_read_bitmap(filename, data, &bmp->bpp, d_size, be->dir_type);
+	png_error = png_read_bitmap(filename, data, &bmp->bpp, d_size, be->dir_type, img_cfp);
+
+	bm_cache_finish(img_cfp, cache_key, bmp, size, png_error == PNG_ERROR_NONE);
 
 	if (png_error != PNG_ERROR_NONE) {
 		bm_free_data(bs);
@@ -2362,7 +2897,7 @@ void bm_lock_tga(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags
 	data = (ubyte*)bm_malloc(handle, static_cast<size_t>(bmp->w * bmp->h * byte_size));
 
 	if (data) {
-		memset(data, 0, be->mem_taken);
+		memset(data, 0, static_cast<size_t>(bmp->w * bmp->h * byte_size));
 	} else {
 		return;
 	}
@@ -2382,9 +2917,18 @@ void bm_lock_tga(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags
 	// this will populate filename[] whether it's EFF or not
 	EFF_FILENAME_CHECK;
 
-	tga_error = targa_read_bitmap(filename, data, nullptr, byte_size, be->dir_type);
+	size_t size = static_cast<size_t>(bmp->w * bmp->h * byte_size);
+
+	bm_cache_key cache_key;
+	CFILE* img_cfp;
+	if (bm_cache_lookup(filename, BM_TYPE_TGA, be->dir_type, bmp, flags, size, &cache_key, &img_cfp)) {
+		return;
+	}
+
+	tga_error = targa_read_bitmap(filename, data, nullptr, byte_size, be->dir_type, img_cfp);
 
 	if (tga_error != TARGA_ERROR_NONE) {
+		bm_cache_finish(img_cfp, cache_key, bmp, size, false);
 		bm_free_data(bs);
 		return;
 	}
@@ -2392,6 +2936,8 @@ void bm_lock_tga(int handle, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags
 	bmp->flags = 0;
 
 	bm_convert_format(bmp, flags);
+
+	bm_cache_finish(img_cfp, cache_key, bmp, size, true);
 }
 
 void bm_lock_user(int /*handle*/, bitmap_slot *bs, bitmap *bmp, int bpp, ushort flags) {
@@ -2505,16 +3051,18 @@ void *bm_malloc(int n, size_t size) {
 	if (size == 0)
 		return nullptr;
 
-#ifdef BMPMAN_NDEBUG
 	auto entry = bm_get_entry(n);
 	Assert(entry->data_size == 0);
 	entry->data_size += size;
 	bm_texture_ram += size;
-#endif
 
 	return vm_malloc(size);
 }
 
+void bm_mark_used(int handle) {
+	bm_get_entry(handle)->last_used_frame = Bm_frame_count;
+}
+
 void bm_page_in_aabitmap(int handle, int nframes) {
 	int i;
 
@@ -2552,6 +3100,348 @@ void bm_page_in_start() {
 	gr_bm_page_in_start();
 }
 
+namespace {
+
+/**
+ * @brief Decodes the bitmaps of the level on worker threads while bm_page_in_stop() uploads them
+ *
+ * Files are opened and closed on the main thread since cfile can not do that concurrently. Reading the file contents,
+ * decoding the image and converting the format happens on the workers. The decoded data is handed over to the bitmap
+ * slot on the main thread right before the bitmap is needed so the normal bm_lock() path finds it already loaded.
+ */
+class bm_page_in_pipeline {
+	struct decode_job {
+		int handle = -1;
+		BM_TYPE type = BM_TYPE_NONE;
+		char filename[MAX_FILENAME_LEN];
+		CFILE* cfp = nullptr;
+		ushort flags = 0;
+		size_t size = 0;
+		bitmap bm;
+
+		int compression = DDS_UNCOMPRESSED;
+		int levels = 0;
+
+		bool write_cache = false;
+		bm_cache_key cache_key;
+		ushort cache_flags = 0;
+
+		// Valid while the cache key is computed on a worker, the cache is checked on the main thread afterwards
+		std::future<void> keyed;
+		std::future<bool> done;
+	};
+
+	util::ThreadPool m_pool;
+	size_t m_max_in_flight;
+
+	SCP_vector<int> m_candidates;
+	size_t m_next_candidate = 0;
+
+	std::deque<std::unique_ptr<decode_job>> m_jobs;
+	SCP_vector<int> m_committed;
+
+	static BM_TYPE get_decode_type(const bitmap_entry& entry);
+	static void make_cache_key(decode_job* job);
+	static bool decode(decode_job* job);
+
+	void submit(int handle);
+	void lookup_cache(decode_job* job);
+	void fill();
+	void complete(decode_job* job);
+
+  public:
+	explicit bm_page_in_pipeline(int num_threads);
+	~bm_page_in_pipeline();
+
+	bm_page_in_pipeline(const bm_page_in_pipeline&) = delete;
+	bm_page_in_pipeline& operator=(const bm_page_in_pipeline&) = delete;
+
+	/**
+	 * @brief Queues all bitmaps of the level that can be decoded on a worker thread
+	 *
+	 * Must be called with the same iteration order bm_page_in_stop() uses.
+	 */
+	void add_candidates();
+
+	/**
+	 * @brief Waits until every bitmap up to and including last_handle has been decoded and hands the data to bmpman
+	 */
+	void finish_through(int last_handle);
+
+	/**
+	 * @brief Frees decoded data in the specified range that was not consumed by the texture upload
+	 *
+	 * This happens if the texture was already resident. Without this the data would stay in system memory.
+	 */
+	void release_unused(int first_handle, int last_handle);
+};
+
+bm_page_in_pipeline::bm_page_in_pipeline(int num_threads) : m_pool(num_threads)
+{
+	// Every job keeps a cfile block open so this must stay well below MAX_CFILE_BLOCKS
+	m_max_in_flight = std::min(m_pool.size() * 2, (size_t)16);
+}
+
+bm_page_in_pipeline::~bm_page_in_pipeline()
+{
+	// Make sure that no worker still writes to our buffers and that all files are closed
+	m_candidates.clear();
+	finish_through(INT_MAX);
+}
+
+BM_TYPE bm_page_in_pipeline::get_decode_type(const bitmap_entry& entry)
+{
+	// the standalone server and AA bitmaps use special formats which are not worth the effort
+	if (Is_standalone || (entry.used_flags & BMP_AABITMAP)) {
+		return BM_TYPE_NONE;
+	}
+
+	if (entry.bm.data != 0) {
+		return BM_TYPE_NONE;
+	}
+
+	switch (entry.type) {
+	case BM_TYPE_EFF:
+		if (entry.info.ani.eff.type == BM_TYPE_PNG || entry.info.ani.eff.type == BM_TYPE_JPG
+			|| entry.info.ani.eff.type == BM_TYPE_TGA) {
+			return entry.info.ani.eff.type;
+		}
+		return BM_TYPE_NONE;
+
+	case BM_TYPE_PNG:
+		return entry.info.ani.apng.is_apng ? BM_TYPE_NONE : BM_TYPE_PNG;
+
+	case BM_TYPE_JPG:
+	case BM_TYPE_TGA:
+		return entry.type;
+
+	default:
+		return BM_TYPE_NONE;
+	}
+}
+
+void bm_page_in_pipeline::make_cache_key(decode_job* job)
+{
+	// NOTE: This is executed on a worker thread! Only the job may be accessed here.
+	// The checksum reads the whole source file which is too slow for the main thread.
+	bm_cache_make_key(&job->cache_key, job->cfp, job->type, &job->bm, job->cache_flags);
+	job->cache_key.compression = job->compression;
+}
+
+bool bm_page_in_pipeline::decode(decode_job* job)
+{
+	// NOTE: This is executed on a worker thread! Only the job may be accessed here.
+	auto bmp = &job->bm;
+
+	if (job->compression != DDS_UNCOMPRESSED) {
+		return bm_decode_and_compress(job->type, job->filename, job->cfp, bmp->w, bmp->h, bmp->true_bpp,
+		                              job->compression, job->levels, reinterpret_cast<ubyte*>(bmp->data));
+	}
+
+	return bm_decode_image(job->type, job->filename, job->cfp, bmp, job->flags);
+}
+
+void bm_page_in_pipeline::submit(int handle)
+{
+	auto& entry = bm_get_slot(handle)->entry;
+
+	auto type = get_decode_type(entry);
+	if (type == BM_TYPE_NONE) {
+		return;
+	}
+
+	std::unique_ptr<decode_job> job(new decode_job());
+	job->handle = handle;
+	job->type = type;
+	job->flags = entry.used_flags;
+	job->bm = entry.bm;
+	job->bm.flags = 0;
+	job->bm.palette = nullptr;
+
+	job->compression = bm_get_load_compression(&entry, entry.used_flags);
+	job->levels = entry.num_mipmaps;
+
+	// These need to match what the bm_lock_* functions allocate
+	switch (type) {
+	case BM_TYPE_PNG:
+		job->bm.bpp = 32;
+		break;
+	case BM_TYPE_JPG:
+		job->bm.bpp = 24;
+		break;
+	case BM_TYPE_TGA:
+		job->bm.bpp = entry.bm.true_bpp;
+		if ((job->bm.bpp != 16) && (job->bm.bpp != 24) && (job->bm.bpp != 32)) {
+			return;
+		}
+		break;
+	default:
+		return;
+	}
+
+	if (job->compression != DDS_UNCOMPRESSED) {
+		// bm_lock_compressed() stores the whole mipmap chain
+		job->bm.bpp = (job->compression == DDS_DXT1) ? 24 : 32;
+		job->size = entry.mem_taken;
+	} else {
+		job->size = static_cast<size_t>(entry.bm.w) * entry.bm.h * (job->bm.bpp >> 3);
+	}
+
+	if (job->size == 0) {
+		return;
+	}
+
+	// make sure we are using the correct filename in the case of an EFF.
+	if (entry.type == BM_TYPE_EFF) {
+		strcpy_s(job->filename, entry.info.ani.eff.filename);
+	} else {
+		strcpy_s(job->filename, entry.filename);
+	}
+
+	job->cfp = bm_open_image_file(job->filename, type, entry.dir_type);
+	if (job->cfp == nullptr) {
+		// Let the normal loading code deal with reporting the error
+		return;
+	}
+
+	auto data = vm_malloc(job->size);
+	memset(data, 0, job->size);
+	job->bm.data = (ptr_u)data;
+
+	auto job_ptr = job.get();
+
+	if (bm_cache_enabled()) {
+		job->cache_flags = (job->compression != DDS_UNCOMPRESSED) ? 0 : bm_cache_flags(type, job->flags);
+		job->keyed = m_pool.submit([job_ptr]() { make_cache_key(job_ptr); });
+	} else {
+		job->done = m_pool.submit([job_ptr]() { return decode(job_ptr); });
+	}
+
+	m_jobs.push_back(std::move(job));
+}
+
+void bm_page_in_pipeline::lookup_cache(decode_job* job)
+{
+	job->keyed.get();
+
+	if (bm_cache_read(job->cache_key, &job->bm, reinterpret_cast<void*>(job->bm.data), job->size)) {
+		// Nothing left to do for the workers
+		std::promise<bool> cached;
+		cached.set_value(true);
+		job->done = cached.get_future();
+		return;
+	}
+
+	job->write_cache = true;
+
+	job->done = m_pool.submit([job]() { return decode(job); });
+}
+
+void bm_page_in_pipeline::fill()
+{
+	while (m_jobs.size() < m_max_in_flight && m_next_candidate < m_candidates.size()) {
+		submit(m_candidates[m_next_candidate]);
+		++m_next_candidate;
+	}
+
+	// Reading the cache needs cfile so it has to happen here once the key of a job is known
+	for (auto& job : m_jobs) {
+		if (job->keyed.valid() && job->keyed.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			lookup_cache(job.get());
+		}
+	}
+}
+
+void bm_page_in_pipeline::complete(decode_job* job)
+{
+	if (job->keyed.valid()) {
+		lookup_cache(job);
+	}
+
+	bool success = job->done.get();
+
+	cfclose(job->cfp);
+	job->cfp = nullptr;
+
+	auto bs = bm_get_slot(job->handle);
+	auto bmp = &bs->entry.bm;
+
+	if (!success || bs->entry.type == BM_TYPE_NONE || bmp->data != 0) {
+		// If decoding failed then the normal loading code will try again and report the error
+		vm_free(reinterpret_cast<void*>(job->bm.data));
+		return;
+	}
+
+	if (job->write_cache) {
+		bm_cache_write(job->cache_key, &job->bm, reinterpret_cast<const void*>(job->bm.data), job->size);
+	}
+
+	bm_update_memory_used(job->handle, job->size);
+
+	bmp->bpp = job->bm.bpp;
+	bmp->flags = job->bm.flags;
+	bmp->data = job->bm.data;
+	bmp->palette = nullptr;
+	bs->entry.data_compressed = (job->compression != DDS_UNCOMPRESSED);
+
+	m_committed.push_back(job->handle);
+}
+
+void bm_page_in_pipeline::add_candidates()
+{
+	for (auto& block : bm_blocks) {
+		for (auto& slot : block) {
+			auto& entry = slot.entry;
+
+			if (entry.preloaded && get_decode_type(entry) != BM_TYPE_NONE) {
+				m_candidates.push_back(entry.handle);
+			}
+		}
+	}
+
+	nprintf(("BmpInfo", "BMPMAN: Decoding %d bitmaps on " SIZE_T_ARG " worker threads.\n", (int)m_candidates.size(), m_pool.size()));
+
+	fill();
+}
+
+void bm_page_in_pipeline::finish_through(int last_handle)
+{
+	// Jobs are submitted in handle order so the first job is always the one with the lowest handle
+	for (;;) {
+		fill();
+
+		if (m_jobs.empty() || m_jobs.front()->handle > last_handle) {
+			break;
+		}
+
+		TRACE_SCOPE(tracing::PageInDecodeWait);
+
+		complete(m_jobs.front().get());
+		m_jobs.pop_front();
+	}
+}
+
+void bm_page_in_pipeline::release_unused(int first_handle, int last_handle)
+{
+	for (auto iter = m_committed.begin(); iter != m_committed.end();) {
+		auto handle = *iter;
+
+		if (handle < first_handle || handle > last_handle) {
+			++iter;
+			continue;
+		}
+
+		auto be = bm_get_entry(handle);
+		if (be->bm.data != 0 && be->ref_count == 0) {
+			bm_free_data_fast(handle);
+		}
+
+		iter = m_committed.erase(iter);
+	}
+}
+
+} // namespace
+
 void bm_page_in_stop() {
 	TRACE_SCOPE(tracing::PageInStop);
 
@@ -2566,6 +3456,13 @@ void bm_page_in_stop() {
 
 	int bm_preloading = 1;
 
+	// If enabled, decode the image files on worker threads so that only the upload happens in the loop below
+	std::unique_ptr<bm_page_in_pipeline> pipeline;
+	if (Cmdline_page_in_threads > 0) {
+		pipeline.reset(new bm_page_in_pipeline(Cmdline_page_in_threads));
+		pipeline->add_candidates();
+	}
+
 	for (auto& block : bm_blocks) {
 		for (auto& slot : block) {
 			auto& entry = slot.entry;
@@ -2574,11 +3471,28 @@ void bm_page_in_stop() {
 				&& (entry.type != BM_TYPE_RENDER_TARGET_STATIC)) {
 				if (entry.preloaded) {
 					TRACE_SCOPE(tracing::PageInSingleBitmap);
+
+					// Animations are uploaded in one go so all frames need to be ready
+					int first_handle = entry.handle;
+					int last_handle = entry.handle;
+					if (pipeline && bm_is_anim(&entry)) {
+						first_handle = entry.info.ani.first_frame;
+						last_handle = first_handle + bm_get_entry(first_handle)->info.ani.num_frames - 1;
+					}
+
+					if (pipeline) {
+						pipeline->finish_through(last_handle);
+					}
+
 					if (bm_preloading) {
 						if (!gr_preload(entry.handle, (entry.preloaded == 2))) {
 							mprintf(("Out of VRAM.  Done preloading.\n"));
 							bm_preloading = 0;
 						}
+
+						if (pipeline) {
+							pipeline->release_unused(first_handle, last_handle);
+						}
 					} else {
 						bm_lock(entry.handle, (entry.used_flags == BMP_AABITMAP) ? 8 : 16, entry.used_flags);
 						if (entry.ref_count >= 1) {
@@ -2610,6 +3524,8 @@ void bm_page_in_stop() {
 		}
 	}
 
+	pipeline.reset();
+
 	nprintf(("BmpInfo", "BMPMAN: Loaded %d bitmaps that are marked as used for this level.\n", n));
 
 #ifndef NDEBUG
@@ -2635,6 +3551,323 @@ void bm_page_in_stop() {
 	Bm_paging = 0;
 }
 
+namespace {
+
+/**
+ * @brief Reads the full mipmap chain of streamed DDS textures on a background thread
+ *
+ * Files are opened and closed on the main thread since cfile can not do that concurrently. The finished data replaces
+ * the low resolution data between two frames. The next time the texture is used the graphics API creates the full
+ * resolution texture from it.
+ */
+class bm_mip_streamer {
+	struct stream_job {
+		int handle = -1;
+		char filename[MAX_FILENAME_LEN];
+		CFILE* cfp = nullptr;
+		ubyte* data = nullptr;
+		size_t size = 0;
+		ubyte bpp = 0;
+
+		std::future<bool> done;
+	};
+
+	// Every job keeps a cfile block open so this must stay small
+	static const size_t MAX_IN_FLIGHT = 4;
+
+	util::ThreadPool m_pool;
+
+	std::deque<int> m_pending;
+	SCP_vector<std::unique_ptr<stream_job>> m_jobs;
+
+	static bool needs_stream(int handle, const char* filename);
+
+	void start(int handle);
+	void complete(stream_job* job);
+
+  public:
+	bm_mip_streamer();
+	~bm_mip_streamer();
+
+	bm_mip_streamer(const bm_mip_streamer&) = delete;
+	bm_mip_streamer& operator=(const bm_mip_streamer&) = delete;
+
+	/**
+	 * @brief Queues reading the full data of a bitmap
+	 */
+	void request(int handle);
+
+	/**
+	 * @brief Hands finished data to bmpman and starts reading the next queued bitmaps
+	 */
+	void update();
+};
+
+bm_mip_streamer::bm_mip_streamer() : m_pool(1)
+{
+}
+
+bm_mip_streamer::~bm_mip_streamer()
+{
+	for (auto& job : m_jobs) {
+		job->done.wait();
+
+		cfclose(job->cfp);
+		vm_free(job->data);
+	}
+}
+
+bool bm_mip_streamer::needs_stream(int handle, const char* filename)
+{
+	auto be = bm_get_entry(handle);
+
+	// The slot may have been released or reused for something else since the request was made
+	if ((be->handle != handle) || (be->type != BM_TYPE_DDS)) {
+		return false;
+	}
+
+	if (filename != nullptr && stricmp(be->filename, filename) != 0) {
+		return false;
+	}
+
+	return be->stream_requested && (be->stream_skip_levels > 0);
+}
+
+void bm_mip_streamer::request(int handle)
+{
+	m_pending.push_back(handle);
+}
+
+void bm_mip_streamer::start(int handle)
+{
+	if (!needs_stream(handle, nullptr)) {
+		return;
+	}
+
+	auto be = bm_get_entry(handle);
+
+	std::unique_ptr<stream_job> job(new stream_job());
+	job->handle = handle;
+	strcpy_s(job->filename, be->filename);
+	job->size = be->mem_taken;
+
+	job->cfp = bm_open_image_file(job->filename, BM_TYPE_DDS, be->dir_type);
+	if (job->cfp == nullptr) {
+		// Keep using the low resolution version
+		nprintf(("BmpMan", "Failed to open %s for streaming!\n", job->filename));
+		return;
+	}
+
+	job->data = static_cast<ubyte*>(vm_malloc(job->size));
+
+	auto job_ptr = job.get();
+	job->done = m_pool.submit([job_ptr]() {
+		// NOTE: This is executed on a worker thread! Only the job may be accessed here.
+		return dds_read_bitmap(job_ptr->filename, job_ptr->data, &job_ptr->bpp, CF_TYPE_ANY, 0, job_ptr->cfp)
+			== DDS_ERROR_NONE;
+	});
+
+	m_jobs.push_back(std::move(job));
+}
+
+void bm_mip_streamer::complete(stream_job* job)
+{
+	bool success = job->done.get();
+
+	cfclose(job->cfp);
+	job->cfp = nullptr;
+
+	if (!success || !needs_stream(job->handle, job->filename)) {
+		if (!success) {
+			nprintf(("BmpMan", "Failed to stream %s!\n", job->filename));
+		}
+
+		vm_free(job->data);
+		job->data = nullptr;
+		return;
+	}
+
+	auto bs = bm_get_slot(job->handle);
+	auto be = &bs->entry;
+
+	// Drop the low resolution data and texture. The next bm_lock() finds the full data already loaded.
+	bm_free_data(bs, true);
+
+	be->stream_skip_levels = 0;
+
+	be->bm.bpp = job->bpp;
+	be->bm.flags = 0;
+	be->bm.data = (ptr_u)job->data;
+	be->bm.palette = nullptr;
+	bm_update_memory_used(job->handle, job->size);
+
+	job->data = nullptr;
+
+	++Bm_num_streamed;
+}
+
+void bm_mip_streamer::update()
+{
+	for (auto iter = m_jobs.begin(); iter != m_jobs.end();) {
+		auto& job = *iter;
+
+		if (job->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++iter;
+			continue;
+		}
+
+		// A locked bitmap may currently be in use so its data must not be replaced
+		if (bm_get_entry(job->handle)->ref_count > 0) {
+			++iter;
+			continue;
+		}
+
+		complete(job.get());
+		iter = m_jobs.erase(iter);
+	}
+
+	while (m_jobs.size() < MAX_IN_FLIGHT && !m_pending.empty()) {
+		auto handle = m_pending.front();
+		m_pending.pop_front();
+
+		start(handle);
+	}
+}
+
+std::unique_ptr<bm_mip_streamer> Bm_mip_streamer;
+
+} // namespace
+
+void bm_request_full_mipmaps(int handle)
+{
+	if (handle < 0) {
+		return;
+	}
+
+	auto be = bm_get_entry(handle);
+
+	if ((be->stream_skip_levels == 0) || be->stream_requested) {
+		return;
+	}
+
+	be->stream_requested = true;
+
+	if (!Bm_mip_streamer) {
+		Bm_mip_streamer.reset(new bm_mip_streamer());
+	}
+
+	Bm_mip_streamer->request(handle);
+}
+
+static void bm_stream_update()
+{
+	// Level loading does not draw anything so the textures it touches are not necessarily needed
+	if (Bm_paging || !Bm_mip_streamer) {
+		return;
+	}
+
+	Bm_mip_streamer->update();
+}
+
+static void bm_stream_close()
+{
+	Bm_mip_streamer.reset();
+}
+
+/**
+ * Decides if an uncompressed PNG, JPG or TGA texture should be block compressed when it is loaded
+ *
+ * Compression is only done for textures with dimensions the GPU formats can handle. 32-bit images use DXT5 so
+ * that the alpha channel is kept, everything else uses DXT1. The whole mipmap chain is generated along with it since
+ * the graphics API can not do that for compressed data.
+ */
+static void bm_select_load_compression(bitmap_entry *entry)
+{
+	if (!Cmdline_compress_textures || !Use_compressed_textures || Is_standalone) {
+		return;
+	}
+
+	// don't change the format of a bitmap that may already have been uploaded
+	if ((entry->comp_type != BM_TYPE_NONE) || (entry->bm.data != 0) || (entry->last_used_frame != 0)) {
+		return;
+	}
+
+	BM_TYPE type = (entry->type == BM_TYPE_EFF) ? entry->info.ani.eff.type : entry->type;
+
+	if ((type == BM_TYPE_PNG) && entry->info.ani.apng.is_apng) {
+		return;
+	}
+
+	if ((type != BM_TYPE_PNG) && (type != BM_TYPE_JPG) && (type != BM_TYPE_TGA)) {
+		return;
+	}
+
+	int w = entry->bm.w;
+	int h = entry->bm.h;
+
+	// same restriction as for DDS files, this also guarantees full blocks for the top level
+	if ((w < 4) || (h < 4) || (w & (w - 1)) || (h & (h - 1))) {
+		return;
+	}
+
+	if ((entry->bm.true_bpp != 24) && (entry->bm.true_bpp != 32)) {
+		return;
+	}
+
+	int levels = 1;
+	for (int size = MAX(w, h); size > 1; size >>= 1) {
+		++levels;
+	}
+
+	int compression = (entry->bm.true_bpp == 32) ? DDS_DXT5 : DDS_DXT1;
+
+	entry->comp_type   = (compression == DDS_DXT5) ? BM_TYPE_DXT5 : BM_TYPE_DXT1;
+	entry->num_mipmaps = levels;
+	entry->mem_taken   = dds_compressed_size(w, h, levels, compression);
+}
+
+/**
+ * Decides if only the smaller mipmaps of a DDS texture should be loaded until the texture is actually needed up close
+ */
+static void bm_select_stream_levels(bitmap_entry *entry)
+{
+	if (!Cmdline_stream_textures || Is_standalone) {
+		return;
+	}
+
+	// don't change the data of a bitmap that may already have been uploaded
+	if ((entry->type != BM_TYPE_DDS) || (entry->bm.data != 0) || (entry->last_used_frame != 0)) {
+		return;
+	}
+
+	if (entry->stream_requested || (entry->stream_skip_levels > 0)) {
+		return;
+	}
+
+	switch (entry->comp_type) {
+	case BM_TYPE_DXT1:
+	case BM_TYPE_DXT3:
+	case BM_TYPE_DXT5:
+	case BM_TYPE_BC7:
+		break;
+	default:
+		// uncompressed data and cube maps are always loaded completely
+		return;
+	}
+
+	if (bm_is_compressed(entry->handle) == 0) {
+		return;
+	}
+
+	int skip_levels = 0;
+	while ((skip_levels < entry->num_mipmaps - 1)
+		&& (MAX(entry->bm.w, entry->bm.h) >> skip_levels) > BM_STREAM_RESIDENT_SIZE) {
+		++skip_levels;
+	}
+
+	entry->stream_skip_levels = skip_levels;
+}
+
 void bm_page_in_texture(int bitmapnum, int nframes) {
 	int i;
 
@@ -2659,6 +3892,12 @@ void bm_page_in_texture(int bitmapnum, int nframes) {
 
 		frame_entry->used_flags = BMP_TEX_OTHER;
 
+		// animations have to keep all frames in the same format
+		if ((nframes == 1) && !bm_is_anim(frame_entry)) {
+			bm_select_load_compression(frame_entry);
+			bm_select_stream_levels(frame_entry);
+		}
+
 		//check if its compressed
 		switch (frame_entry->comp_type) {
 		case BM_TYPE_NONE:
@@ -2967,6 +4206,26 @@ void bm_set_low_mem(int mode) {
 	Bm_low_mem = mode;
 }
 
+void bm_set_memory_budget(size_t ram_budget, size_t texture_budget) {
+	Bm_max_ram = ram_budget;
+	Bm_max_texture_ram = texture_budget;
+}
+
+void bm_set_pinned(int handle, bool pinned) {
+	auto be = bm_get_entry(handle);
+
+	if (bm_is_anim(be)) {
+		auto first = be->info.ani.first_frame;
+		auto num_frames = bm_get_entry(first)->info.ani.num_frames;
+
+		for (int i = 0; i < num_frames; ++i) {
+			bm_get_entry(first + i)->pinned = pinned;
+		}
+	} else {
+		be->pinned = pinned;
+	}
+}
+
 bool bm_set_render_target(int handle, int face) {
 	GR_DEBUG_SCOPE("Set render target");
 
@@ -3173,12 +4432,20 @@ void bm_unlock(int handle) {
 
 void bm_update_memory_used(int n, size_t size)
 {
-#ifdef BMPMAN_NDEBUG
 	auto entry = bm_get_entry(n);
 	Assert( entry->data_size == 0 );
 	entry->data_size += size;
 	bm_texture_ram += size;
-#endif
+}
+
+void bm_update_texture_memory_used(int handle, size_t size)
+{
+	auto entry = bm_get_entry(handle);
+
+	Assertion(bm_texture_vram >= entry->texture_size, "Texture memory accounting is out of sync!");
+	bm_texture_vram -= entry->texture_size;
+	entry->texture_size = size;
+	bm_texture_vram += size;
 }
 
 static int find_block_of(int n, int start_block)
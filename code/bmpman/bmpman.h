@@ -105,6 +105,7 @@ struct bitmap_entry;
 struct bitmap_slot;
 
 extern size_t bm_texture_ram;  //!< how many bytes of textures are used.
+extern size_t bm_texture_vram; //!< how many bytes of texture memory the graphics API reported as used.
 
 extern int Bm_paging;   //!< Bool type that indicates if BMPMAN is currently paging.
 
@@ -150,6 +151,48 @@ void *bm_malloc(int handle, size_t size);
  */
 void bm_update_memory_used(int n, size_t size);
 
+/**
+ * @brief Updates how much texture memory the graphics API uses for the given bitmap
+ *
+ * @details Called by the graphics API whenever it uploads or frees the texture of a bitmap so that the residency
+ *   manager can enforce the texture memory budget.
+ *
+ * @param[in] handle The bitmap handle
+ * @param[in] size   The new size of the texture, in bytes. 0 if the texture was freed.
+ */
+void bm_update_texture_memory_used(int handle, size_t size);
+
+/**
+ * @brief Marks a bitmap as used in the current frame
+ *
+ * @details The residency manager evicts the bitmaps which have not been used for the longest time first. The graphics
+ *   API calls this every time a texture is bound.
+ */
+void bm_mark_used(int handle);
+
+/**
+ * @brief Prevents (or allows again) the residency manager from evicting a bitmap
+ *
+ * @details For animations this applies to every frame of the animation.
+ */
+void bm_set_pinned(int handle, bool pinned);
+
+/**
+ * @brief Sets the memory budgets of the residency manager
+ *
+ * @param[in] ram_budget     The maximum number of bytes of system memory used by bitmap data. 0 means unlimited.
+ * @param[in] texture_budget The maximum number of bytes of texture memory. 0 means unlimited.
+ */
+void bm_set_memory_budget(size_t ram_budget, size_t texture_budget);
+
+/**
+ * @brief Advances the bmpman frame counter and evicts the least recently used bitmaps if a budget is exceeded
+ *
+ * @details Bitmaps that are locked, pinned, render targets, user bitmaps or that were used in the frame which is ending
+ *   are never evicted. Evicted bitmaps keep their handle and are reloaded transparently the next time they are used.
+ */
+void bm_end_frame();
+
 class bitmap_lookup {
 	ubyte *Bitmap_data;
 
@@ -318,6 +361,10 @@ int bm_load_either(const char *filename, int *nframes = NULL, int *fps = NULL, i
  *
  * @details Also converts the bitmap to the appropriate format specified by bpp and flags. Only lock a bitmap when you
  *   need it!
+ *   PNG, JPG and TGA textures which bm_page_in_texture() selected for compression at load time (-compress_textures)
+ *   report a DXT type from bm_is_compressed(). Their data is only returned block compressed if flags contains that
+ *   BMP_TEX_DXT1/BMP_TEX_DXT5 flag, every other lock gets the uncompressed image as before. Asking for the other format
+ *   while the bitmap is still locked elsewhere fails.
  *
  * @param handle    The number indexing the desired bitmap
  * @param bpp       The desired bpp of the bitmep
@@ -564,6 +611,23 @@ int bm_get_tcache_type(int handle);
  */
 int bm_get_num_mipmaps(int handle);
 
+/**
+ * @brief Gets the number of the largest mipmap levels which are not part of the loaded data of a streamed texture
+ *
+ * @details The data returned by bm_lock() starts at this mipmap level. This is 0 for all bitmaps which are not streamed
+ *   or once the full data has been loaded.
+ */
+int bm_get_stream_skip_levels(int handle);
+
+/**
+ * @brief Requests the full resolution data of a streamed texture
+ *
+ * @details This should be called when an object using the texture is visible and close to the viewer. The data is read
+ *   in the background and replaces the low resolution version in a later frame. Does nothing for bitmaps which are not
+ *   streamed.
+ */
+void bm_request_full_mipmaps(int handle);
+
 /**
  * @brief Checks to see if the indexed bitmap has an alpha channel
  *
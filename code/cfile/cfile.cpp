@@ -751,7 +751,7 @@ CFILE* _cfopen(const char* source, int line, const char* file_path, const char*
 		if ( type & CFILE_MEMORY_MAPPED ) {
 		
 			// Can't open memory mapped files out of pack or memory files
-			if ( find_res.offset == 0 && find_res.data_ptr != nullptr )	{
+			if ( find_res.offset == 0 && find_res.data_ptr == nullptr )	{
 #if defined _WIN32
 				HANDLE hFile;
 
@@ -1056,14 +1056,26 @@ static CFILE *cf_open_mapped_fill_cfblock(const char* source, int line, const ch
 		cf_init_lowlevel_read_code(cfp, 0, 0, 0 );
 		
 #if defined _WIN32
+		// e.g. empty files can't be mapped.  cfclose() only closes the handles of files that were mapped, so close them
+		// here and let it free the block.
+		cfp->data = nullptr;
 		cfp->hMapFile = CreateFileMapping(cfp->hInFile, NULL, PAGE_READONLY, 0, 0, NULL);
 		if (cfp->hMapFile == NULL) {
 			nprintf(("Error", "Could not create file-mapping object.\n")); 
-			return NULL;
+			CloseHandle(cfp->hInFile);
+			cfclose(cfp);
+			return nullptr;
 		} 
 	
 		cfp->data = (ubyte*)MapViewOfFile(cfp->hMapFile, FILE_MAP_READ, 0, 0, 0);
-		Assert( cfp->data != NULL );
+		if (cfp->data == nullptr) {
+			nprintf(("Error", "Could not map view of file.\n"));
+			CloseHandle(cfp->hMapFile);
+			CloseHandle(cfp->hInFile);
+			cfclose(cfp);
+			return nullptr;
+		}
+		cfp->data_length = GetFileSize(cfp->hInFile, NULL);
 #elif defined SCP_UNIX
 		cfp->fp = fp;
 		cfp->data_length = filelength(fileno(fp));
@@ -1073,7 +1085,12 @@ static CFILE *cf_open_mapped_fill_cfblock(const char* source, int line, const ch
 		                 MAP_SHARED,                // flags
 		                 fileno(fp),                // fd
 		                 0);                        // offset
-		Assert(cfp->data != nullptr);
+		if (cfp->data == MAP_FAILED) {
+			// e.g. empty files can't be mapped, cfclose() only needs to close the file in that case
+			cfp->data = nullptr;
+			cfclose(cfp);
+			return nullptr;
+		}
 #endif
 
 		return cfp;
@@ -1335,8 +1352,11 @@ int cfwrite_string_len(const char *buf, CFILE *file)
 int cfilelength(CFILE* cfile) {
 	Assert(cfile != NULL);
 
-	// TODO: return length of memory mapped file
-	Assert(!cfile->mem_mapped);
+	if (cfile->mem_mapped) {
+		Assertion(cfile->data_length <= static_cast<size_t>(std::numeric_limits<int>::max()),
+		          "Integer overflow in cfilelength! A file is too large (but I don't know which...).");
+		return (int) cfile->data_length;
+	}
 
 	// cfile->size gets set at cfopen
 
@@ -42,9 +42,8 @@ struct CFILE {
 #ifdef _WIN32
 	HANDLE	hInFile;			// Handle from CreateFile()
 	HANDLE	hMapFile;		// Handle from CreateFileMapping()
-#else
-	size_t data_length;    // length of data for mmap
 #endif
+	size_t data_length;    // length of data for mmap
 	size_t lib_offset;
 	size_t raw_position;
 	size_t size;                // for packed files
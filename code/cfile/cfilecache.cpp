@@ -0,0 +1,92 @@
+#include "cfile/cfilecache.h"
+
+#include <md5.h>
+
+#include <ctime>
+
+namespace {
+
+const uint32_t CF_CACHE_LOCATIONS = CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT;
+const char* const CF_CACHE_EXT    = "bin";
+
+const double CF_CACHE_TIMEOUT = 30.0 * 24.0 * 60.0 * 60.0; // purge timeout in seconds which is ~1 month
+
+} // namespace
+
+SCP_string cf_cache_get_filename(const cf_cache_type& type, const SCP_string& key)
+{
+	SCP_string key_string = std::to_string(type.version) + ":" + key;
+
+	MD5 md5;
+	md5.update(key_string.c_str(), (MD5::size_type)key_string.size());
+	md5.finalize();
+
+	return SCP_string(type.prefix) + md5.hexdigest() + "." + CF_CACHE_EXT;
+}
+
+void cf_cache_fill_header(cf_cache_header* header, const cf_cache_type& type)
+{
+	header->magic   = type.magic;
+	header->version = type.version;
+}
+
+bool cf_cache_header_matches(const cf_cache_header& header, const cf_cache_type& type)
+{
+	return header.magic == type.magic && header.version == type.version;
+}
+
+CFILE* cf_cache_open_read(const SCP_string& filename, int type)
+{
+	return cfopen(filename.c_str(), "rb", type, CF_TYPE_CACHE, false, CF_CACHE_LOCATIONS);
+}
+
+CFILE* cf_cache_open_write(const SCP_string& filename)
+{
+	auto cfp = cfopen(filename.c_str(), "wb", CFILE_NORMAL, CF_TYPE_CACHE, false, CF_CACHE_LOCATIONS);
+	if (cfp == nullptr) {
+		mprintf(("Could not open cache file %s for writing!\n", filename.c_str()));
+	}
+
+	return cfp;
+}
+
+void cf_cache_close_write(CFILE* cfp, const SCP_string& filename, bool success)
+{
+	cfclose(cfp);
+
+	if (!success) {
+		// Don't leave a broken file behind
+		mprintf(("Failed to write cache file %s!\n", filename.c_str()));
+		cf_delete(filename.c_str(), CF_TYPE_CACHE, CF_CACHE_LOCATIONS);
+	}
+}
+
+void cf_cache_purge_old(const cf_cache_type& type)
+{
+	SCP_string filter = SCP_string(type.prefix) + "*." + CF_CACHE_EXT;
+
+	SCP_vector<SCP_string> cache_files;
+	SCP_vector<file_list_info> file_info;
+	cf_get_file_list(cache_files, CF_TYPE_CACHE, filter.c_str(), CF_SORT_NONE, &file_info, CF_CACHE_LOCATIONS);
+
+	Assertion(cache_files.size() == file_info.size(),
+			  "cf_get_file_list returned different sizes for file names and file informations!");
+
+	const SCP_string prefix = type.prefix;
+
+	auto now = std::time(nullptr);
+	for (size_t i = 0; i < cache_files.size(); ++i) {
+		auto& name = cache_files[i];
+
+		// Not every search location applies the prefix of the filter
+		if (name.compare(0, prefix.size(), prefix) != 0) {
+			continue;
+		}
+
+		if (std::difftime(now, file_info[i].write_time) > CF_CACHE_TIMEOUT) {
+			auto full_name = name + "." + CF_CACHE_EXT;
+
+			cf_delete(full_name.c_str(), CF_TYPE_CACHE, CF_CACHE_LOCATIONS);
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "cfile/cfile.h"
+#include "globalincs/pstypes.h"
+
+/**
+ * @file
+ *
+ * Shared handling of the files which the disk caches (bitmaps, tables, models, mission index) store in CF_TYPE_CACHE.
+ * Every cache file name consists of the prefix of its cache and a MD5 hash of everything the data depends on, and every
+ * file starts with a cf_cache_header. Files which have not been written in a long time are removed by
+ * cf_cache_purge_old().
+ */
+
+/**
+ * @brief Describes one kind of cache
+ */
+struct cf_cache_type {
+	const char* prefix; //!< The start of every file name of this cache, e.g. "bm_cache-"
+	uint magic;         //!< Identifies the files of this cache
+	int version;        //!< Has to be increased whenever the layout of the stored data changes
+};
+
+/**
+ * @brief The start of every cache file
+ */
+struct cf_cache_header {
+	uint magic;
+	int version;
+};
+
+/**
+ * @brief Builds the file name of a cache entry
+ *
+ * @param[in] type The cache the entry belongs to
+ * @param[in] key  A string containing everything the cached data depends on. The cache version is added to it.
+ *
+ * @returns The file name, including the extension
+ */
+SCP_string cf_cache_get_filename(const cf_cache_type& type, const SCP_string& key);
+
+/**
+ * @brief Fills in the magic and version of a cache file header
+ */
+void cf_cache_fill_header(cf_cache_header* header, const cf_cache_type& type);
+
+/**
+ * @brief Checks if a header read from a file has the magic and version of the cache
+ */
+bool cf_cache_header_matches(const cf_cache_header& header, const cf_cache_type& type);
+
+/**
+ * @brief Opens a cache file for reading
+ *
+ * @param[in] filename The name returned by cf_cache_get_filename()
+ * @param[in] type     CFILE_NORMAL or CFILE_MEMORY_MAPPED
+ *
+ * @returns The file, or nullptr if there is no such cache entry
+ */
+CFILE* cf_cache_open_read(const SCP_string& filename, int type = CFILE_NORMAL);
+
+/**
+ * @brief Opens a cache file for writing
+ *
+ * @returns The file, or nullptr if it could not be opened. The failure is logged.
+ */
+CFILE* cf_cache_open_write(const SCP_string& filename);
+
+/**
+ * @brief Closes a cache file which was opened with cf_cache_open_write()
+ *
+ * @param[in] cfp      The file
+ * @param[in] filename The name the file was opened with
+ * @param[in] success  false if anything could not be written, the incomplete file is deleted then
+ */
+void cf_cache_close_write(CFILE* cfp, const SCP_string& filename, bool success);
+
+/**
+ * @brief Removes the files of a cache which have not been written in about a month
+ *
+ * Entries whose source changed are never read again so they are only removed once they got old.
+ */
+void cf_cache_purge_old(const cf_cache_type& type);
@@ -19,6 +19,7 @@
 #ifdef _WIN32
 #include <io.h>
 #include <direct.h>
+#include <sys/stat.h>
 #include <windows.h>
 #include <winbase.h>		/* needed for memory mapping of file functions */
 #endif
@@ -948,6 +949,24 @@ void cf_free_secondary_filelist()
 	Num_files = 0;
 }
 
+// Returns when a file on disk was last written, or 0 if that is unknown
+static time_t cf_get_write_time(const char *path)
+{
+#ifdef _WIN32
+	struct _stat buf;
+	if (_stat(path, &buf) != 0) {
+		return 0;
+	}
+#else
+	struct stat buf;
+	if (stat(path, &buf) != 0) {
+		return 0;
+	}
+#endif
+
+	return buf.st_mtime;
+}
+
 /**
  * Searches for a file.
  *
@@ -988,6 +1007,7 @@ CFileLocation cf_find_file_location(const char* filespec, int pathtype, bool loc
 			fclose(fp);
 
 			res.offset = 0;
+			res.write_time = cf_get_write_time(filespec);
 			res.full_name = filespec;
 			res.name_ext = last_separator + 1;
 
@@ -1048,6 +1068,7 @@ CFileLocation cf_find_file_location(const char* filespec, int pathtype, bool loc
 				fclose(fp);
 
 				res.offset = 0;
+				res.write_time = cf_get_write_time(longname);
 				res.full_name = longname;
 				res.name_ext = filespec;
 
@@ -1083,6 +1104,7 @@ CFileLocation cf_find_file_location(const char* filespec, int pathtype, bool loc
 					CFileLocation res(true);
 					res.size = static_cast<size_t>(f->size);
 					res.offset = (size_t)f->pack_offset;
+					res.write_time = f->write_time;
 					res.data_ptr = f->data;
 					res.name_ext = f->name_ext;
 
@@ -1111,6 +1133,7 @@ CFileLocation cf_find_file_location(const char* filespec, int pathtype, bool loc
 			CFileLocation res(true);
 			res.size = static_cast<size_t>(f->size);
 			res.offset = (size_t)f->pack_offset;
+			res.write_time = f->write_time;
 			res.data_ptr = f->data;
 			res.name_ext = f->name_ext;
 
@@ -1239,6 +1262,7 @@ CFileLocationExt cf_find_file_location_ext( const char *filename, const int ext_
 				fclose(fp);
 
 				res.offset = 0;
+				res.write_time = cf_get_write_time(longname);
 				res.full_name = longname;
 				res.name_ext = filespec;
 
@@ -1330,6 +1354,7 @@ CFileLocationExt cf_find_file_location_ext( const char *filename, const int ext_
 						res.found = true;
 						res.size = static_cast<size_t>(f->size);
 						res.offset = (size_t)f->pack_offset;
+						res.write_time = f->write_time;
 						res.data_ptr = f->data;
 						res.name_ext = f->name_ext;
 
@@ -1362,6 +1387,7 @@ CFileLocationExt cf_find_file_location_ext( const char *filename, const int ext_
 				res.found = true;
 				res.size = static_cast<size_t>(f->size);
 				res.offset = (size_t)f->pack_offset;
+				res.write_time = f->write_time;
 				res.data_ptr = f->data;
 				res.name_ext = f->name_ext;
 
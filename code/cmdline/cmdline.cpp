@@ -170,6 +170,12 @@ Flag exe_params[] =
 	{ "-enable_shadows",	"Enable Shadows",							true,	EASY_ALL_ON  | EASY_HI_MEM_ON,		EASY_DEFAULT | EASY_HI_MEM_OFF,	"Graphics",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-enable_shadows"},
 
 	{ "-no_vsync",			"Disable vertical sync",					true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-no_vsync", },
+	{ "-bitmap_cache",		"Cache decoded images on disk",				true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-bitmap_cache", },
+	{ "-table_cache",		"Cache preprocessed tables and missions",	true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-table_cache", },
+	{ "-mission_index",	"Index mission and campaign lists",		true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-mission_index", },
+	{ "-model_cache",		"Cache model collision trees",				true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-model_cache", },
+	{ "-compress_textures",	"Compress PNG/TGA/JPG model textures",		true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-compress_textures", },
+	{ "-stream_textures",	"Stream full resolution DDS textures",	true,	0,									EASY_DEFAULT,					"Game Speed",	"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-stream_textures", },
 
 	{ "-fps",				"Show frames per second on HUD",			false,	0,									EASY_DEFAULT,					"HUD",			"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-fps", },
 	{ "-dualscanlines",		"Add another pair of scanning lines",		true,	0,									EASY_DEFAULT,					"HUD",			"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-dualscanlines", },
@@ -248,8 +254,14 @@ Flag exe_params[] =
 	{ "-noninteractive",	"Disables interactive dialogs",				true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-noninteractive", },
 	{ "-no_unfocused_pause","Don't pause if the window isn't focused",	true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-no_unfocused_pause", },
 	{ "-benchmark_mode",	"Puts the game into benchmark mode",		true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-benchmark_mode", },
+	{ "-headless_benchmark",	"Simulate a mission without rendering",	true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-headless_benchmark", },
+	{ "-benchmark_frames",	"Frames to run the headless benchmark",		true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-benchmark_frames", },
+	{ "-benchmark_output",	"Headless benchmark report file",			true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-benchmark_output", },
+	{ "-record_input",		"Record the player input of a mission",	true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-record_input", },
+	{ "-replay_input",		"Replay recorded player input",				true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-replay_input", },
 	{ "-profile_frame_time","Profile frame time",						true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-profile_frame_time", },
 	{ "-profile_write_file", "Write profiling information to file",		true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-profile_write_file", },
+	{ "-profile_sexp",		"Profile SEXP operators and events",		true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-profile_sexp", },
 	{ "-json_profiling",	"Generate JSON profiling output",			true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-json_profiling", },
 	{ "-debug_window",		"Enable the debug window",					true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-debug_window", },
 	{ "-gr_debug",		"Output graphics debug information",			true,	0,									EASY_DEFAULT,					"Dev Tool",		"http://www.hard-light.net/wiki/index.php/Command-Line_Reference#-gr_debug", },
@@ -361,9 +373,29 @@ int Cmdline_aniso_level = 0;
 // Game Speed related
 cmdline_parm no_fpscap("-no_fps_capping", "Don't limit frames-per-second", AT_NONE);	// Cmdline_NoFPSCap
 cmdline_parm no_vsync_arg("-no_vsync", NULL, AT_NONE);		// Cmdline_no_vsync
+cmdline_parm page_in_threads_arg("-page_in_threads", "Number of worker threads used to decode bitmaps and build model collision trees during level load (0 to disable)", AT_INT);	// Cmdline_page_in_threads
+cmdline_parm bitmap_ram_budget_arg("-bitmap_ram_budget", "Maximum system memory in MB used for bitmap data (0 for no limit)", AT_INT);	// Cmdline_bitmap_ram_budget
+cmdline_parm bitmap_cache_arg("-bitmap_cache", NULL, AT_NONE);	// Cmdline_bitmap_cache
+cmdline_parm table_cache_arg("-table_cache", NULL, AT_NONE);	// Cmdline_table_cache
+cmdline_parm mission_index_arg("-mission_index", NULL, AT_NONE);	// Cmdline_mission_index
+cmdline_parm model_cache_arg("-model_cache", NULL, AT_NONE);	// Cmdline_model_cache
+cmdline_parm table_threads_arg("-table_threads", "Number of worker threads used to read modular tables (0 to disable)", AT_INT);	// Cmdline_table_threads
+cmdline_parm compress_textures_arg("-compress_textures", NULL, AT_NONE);	// Cmdline_compress_textures
+cmdline_parm stream_textures_arg("-stream_textures", NULL, AT_NONE);	// Cmdline_stream_textures
+cmdline_parm texture_budget_arg("-texture_budget", "Maximum texture memory in MB before unused textures are evicted (0 for no limit)", AT_INT);	// Cmdline_texture_budget
 
 int Cmdline_NoFPSCap = 0; // Disable FPS capping - kazan
 int Cmdline_no_vsync = 0;
+int Cmdline_page_in_threads = 0;
+int Cmdline_bitmap_ram_budget = 0;
+int Cmdline_texture_budget = 0;
+bool Cmdline_bitmap_cache = false;
+bool Cmdline_table_cache = false;
+int Cmdline_table_threads = 0;
+bool Cmdline_mission_index = false;
+bool Cmdline_model_cache = false;
+bool Cmdline_compress_textures = false;
+bool Cmdline_stream_textures = false;
 
 // HUD related
 cmdline_parm ballistic_gauge("-ballistic_gauge", NULL, AT_NONE);	// Cmdline_ballistic_gauge
@@ -487,8 +519,14 @@ cmdline_parm verify_vps_arg("-verify_vps", NULL, AT_NONE);	// Cmdline_verify_vps
 cmdline_parm parse_cmdline_only(PARSE_COMMAND_LINE_STRING, "Ignore any cmdline_fso.cfg files", AT_NONE);
 cmdline_parm reparse_mainhall_arg("-reparse_mainhall", NULL, AT_NONE); //Cmdline_reparse_mainhall
 cmdline_parm frame_profile_write_file("-profile_write_file", NULL, AT_NONE); // Cmdline_profile_write_file
+cmdline_parm profile_sexp_arg("-profile_sexp", NULL, AT_NONE); // Cmdline_profile_sexp
 cmdline_parm no_unfocused_pause_arg("-no_unfocused_pause", NULL, AT_NONE); //Cmdline_no_unfocus_pause
 cmdline_parm benchmark_mode_arg("-benchmark_mode", NULL, AT_NONE); //Cmdline_benchmark_mode
+cmdline_parm headless_benchmark_arg("-headless_benchmark", "Mission to simulate without graphics and sound", AT_STRING); // Cmdline_headless_benchmark
+cmdline_parm benchmark_frames_arg("-benchmark_frames", "Number of frames to simulate (default 3600)", AT_INT); // Cmdline_benchmark_frames
+cmdline_parm benchmark_output_arg("-benchmark_output", "File for the benchmark report (default benchmark.json)", AT_STRING); // Cmdline_benchmark_output
+cmdline_parm record_input_arg("-record_input", "Record the player input of the next mission to this file", AT_STRING); // Cmdline_record_input
+cmdline_parm replay_input_arg("-replay_input", "Replay the player input recorded in this file", AT_STRING); // Cmdline_replay_input
 cmdline_parm pilot_arg("-pilot", nullptr, AT_STRING); //Cmdline_pilot
 cmdline_parm noninteractive_arg("-noninteractive", NULL, AT_NONE); //Cmdline_noninteractive
 cmdline_parm json_profiling("-json_profiling", NULL, AT_NONE); //Cmdline_json_profiling
@@ -520,8 +558,14 @@ char *Cmdline_center_res = 0;
 int Cmdline_verify_vps = 0;
 int Cmdline_reparse_mainhall = 0;
 bool Cmdline_profile_write_file = false;
+bool Cmdline_profile_sexp = false;
 bool Cmdline_no_unfocus_pause = false;
 bool Cmdline_benchmark_mode = false;
+const char *Cmdline_headless_benchmark = nullptr;
+int Cmdline_benchmark_frames = 3600;
+const char *Cmdline_benchmark_output = "benchmark.json";
+const char *Cmdline_record_input = nullptr;
+const char *Cmdline_replay_input = nullptr;
 const char *Cmdline_pilot = nullptr;
 bool Cmdline_noninteractive = false;
 bool Cmdline_json_profiling = false;
@@ -1931,6 +1975,46 @@ bool SetCmdlineParams()
 	if ( ambient_factor_arg.found() )
 		Cmdline_ambient_factor = ambient_factor_arg.get_int();
 
+	if (page_in_threads_arg.found()) {
+		Cmdline_page_in_threads = std::max(0, page_in_threads_arg.get_int());
+	}
+
+	if (bitmap_ram_budget_arg.found()) {
+		Cmdline_bitmap_ram_budget = std::max(0, bitmap_ram_budget_arg.get_int());
+	}
+
+	if (texture_budget_arg.found()) {
+		Cmdline_texture_budget = std::max(0, texture_budget_arg.get_int());
+	}
+
+	if (bitmap_cache_arg.found()) {
+		Cmdline_bitmap_cache = true;
+	}
+
+	if (table_cache_arg.found()) {
+		Cmdline_table_cache = true;
+	}
+
+	if (mission_index_arg.found()) {
+		Cmdline_mission_index = true;
+	}
+
+	if (model_cache_arg.found()) {
+		Cmdline_model_cache = true;
+	}
+
+	if (table_threads_arg.found()) {
+		Cmdline_table_threads = std::max(0, table_threads_arg.get_int());
+	}
+
+	if (compress_textures_arg.found()) {
+		Cmdline_compress_textures = true;
+	}
+
+	if (stream_textures_arg.found()) {
+		Cmdline_stream_textures = true;
+	}
+
 	if ( output_scripting_arg.found() )
 		Output_scripting_meta = true;
 
@@ -2116,6 +2200,11 @@ bool SetCmdlineParams()
 		Cmdline_profile_write_file = true;
 	}
 
+	if (profile_sexp_arg.found())
+	{
+		Cmdline_profile_sexp = true;
+	}
+
 	if (no_unfocused_pause_arg.found())
 	{
 		Cmdline_no_unfocus_pause = true;
@@ -2126,6 +2215,40 @@ bool SetCmdlineParams()
 		Cmdline_benchmark_mode = true;
 	}
 
+	if (headless_benchmark_arg.found())
+	{
+		Cmdline_headless_benchmark = headless_benchmark_arg.str();
+
+		// nothing is rendered or played back so don't initialize any of it
+		Cmdline_freespace_no_sound = 1;
+		Cmdline_freespace_no_music = 1;
+		Cmdline_noninteractive = true;
+	}
+
+	if (benchmark_frames_arg.found())
+	{
+		Cmdline_benchmark_frames = std::max(benchmark_frames_arg.get_int(), 1);
+	}
+
+	if (benchmark_output_arg.found())
+	{
+		Cmdline_benchmark_output = benchmark_output_arg.str();
+	}
+
+	if (replay_input_arg.found())
+	{
+		Cmdline_replay_input = replay_input_arg.str();
+	}
+
+	if (record_input_arg.found())
+	{
+		if (Cmdline_replay_input != nullptr) {
+			mprintf(("Ignoring -record_input because it can't be used together with -replay_input.\n"));
+		} else {
+			Cmdline_record_input = record_input_arg.str();
+		}
+	}
+
 	if (pilot_arg.found())
 	{
 		Cmdline_pilot = pilot_arg.str();
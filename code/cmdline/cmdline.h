@@ -74,6 +74,16 @@ extern int Cmdline_aniso_level;
 // Game Speed related
 extern int Cmdline_NoFPSCap;
 extern int Cmdline_no_vsync;
+extern int Cmdline_page_in_threads;
+extern int Cmdline_bitmap_ram_budget;
+extern int Cmdline_texture_budget;
+extern bool Cmdline_bitmap_cache;
+extern bool Cmdline_table_cache;
+extern int Cmdline_table_threads;
+extern bool Cmdline_mission_index;
+extern bool Cmdline_model_cache;
+extern bool Cmdline_compress_textures;
+extern bool Cmdline_stream_textures;
 
 // HUD related
 extern int Cmdline_ballistic_gauge;
@@ -143,8 +153,14 @@ extern int Cmdline_save_render_targets;
 extern int Cmdline_verify_vps;
 extern int Cmdline_reparse_mainhall;
 extern bool Cmdline_profile_write_file;
+extern bool Cmdline_profile_sexp;
 extern bool Cmdline_no_unfocus_pause;
 extern bool Cmdline_benchmark_mode;
+extern const char *Cmdline_headless_benchmark;
+extern int Cmdline_benchmark_frames;
+extern const char *Cmdline_benchmark_output;
+extern const char *Cmdline_record_input;
+extern const char *Cmdline_replay_input;
 extern const char *Cmdline_pilot;
 extern bool Cmdline_noninteractive;
 extern bool Cmdline_json_profiling;
@@ -3,6 +3,8 @@
 #include "cfile/cfile.h"
 #include "osapi/osregistry.h"
 
+#include <climits>
+
 
 /*	Currently supported formats:
  *		DXT1a	(compressed)
@@ -310,7 +312,7 @@ Done:
 }
 
 //reads pixel info from a dds file
-int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp, int cf_type)
+int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp, int cf_type, int skip_levels, CFILE *img_cfp)
 {
 	int retval;
 	int w,h,ct,lvl;
@@ -329,7 +331,12 @@ int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp, int cf_type)
 	strcat_s(real_name, ".dds");
 
 	// open it up and go to the data section
-	cfp = cfopen(real_name, "rb", CFILE_NORMAL, cf_type);
+	if (img_cfp == NULL) {
+		cfp = cfopen(real_name, "rb", CFILE_NORMAL, cf_type);
+	} else {
+		cfp = img_cfp;
+		cfseek(cfp, 0, CF_SEEK_SET);
+	}
 
 	// just in case
 	if (cfp == NULL)
@@ -341,21 +348,38 @@ int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp, int cf_type)
 
 	// this really shouldn't be needed but better safe than sorry
 	if (retval != DDS_ERROR_NONE) {
+		if (img_cfp == NULL)
+			cfclose(cfp);
+
 		return retval;
 	}
 
-	cfseek(cfp, (ct == DDS_BC7) ? DX10_OFFSET : DDS_OFFSET, CF_SEEK_SET);
+	size_t offset = 0;
+
+	// skip the largest mipmaps if only the smaller ones were requested
+	if (skip_levels > 0) {
+		Assertion(skip_levels < lvl, "Can not skip %d of the %d mipmap levels of %s!", skip_levels, lvl, real_name);
+		Assertion(ct == DDS_DXT1 || ct == DDS_DXT3 || ct == DDS_DXT5 || ct == DDS_BC7, "Only compressed, non-cubemap images can skip mipmap levels!");
+
+		offset = dds_compressed_size(w, h, skip_levels, ct);
+		size -= offset;
+	}
+
+	cfseek(cfp, ((ct == DDS_BC7) ? DX10_OFFSET : DDS_OFFSET) + (int)offset, CF_SEEK_SET);
 
 	// read in the data
-	cfread(data, 1, (int)size, cfp);
+	if (cfread(data, 1, (int)size, cfp) != (int)size) {
+		retval = DDS_ERROR_INVALID_FORMAT;
+	}
 
 	if (bpp)
 		*bpp = (ubyte)bits;
 
 	// we look done here
-	cfclose(cfp);
+	if (img_cfp == NULL)
+		cfclose(cfp);
 
-	return DDS_ERROR_NONE;
+	return retval;
 }
 
 // save some image data as a DDS image
@@ -502,6 +526,243 @@ void dds_save_image(int width, int height, int bpp, int num_mipmaps, ubyte *data
 }
 
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Block compression
+//
+// This is a simple bounding box encoder as it is commonly used for real-time DXT compression. It is a lot faster than
+// the offline tools while the quality is still acceptable for textures which didn't ship as DDS in the first place.
+
+static inline ushort dds_pack_565(int r, int g, int b)
+{
+	return (ushort)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+static inline void dds_unpack_565(ushort color, int *rgb)
+{
+	int r = (color >> 11) & 0x1f;
+	int g = (color >> 5) & 0x3f;
+	int b = color & 0x1f;
+
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+// 'block' contains 16 RGBA pixels
+static void dds_compress_color_block(const ubyte *block, ubyte *dest)
+{
+	int min_c[3] = { 255, 255, 255 };
+	int max_c[3] = { 0, 0, 0 };
+
+	for (int i = 0; i < 16; i++) {
+		for (int c = 0; c < 3; c++) {
+			min_c[c] = MIN(min_c[c], block[i * 4 + c]);
+			max_c[c] = MAX(max_c[c], block[i * 4 + c]);
+		}
+	}
+
+	// move the end points a bit inwards, this reduces the error for the colors in between
+	for (int c = 0; c < 3; c++) {
+		int inset = (max_c[c] - min_c[c]) >> 4;
+		min_c[c] += inset;
+		max_c[c] -= inset;
+	}
+
+	ushort color0 = dds_pack_565(max_c[0], max_c[1], max_c[2]);
+	ushort color1 = dds_pack_565(min_c[0], min_c[1], min_c[2]);
+
+	// color0 > color1 selects the four color mode
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+
+	uint indices = 0;
+
+	if (color0 != color1) {
+		int palette[4][3];
+		dds_unpack_565(color0, palette[0]);
+		dds_unpack_565(color1, palette[1]);
+
+		for (int c = 0; c < 3; c++) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (int i = 0; i < 16; i++) {
+			int best = 0;
+			int best_dist = INT_MAX;
+
+			for (int p = 0; p < 4; p++) {
+				int dist = 0;
+				for (int c = 0; c < 3; c++) {
+					int d = block[i * 4 + c] - palette[p][c];
+					dist += d * d;
+				}
+
+				if (dist < best_dist) {
+					best_dist = dist;
+					best = p;
+				}
+			}
+
+			indices |= (uint)best << (i * 2);
+		}
+	}
+
+	dest[0] = (ubyte)(color0 & 0xff);
+	dest[1] = (ubyte)(color0 >> 8);
+	dest[2] = (ubyte)(color1 & 0xff);
+	dest[3] = (ubyte)(color1 >> 8);
+	dest[4] = (ubyte)(indices & 0xff);
+	dest[5] = (ubyte)((indices >> 8) & 0xff);
+	dest[6] = (ubyte)((indices >> 16) & 0xff);
+	dest[7] = (ubyte)(indices >> 24);
+}
+
+// 'block' contains 16 RGBA pixels
+static void dds_compress_alpha_block(const ubyte *block, ubyte *dest)
+{
+	int min_a = 255;
+	int max_a = 0;
+
+	for (int i = 0; i < 16; i++) {
+		min_a = MIN(min_a, block[i * 4 + 3]);
+		max_a = MAX(max_a, block[i * 4 + 3]);
+	}
+
+	// alpha0 > alpha1 selects the eight alpha values mode
+	int palette[8];
+	palette[0] = max_a;
+	palette[1] = min_a;
+	for (int p = 1; p < 7; p++) {
+		palette[p + 1] = ((7 - p) * max_a + p * min_a) / 7;
+	}
+
+	uint64_t indices = 0;
+
+	if (max_a != min_a) {
+		for (int i = 0; i < 16; i++) {
+			int best = 0;
+			int best_dist = INT_MAX;
+
+			for (int p = 0; p < 8; p++) {
+				int dist = abs(block[i * 4 + 3] - palette[p]);
+
+				if (dist < best_dist) {
+					best_dist = dist;
+					best = p;
+				}
+			}
+
+			indices |= (uint64_t)best << (i * 3);
+		}
+	}
+
+	dest[0] = (ubyte)max_a;
+	dest[1] = (ubyte)min_a;
+	for (int i = 0; i < 6; i++) {
+		dest[2 + i] = (ubyte)((indices >> (i * 8)) & 0xff);
+	}
+}
+
+static inline int dds_block_size(int compression_type)
+{
+	return (compression_type == DDS_DXT1) ? 8 : 16;
+}
+
+size_t dds_compressed_size(int width, int height, int levels, int compression_type)
+{
+	Assertion(compression_type == DDS_DXT1 || compression_type == DDS_DXT3 || compression_type == DDS_DXT5 || compression_type == DDS_BC7,
+		"Unsupported compression type %d!", compression_type);
+
+	size_t size = 0;
+
+	for (int i = 0; i < levels; i++) {
+		size += (size_t)((width + 3) / 4) * ((height + 3) / 4) * dds_block_size(compression_type);
+
+		width = MAX(1, width / 2);
+		height = MAX(1, height / 2);
+	}
+
+	return size;
+}
+
+void dds_compress_image(const ubyte *src, int width, int height, int bpp, int levels, int compression_type, ubyte *dest)
+{
+	Assertion(bpp == 24 || bpp == 32, "Only 24 and 32-bit images can be compressed, got %d!", bpp);
+	Assertion(compression_type == DDS_DXT1 || compression_type == DDS_DXT5, "Unsupported compression type %d!", compression_type);
+
+	int byte_size = bpp >> 3;
+
+	// work on RGBA data so that the mipmap generation does not need to care about the source format
+	SCP_vector<ubyte> level((size_t)width * height * 4);
+	for (int i = 0; i < width * height; i++) {
+		level[i * 4 + 0] = src[i * byte_size + 2];
+		level[i * 4 + 1] = src[i * byte_size + 1];
+		level[i * 4 + 2] = src[i * byte_size + 0];
+		level[i * 4 + 3] = (byte_size == 4) ? src[i * byte_size + 3] : 255;
+	}
+
+	SCP_vector<ubyte> next_level;
+	ubyte block[16 * 4];
+
+	for (int l = 0; l < levels; l++) {
+		for (int by = 0; by < height; by += 4) {
+			for (int bx = 0; bx < width; bx += 4) {
+				// blocks at the border of small mipmaps repeat the last row/column
+				for (int y = 0; y < 4; y++) {
+					int sy = MIN(by + y, height - 1);
+
+					for (int x = 0; x < 4; x++) {
+						int sx = MIN(bx + x, width - 1);
+
+						memcpy(&block[(y * 4 + x) * 4], &level[((size_t)sy * width + sx) * 4], 4);
+					}
+				}
+
+				if (compression_type == DDS_DXT5) {
+					dds_compress_alpha_block(block, dest);
+					dest += 8;
+				}
+
+				dds_compress_color_block(block, dest);
+				dest += 8;
+			}
+		}
+
+		if (l + 1 >= levels) {
+			break;
+		}
+
+		// box filter down to the next mipmap
+		int next_width = MAX(1, width / 2);
+		int next_height = MAX(1, height / 2);
+
+		next_level.resize((size_t)next_width * next_height * 4);
+
+		for (int y = 0; y < next_height; y++) {
+			int y0 = MIN(y * 2, height - 1);
+			int y1 = MIN(y * 2 + 1, height - 1);
+
+			for (int x = 0; x < next_width; x++) {
+				int x0 = MIN(x * 2, width - 1);
+				int x1 = MIN(x * 2 + 1, width - 1);
+
+				for (int c = 0; c < 4; c++) {
+					int sum = level[((size_t)y0 * width + x0) * 4 + c] + level[((size_t)y0 * width + x1) * 4 + c]
+						+ level[((size_t)y1 * width + x0) * 4 + c] + level[((size_t)y1 * width + x1) * 4 + c];
+
+					next_level[((size_t)y * next_width + x) * 4 + c] = (ubyte)((sum + 2) / 4);
+				}
+			}
+		}
+
+		level.swap(next_level);
+		width = next_width;
+		height = next_height;
+	}
+}
+
 // returns string representation of DDS_** error code
 const char *dds_error_string(int code)
 {
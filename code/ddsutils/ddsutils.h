@@ -282,11 +282,21 @@ int dds_read_header(const char *filename, CFILE *img_cfp = NULL, int *width = 0,
 
 //reads bitmap
 //size of the data it stored in size
-int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp = NULL, int cf_type = CF_TYPE_ANY);
+//if skip_levels is set then the largest mipmaps are skipped and only the remaining levels are read
+//if img_cfp is set then the file is read from that instead of opening it, which makes this safe to use on a worker thread
+int dds_read_bitmap(const char *filename, ubyte *data, ubyte *bpp = NULL, int cf_type = CF_TYPE_ANY, int skip_levels = 0, CFILE *img_cfp = NULL);
 
 // writes a DDS file using given data
 void dds_save_image(int width, int height, int bpp, int num_mipmaps, ubyte *data = NULL, int cubemap = 0, const char *filename = NULL);
 
+// returns the number of bytes a DDS_DXT1, DDS_DXT3, DDS_DXT5 or DDS_BC7 compressed image with 'levels' mipmaps needs
+size_t dds_compressed_size(int width, int height, int levels, int compression_type);
+
+// compresses 24 or 32-bit BGR(A) data into DDS_DXT1 (BC1) or DDS_DXT5 (BC3) blocks, including 'levels' mipmaps
+// which are generated with a box filter. 'dest' must be at least dds_compressed_size() bytes.
+// this does not touch any global state so it is safe to call from worker threads
+void dds_compress_image(const ubyte *src, int width, int height, int bpp, int levels, int compression_type, ubyte *dest);
+
 //returns a string from a DDS error code
 const char *dds_error_string(int code);
 
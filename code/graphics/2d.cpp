@@ -1556,8 +1556,8 @@ bool gr_init(std::unique_ptr<os::GraphicsOperations>&& graphicsOps, int d_mode,
 		}
 	}
 
-	// if we are in standalone mode then just use special defaults
-	if (Is_standalone) {
+	// if we are in standalone mode or only simulating the game then just use special defaults
+	if (Is_standalone || Cmdline_headless_benchmark != nullptr) {
 		mode = GR_STUB;
 		width = 640;
 		height = 480;
@@ -2576,6 +2576,9 @@ void gr_flip(bool execute_scripting)
 	// Use this opportunity for retiring the uniform buffers
 	uniform_buffer_managers_retire_buffers();
 
+	// Evict bitmaps that have not been used recently if we are over the memory budget
+	bm_end_frame();
+
 	TRACE_SCOPE(tracing::PageFlip);
 	gr_screen.gf_flip();
 }
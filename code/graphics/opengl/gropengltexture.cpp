@@ -265,6 +265,9 @@ int opengl_free_texture(tcache_slot_opengl *t)
 
 	// Check if the bitmap handle is valid
 	if (t->bitmap_handle >= 0) {
+		// The memory of a texture array is accounted per frame so this frame no longer counts towards the budget
+		bm_update_texture_memory_used(t->bitmap_handle, 0);
+
 		int num_frames = 0;
 		auto animation_begin = bm_get_base_frame(t->bitmap_handle, &num_frames);
 
@@ -680,6 +683,7 @@ static int opengl_texture_set_level(int bitmap_handle, int bitmap_type, int bmap
 	tSlot->h             = (ushort)tex_h;
 
 	GL_textures_in_frame += tSlot->size;
+	bm_update_texture_memory_used(bitmap_handle, tSlot->size);
 
 	GL_CHECK_FOR_ERRORS("end of create_texture_sub()");
 
@@ -884,6 +888,17 @@ int opengl_create_texture(int bitmap_handle, int bitmap_type, tcache_slot_opengl
 
 	auto max_levels = bm_get_num_mipmaps(bitmap_handle);
 
+	// Streamed textures may not have the largest mipmaps in memory yet. The data starts at the first loaded level so
+	// the texture is treated as if that level was the full image.
+	auto stream_skip_levels = bm_get_stream_skip_levels(bitmap_handle);
+	if (stream_skip_levels > 0) {
+		Assertion(num_frames == 1, "Streamed textures can not be animations!");
+
+		width = std::max(1, width >> stream_skip_levels);
+		height = std::max(1, height >> stream_skip_levels);
+		max_levels -= stream_skip_levels;
+	}
+
 	auto base_level = 0;
 	auto resize = false;
 	if ( (Detail.hardware_textures < 4) && (bitmap_type != TCACHE_TYPE_AABITMAP) && (bitmap_type != TCACHE_TYPE_INTERFACE)
@@ -905,6 +920,9 @@ int opengl_create_texture(int bitmap_handle, int bitmap_type, tcache_slot_opengl
 			base_level = -(Detail.hardware_textures - 4);
 			Assert(base_level >= 0);
 
+			// the levels which were not streamed in yet are already skipped
+			base_level = std::max(0, base_level - stream_skip_levels);
+
 			if (base_level >= max_levels) {
 				base_level = max_levels - 1;
 			}
@@ -1024,7 +1042,8 @@ int opengl_create_texture(int bitmap_handle, int bitmap_type, tcache_slot_opengl
 		frame_slot->array_index = (uint32_t) (frame - animation_begin);
 
 		// call the helper
-		int ret_val   = opengl_texture_set_level(frame, bitmap_type, bmp->w, bmp->h, width, height, (ubyte*)bmp->data,
+		int ret_val   = opengl_texture_set_level(frame, bitmap_type, std::max(1, bmp->w >> stream_skip_levels),
+                                               std::max(1, bmp->h >> stream_skip_levels), width, height, (ubyte*)bmp->data,
                                                frame_slot, base_level, mipmap_levels, resize, intFormat);
 		frames_loaded = frames_loaded && ret_val;
 
@@ -1075,6 +1094,8 @@ int gr_opengl_tcache_set_internal(int bitmap_handle, int bitmap_type, float *u_s
 
 	// everything went ok
 	if (ret_val && t->texture_id) {
+		bm_mark_used(bitmap_handle);
+
 		*u_scale = t->u_scale;
 		*v_scale = t->v_scale;
 		*array_index = t->array_index;
@@ -18,6 +18,7 @@
 #include "io/timer.h"
 #include "ship/ship.h"
 #include "ship/ship_flags.h"
+#include "playerman/inputreplay.h"
 #include "playerman/player.h"
 #include "weapon/weapon.h"
 #include "hud/hud.h"
@@ -1644,7 +1645,7 @@ void game_process_cheats(int k)
 			return;
 
 		ship *shipp = &Ships[Objects[objnum].instance];
-		shipp->ship_name[0] = '\0';
+		ship_set_name(Objects[objnum].instance, "");
 		shipp->display_name.clear();
 		for(size_t j = 0; j < Player_orders.size(); j++)
 			shipp->orders_accepted.insert(j);
@@ -1656,7 +1657,7 @@ void game_process_cheats(int k)
 			sprintf(name, NOX("Volition Bravos %d"), ship_idx);
 			if ( (ship_name_lookup(name) == -1) && (ship_find_exited_ship_by_name(name) == -1) )
 			{
-				strcpy_s(shipp->ship_name, name);
+				ship_set_name(Objects[objnum].instance, name);
 				break;
 			}
 
@@ -1692,9 +1693,23 @@ void game_process_keys()
 	int k;
 
 	button_info_clear(&Player->bi);	// clear out the button info struct for the player
+
+	if (input_replay_playing()) {
+		// Still poll so that losing the focus, pausing and the function keys work and the live keys don't pile up
+		// until the playback ends.  The keys that control the player come from the recording.
+		do {
+			game_poll();
+		} while (key_checkch());
+	}
+
     do
 	{		
-		k = game_poll();
+		if (input_replay_playing()) {
+			k = input_replay_next_key();
+		} else {
+			k = game_poll();
+			input_replay_record_key(k);
+		}
 
 		if ( Game_mode & GM_DEAD_BLEW_UP ) {
 			continue;
@@ -1774,6 +1789,9 @@ void game_process_keys()
 	}
 	while (k);
 
+	// the buttons may also come from joystick buttons which are not part of the keys
+	input_replay_buttons(&Player->bi);
+
 	// lua button command override goes here!!
 	if (lua_game_control & LGC_B_OVERRIDE) {
 		button_info temp = Player->bi;
@@ -41,6 +41,9 @@ static uint64_t Timestamp_time_compression_microseconds_offset = 0;
 static bool Timestamp_is_paused = false;
 static bool Timestamp_sudo_paused = false;
 
+static bool Timestamp_is_frozen = false;
+static uint64_t Timestamp_frozen_microseconds = 0;
+
 static uint64_t Timestamp_microseconds_at_mission_start = 0;
 
 
@@ -145,8 +148,12 @@ static uint64_t timestamp_get_raw()
 	return timestamp_raw;
 }
 
-static uint64_t timestamp_get_microseconds()
+uint64_t timestamp_get_microseconds()
 {
+	if (Timestamp_is_frozen) {
+		return Timestamp_frozen_microseconds;
+	}
+
 	return Timestamp_time_compression_microseconds_offset + static_cast<uint64_t>(timestamp_get_raw() * Timer_to_microseconds * Timestamp_time_compression_multiplier);
 }
 
@@ -348,6 +355,35 @@ void timestamp_adjust_microseconds(uint64_t delta_microseconds, TIMER_DIRECTION
 	}
 }
 
+void timestamp_step_paused(uint64_t delta_microseconds)
+{
+	Assertion(Timer_inited, "Timer should be initialized at this point!");
+	Assertion(Timestamp_is_paused, "The timestamps must be paused before they can be stepped!");
+
+	// while paused, the raw timestamp is measured from the counter value at which we paused
+	Timestamp_paused_at_counter += static_cast<uint64_t>(delta_microseconds / Timer_to_microseconds);
+}
+
+void timestamp_freeze(uint64_t microseconds)
+{
+	Timestamp_frozen_microseconds = microseconds;
+	Timestamp_is_frozen = true;
+}
+
+void timestamp_unfreeze(bool keep_frozen_time)
+{
+	if (!Timestamp_is_frozen) {
+		return;
+	}
+
+	Timestamp_is_frozen = false;
+
+	if (keep_frozen_time) {
+		// shift the clock by the difference, this wraps around correctly if the real time is ahead
+		Timestamp_time_compression_microseconds_offset += Timestamp_frozen_microseconds - timestamp_get_microseconds();
+	}
+}
+
 extern fix Game_time_compression;
 void timestamp_update_time_compression()
 {
@@ -89,6 +89,9 @@ int timestamp();
 // same, but for use in the UI, so not subject to time compression or pauses
 UI_TIMESTAMP ui_timestamp();
 
+// the time timestamp() is based on, in microseconds
+std::uint64_t timestamp_get_microseconds();
+
 inline bool timestamp_valid(int stamp) {
 	return stamp != 0;
 }
@@ -157,6 +160,17 @@ enum class TIMER_DIRECTION { FORWARD, BACKWARD };
 void timestamp_adjust_seconds(float delta_seconds, TIMER_DIRECTION dir);
 void timestamp_adjust_microseconds(uint64_t delta_microseconds, TIMER_DIRECTION dir);
 
+// Moves the paused timestamps forward.  This lets the game run at a fixed time step which does not
+// depend on how long a frame actually took, e.g. for benchmarking.
+void timestamp_step_paused(uint64_t delta_microseconds);
+
+// Makes the timestamps return the given time (see timestamp_get_microseconds()) until timestamp_unfreeze()
+// is called.  The real time keeps running underneath so unfreezing does not lose any time.  This is used to
+// let a whole frame see a single point in time so that it can be replayed exactly.
+// If keep_frozen_time is set, the timestamps continue from the frozen time instead of jumping to the real time.
+void timestamp_freeze(uint64_t microseconds);
+void timestamp_unfreeze(bool keep_frozen_time = false);
+
 // This should be called when the game time compression is changed in any way, so that
 // the timestamp will be consistent with the faster or slower time.
 void timestamp_update_time_compression();
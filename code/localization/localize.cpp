@@ -86,6 +86,9 @@ SCP_unordered_map<int, char*> Lcl_ext_str;
 // we only need to keep the NAME_LENGTH strings, since we only need to test mission names.
 SCP_unordered_map<int, char*> Lcl_ext_str_explicit_default;
 
+// checksum of all of the above, computed once the tables are loaded
+uint Lcl_string_tables_checksum = 0;
+
 
 // ------------------------------------------------------------------------------------------------------------
 // LOCALIZE FORWARD DECLARATIONS
@@ -526,6 +529,31 @@ void lcl_xstr_init()
 
 
 	Xstr_inited = true;
+
+	// The maps are unordered so the checksum adds up the hashes of the single strings.  Every table has its own seed
+	// so that a string moving to another table changes the sum as well.
+	auto add_string = [](uint table, int index, const char* str) {
+		uint values[3];
+		values[0] = table;
+		values[1] = static_cast<uint>(index);
+		values[2] = hash_fnv1a(str, strlen(str));
+
+		Lcl_string_tables_checksum += hash_fnv1a(values, sizeof(values));
+	};
+
+	Lcl_string_tables_checksum = 0;
+	for (int i = 0; i < XSTR_SIZE; ++i) {
+		if (Xstr_table[i].str != nullptr)
+			add_string(0, i, Xstr_table[i].str);
+	}
+	for (const auto& entry : Lcl_ext_str) {
+		if (entry.second != nullptr)
+			add_string(1, entry.first, entry.second);
+	}
+	for (const auto& entry : Lcl_ext_str_explicit_default) {
+		if (entry.second != nullptr)
+			add_string(2, entry.first, entry.second);
+	}
 }
 
 
@@ -552,6 +580,13 @@ void lcl_xstr_close()
 		}
 	}
 	Lcl_ext_str_explicit_default.clear();
+
+	Lcl_string_tables_checksum = 0;
+}
+
+uint lcl_get_string_tables_checksum()
+{
+	return Lcl_string_tables_checksum;
 }
 
 
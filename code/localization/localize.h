@@ -87,6 +87,9 @@ void lcl_xstr_init();
 // free the xstr table
 void lcl_xstr_close();
 
+// checksum of the strings loaded from strings.tbl and tstrings.tbl (and their modular versions), 0 if none are loaded
+uint lcl_get_string_tables_checksum();
+
 // returns the current language character string
 void lcl_get_language_name(char *lang_name);
 
@@ -11,8 +11,13 @@
 
 #include <cstdio>
 #include <numeric>
-#if _M_IX86_FP >= 1
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define VM_BATCH_SSE
+	#define VM_BATCH_AVX
+#elif defined(__SSE__) || defined(_M_X64) || _M_IX86_FP >= 1
 	#include <xmmintrin.h>
+	#define VM_BATCH_SSE
 #endif
 
 #include "math/vecmat.h"
@@ -2922,3 +2927,328 @@ vec3d vm_well_distributed_rand_vec(int seed, vec3d* offset) {
 	}
 	return out;
 }
+
+// The SIMD kernels of the batch functions. Every kernel processes as many whole registers as it can and returns the
+// number of vectors it processed, the rest is done by calling the single vector functions. To give the same results as
+// those, the kernels must do the same operations in the same order.
+namespace {
+
+#ifdef VM_BATCH_SSE
+struct vm_batch_sse {
+	typedef __m128 reg;
+	static const size_t width = 4;
+
+	static reg set1(float f) { return _mm_set1_ps(f); }
+	static reg load(const float *f) { return _mm_loadu_ps(f); }
+	static void store(float *f, reg a) { _mm_storeu_ps(f, a); }
+	static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+	static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+	static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+	static reg neg(reg a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+	static reg sqrt(reg a) { return _mm_sqrt_ps(a); }
+	// returns a bit mask of the lanes where a < b
+	static int less(reg a, reg b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+
+	// loads four consecutive vectors, with one register per component
+	static void load3(const vec3d *v, reg &x, reg &y, reg &z)
+	{
+		reg a = _mm_loadu_ps(&v[0].xyz.x); // x0 y0 z0 x1
+		reg b = _mm_loadu_ps(&v[1].xyz.y); // y1 z1 x2 y2
+		reg c = _mm_loadu_ps(&v[2].xyz.z); // z2 x3 y3 z3
+
+		x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 3, 0, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	// the reverse of load3()
+	static void store3(vec3d *v, reg x, reg y, reg z)
+	{
+		reg xy_lo = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+		reg xy_hi = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+
+		reg a = _mm_shuffle_ps(xy_lo, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+		reg b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xy_hi, _MM_SHUFFLE(1, 0, 2, 0));
+		reg c = _mm_shuffle_ps(_mm_shuffle_ps(z, xy_hi, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(xy_hi, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+		_mm_storeu_ps(&v[0].xyz.x, a);
+		_mm_storeu_ps(&v[1].xyz.y, b);
+		_mm_storeu_ps(&v[2].xyz.z, c);
+	}
+};
+#endif
+
+#ifdef VM_BATCH_AVX
+struct vm_batch_avx {
+	typedef __m256 reg;
+	static const size_t width = 8;
+
+	static reg set1(float f) { return _mm256_set1_ps(f); }
+	static reg load(const float *f) { return _mm256_loadu_ps(f); }
+	static void store(float *f, reg a) { _mm256_storeu_ps(f, a); }
+	static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+	static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+	static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+	static reg neg(reg a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+	static int less(reg a, reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+
+	static reg combine(__m128 lo, __m128 hi) { return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1); }
+
+	// There is no cheap way to shuffle across the two halves, so do it as two groups of four
+	static void load3(const vec3d *v, reg &x, reg &y, reg &z)
+	{
+		__m128 x_lo, y_lo, z_lo, x_hi, y_hi, z_hi;
+		vm_batch_sse::load3(v, x_lo, y_lo, z_lo);
+		vm_batch_sse::load3(v + 4, x_hi, y_hi, z_hi);
+
+		x = combine(x_lo, x_hi);
+		y = combine(y_lo, y_hi);
+		z = combine(z_lo, z_hi);
+	}
+
+	static void store3(vec3d *v, reg x, reg y, reg z)
+	{
+		vm_batch_sse::store3(v, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+		vm_batch_sse::store3(v + 4, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+	}
+};
+
+typedef vm_batch_avx vm_batch_ops;
+#define VM_BATCH_OPS
+#elif defined(VM_BATCH_SSE)
+typedef vm_batch_sse vm_batch_ops;
+#define VM_BATCH_OPS
+#endif
+
+#ifdef VM_BATCH_OPS
+// (x * a) + (y * b) + (z * c), in the same order as vm_vec_dot()
+template <typename ops>
+typename ops::reg vm_batch_dot(typename ops::reg x, typename ops::reg y, typename ops::reg z, typename ops::reg a, typename ops::reg b, typename ops::reg c)
+{
+	return ops::add(ops::add(ops::mul(x, a), ops::mul(y, b)), ops::mul(z, c));
+}
+
+// dest[i] = rotate(src[i] - pre_sub, m) + post_add, with the transposed matrix if unrotate is set
+template <typename ops>
+size_t vm_batch_transform(vec3d *dest, const vec3d *src, size_t n, const matrix *m, bool unrotate, const vec3d *pre_sub, const vec3d *post_add)
+{
+	typedef typename ops::reg reg;
+
+	reg rows[9];
+	for (int i = 0; i < 9; ++i) {
+		// the transpose of a 3x3 matrix in row major order
+		int index = unrotate ? (i % 3) * 3 + i / 3 : i;
+		rows[i] = ops::set1(m->a1d[index]);
+	}
+
+	reg sub_x = ops::set1(pre_sub ? pre_sub->xyz.x : 0.0f);
+	reg sub_y = ops::set1(pre_sub ? pre_sub->xyz.y : 0.0f);
+	reg sub_z = ops::set1(pre_sub ? pre_sub->xyz.z : 0.0f);
+	reg add_x = ops::set1(post_add ? post_add->xyz.x : 0.0f);
+	reg add_y = ops::set1(post_add ? post_add->xyz.y : 0.0f);
+	reg add_z = ops::set1(post_add ? post_add->xyz.z : 0.0f);
+
+	size_t i = 0;
+	for (; i + ops::width <= n; i += ops::width) {
+		reg x, y, z;
+		ops::load3(src + i, x, y, z);
+
+		if (pre_sub) {
+			x = ops::sub(x, sub_x);
+			y = ops::sub(y, sub_y);
+			z = ops::sub(z, sub_z);
+		}
+
+		reg out_x = vm_batch_dot<ops>(x, y, z, rows[0], rows[1], rows[2]);
+		reg out_y = vm_batch_dot<ops>(x, y, z, rows[3], rows[4], rows[5]);
+		reg out_z = vm_batch_dot<ops>(x, y, z, rows[6], rows[7], rows[8]);
+
+		if (post_add) {
+			out_x = ops::add(out_x, add_x);
+			out_y = ops::add(out_y, add_y);
+			out_z = ops::add(out_z, add_z);
+		}
+
+		ops::store3(dest + i, out_x, out_y, out_z);
+	}
+
+	return i;
+}
+
+// dest[i] = dot(v[i], w) or dest[i] = dist(v[i], w) depending on the mode
+enum class vm_batch_scalar_mode { DOT, DIST_SQUARED, DIST };
+
+template <typename ops>
+size_t vm_batch_scalar(float *dest, const vec3d *v, size_t n, const vec3d *w, vm_batch_scalar_mode mode)
+{
+	typedef typename ops::reg reg;
+
+	reg w_x = ops::set1(w->xyz.x);
+	reg w_y = ops::set1(w->xyz.y);
+	reg w_z = ops::set1(w->xyz.z);
+
+	size_t i = 0;
+	for (; i + ops::width <= n; i += ops::width) {
+		reg x, y, z;
+		ops::load3(v + i, x, y, z);
+
+		reg out;
+		if (mode == vm_batch_scalar_mode::DOT) {
+			out = vm_batch_dot<ops>(x, y, z, w_x, w_y, w_z);
+		} else {
+			x = ops::sub(x, w_x);
+			y = ops::sub(y, w_y);
+			z = ops::sub(z, w_z);
+
+			out = vm_batch_dot<ops>(x, y, z, x, y, z);
+
+			// vm_vec_mag() returns 0 for anything <= 0, which sqrt does as well for the sum of squares
+			if (mode == vm_batch_scalar_mode::DIST)
+				out = ops::sqrt(out);
+		}
+
+		ops::store(dest + i, out);
+	}
+
+	return i;
+}
+
+template <typename ops>
+size_t vm_batch_cull_spheres(ubyte *visible, size_t *num_visible, const vec3d *centers, const float *radii, size_t n, const vec3d *plane_norms, const vec3d *plane_points, int num_planes)
+{
+	typedef typename ops::reg reg;
+	const int all_culled = (1 << ops::width) - 1;
+
+	size_t i = 0;
+	for (; i + ops::width <= n; i += ops::width) {
+		reg x, y, z;
+		ops::load3(centers + i, x, y, z);
+		reg neg_radius = ops::neg(ops::load(radii + i));
+
+		int culled = 0;
+		for (int p = 0; p < num_planes && culled != all_culled; ++p) {
+			reg t_x = ops::sub(x, ops::set1(plane_points[p].xyz.x));
+			reg t_y = ops::sub(y, ops::set1(plane_points[p].xyz.y));
+			reg t_z = ops::sub(z, ops::set1(plane_points[p].xyz.z));
+
+			reg dist = vm_batch_dot<ops>(t_x, t_y, t_z, ops::set1(plane_norms[p].xyz.x), ops::set1(plane_norms[p].xyz.y), ops::set1(plane_norms[p].xyz.z));
+			culled |= ops::less(dist, neg_radius);
+		}
+
+		for (size_t j = 0; j < ops::width; ++j) {
+			visible[i + j] = (culled & (1 << j)) ? 0 : 1;
+			*num_visible += visible[i + j];
+		}
+	}
+
+	return i;
+}
+#endif
+
+} // namespace
+
+void vm_vec_rotate_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *m)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_transform<vm_batch_ops>(dest, src, n, m, false, nullptr, nullptr);
+#endif
+
+	for (; i < n; ++i)
+		vm_vec_rotate(&dest[i], &src[i], m);
+}
+
+void vm_vec_unrotate_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *m)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_transform<vm_batch_ops>(dest, src, n, m, true, nullptr, nullptr);
+#endif
+
+	for (; i < n; ++i)
+		vm_vec_unrotate(&dest[i], &src[i], m);
+}
+
+void vm_vec_local_to_global_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *orient, const vec3d *pos)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_transform<vm_batch_ops>(dest, src, n, orient, true, nullptr, pos);
+#endif
+
+	for (; i < n; ++i) {
+		vec3d tmp;
+		vm_vec_unrotate(&tmp, &src[i], orient);
+		vm_vec_add(&dest[i], &tmp, pos);
+	}
+}
+
+void vm_vec_global_to_local_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *orient, const vec3d *pos)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_transform<vm_batch_ops>(dest, src, n, orient, false, pos, nullptr);
+#endif
+
+	for (; i < n; ++i) {
+		vec3d tmp;
+		vm_vec_sub(&tmp, &src[i], pos);
+		vm_vec_rotate(&dest[i], &tmp, orient);
+	}
+}
+
+void vm_vec_dot_batch(float *dest, const vec3d *v, size_t n, const vec3d *w)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_scalar<vm_batch_ops>(dest, v, n, w, vm_batch_scalar_mode::DOT);
+#endif
+
+	for (; i < n; ++i)
+		dest[i] = vm_vec_dot(&v[i], w);
+}
+
+void vm_vec_dist_squared_batch(float *dest, const vec3d *v, size_t n, const vec3d *p)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_scalar<vm_batch_ops>(dest, v, n, p, vm_batch_scalar_mode::DIST_SQUARED);
+#endif
+
+	for (; i < n; ++i)
+		dest[i] = vm_vec_dist_squared(&v[i], p);
+}
+
+void vm_vec_dist_batch(float *dest, const vec3d *v, size_t n, const vec3d *p)
+{
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_scalar<vm_batch_ops>(dest, v, n, p, vm_batch_scalar_mode::DIST);
+#endif
+
+	for (; i < n; ++i)
+		dest[i] = vm_vec_dist(&v[i], p);
+}
+
+size_t vm_cull_spheres_batch(ubyte *visible, const vec3d *centers, const float *radii, size_t n, const vec3d *plane_norms, const vec3d *plane_points, int num_planes)
+{
+	size_t num_visible = 0;
+	size_t i = 0;
+#ifdef VM_BATCH_OPS
+	i = vm_batch_cull_spheres<vm_batch_ops>(visible, &num_visible, centers, radii, n, plane_norms, plane_points, num_planes);
+#endif
+
+	for (; i < n; ++i) {
+		visible[i] = 1;
+		for (int p = 0; p < num_planes; ++p) {
+			if (vm_dist_to_plane(&centers[i], &plane_norms[p], &plane_points[p]) < -radii[i]) {
+				visible[i] = 0;
+				break;
+			}
+		}
+		num_visible += visible[i];
+	}
+
+	return num_visible;
+}
@@ -573,6 +573,36 @@ void vm_interpolate_angles_quick(angles* dest0, angles* src0, angles* src1, floa
 // volumes in a well distrubtedness-preserving way
 vec3d vm_well_distributed_rand_vec(int seed, vec3d* offset = nullptr);
 
+// Batch versions of the vector functions, which process n vectors at a time.
+// They use SSE or AVX when the build targets those instruction sets and give the same results as calling the single
+// vector functions in a loop. dest may be the same array as src.
+
+// dest[i] = vm_vec_rotate(src[i], m)
+void vm_vec_rotate_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *m);
+
+// dest[i] = vm_vec_unrotate(src[i], m)
+void vm_vec_unrotate_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *m);
+
+// Transforms points from a local into the global frame: dest[i] = vm_vec_unrotate(src[i], orient) + pos
+void vm_vec_local_to_global_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *orient, const vec3d *pos);
+
+// Transforms points from the global into a local frame: dest[i] = vm_vec_rotate(src[i] - pos, orient)
+void vm_vec_global_to_local_batch(vec3d *dest, const vec3d *src, size_t n, const matrix *orient, const vec3d *pos);
+
+// dest[i] = vm_vec_dot(&v[i], w)
+void vm_vec_dot_batch(float *dest, const vec3d *v, size_t n, const vec3d *w);
+
+// dest[i] = vm_vec_dist_squared(&v[i], p)
+void vm_vec_dist_squared_batch(float *dest, const vec3d *v, size_t n, const vec3d *p);
+
+// dest[i] = vm_vec_dist(&v[i], p)
+void vm_vec_dist_batch(float *dest, const vec3d *v, size_t n, const vec3d *p);
+
+// Culls n spheres against num_planes planes, given as a normal and a point on the plane like vm_dist_to_plane() takes them.
+// A sphere is culled if it is completely behind any of the planes, that is vm_dist_to_plane(center, norm, planep) < -radius.
+// Sets visible[i] to 1 if sphere i was not culled and 0 otherwise, and returns the number of visible spheres.
+size_t vm_cull_spheres_batch(ubyte *visible, const vec3d *centers, const float *radii, size_t n, const vec3d *plane_norms, const vec3d *plane_points, int num_planes);
+
 /** Compares two vec3ds */
 inline bool operator==(const vec3d& left, const vec3d& right) { return vm_vec_same(&left, &right) != 0; }
 inline bool operator!=(const vec3d& left, const vec3d& right) { return !(left == right); }
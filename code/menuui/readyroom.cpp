@@ -25,6 +25,7 @@
 #include "mission/missionload.h"
 #include "mission/missionparse.h"
 #include "mission/missioncampaign.h"
+#include "mission/mission_index.h"
 #include "missionui/missionscreencommon.h"
 #include "parse/parselo.h"
 #include "pilotfile/pilotfile.h"
@@ -440,13 +441,40 @@ int sim_room_standalone_mission_filter(const char *filename)
 	} 
 
 	// Check if a standalone multi mission OR Mdisk mission with data
-	type = mission_parse_is_multi(filename, mission_name);
+	if (mission_index_enabled()) {
+		mission_index_info info;
+		mission_index_get_mission(filename, &info);
+		type = info.multi_game_type;
+	} else {
+		type = mission_parse_is_multi(filename, mission_name);
+	}
 	if (type && !(type & MISSION_TYPE_SINGLE))
 		return 0;
 
 	return 1;
 }
 
+// gets the name and game type of a mission for the lists, returns false if the mission could not be parsed
+static bool sim_room_get_mission_info(const char *filename, SCP_string &name, int &game_type)
+{
+	if (mission_index_enabled()) {
+		mission_index_info info;
+		if (!mission_index_get_mission(filename, &info))
+			return false;
+
+		name = info.name;
+		game_type = info.game_type;
+		return true;
+	}
+
+	if (get_mission_info(filename))
+		return false;
+
+	name = The_mission.name;
+	game_type = The_mission.game_type;
+	return true;
+}
+
 // builds up list of standalone missions and adds them to missions simulator
 // processes one mission per frame
 //
@@ -485,7 +513,9 @@ int build_standalone_mission_list_do_frame()
 			Lcl_unexpected_tstring_check = &lcl_weirdness;
 
 			// check if we can list the mission, if loading basic info didn't return an error code, and if we didn't find an XSTR mismatch
-			bool condition = !mission_is_ignored(filename) && !get_mission_info(filename) && !lcl_weirdness;
+			SCP_string mission_name;
+			int game_type = 0;
+			bool condition = !mission_is_ignored(filename) && sim_room_get_mission_info(filename, mission_name, game_type) && !lcl_weirdness;
 
 			// maybe log
 			if (lcl_weirdness)
@@ -495,8 +525,8 @@ int build_standalone_mission_list_do_frame()
 			Lcl_unexpected_tstring_check = nullptr;
 
 			if (condition) {
-				Standalone_mission_names[Num_standalone_missions_with_info] = vm_strdup(The_mission.name);
-				Standalone_mission_flags[Num_standalone_missions_with_info] = The_mission.game_type;
+				Standalone_mission_names[Num_standalone_missions_with_info] = vm_strdup(mission_name.c_str());
+				Standalone_mission_flags[Num_standalone_missions_with_info] = game_type;
 				int y = Num_lines * (font_height + 2);
 
 				// determine some extra information
@@ -515,6 +545,9 @@ int build_standalone_mission_list_do_frame()
 	}
 
 	if (Num_standalone_missions_with_info == Num_standalone_missions) {
+		if (mission_index_enabled())
+			mission_index_save();
+
 		Standalone_mission_names_inited = 1;
 		return 1;
 	} else {
@@ -551,11 +584,14 @@ int build_campaign_mission_list_do_frame()
 	// Only allow missions already completed
 	if (Campaign.missions[Num_campaign_missions_with_info].completed || Simroom_show_all) 
 	{
-		if (!get_mission_info(Campaign.missions[Num_campaign_missions_with_info].name)) 
+		SCP_string mission_name;
+		int game_type = 0;
+
+		if (sim_room_get_mission_info(Campaign.missions[Num_campaign_missions_with_info].name, mission_name, game_type)) 
 		{
 			// add to list
-			Campaign_mission_names[Num_campaign_missions_with_info] = vm_strdup(The_mission.name);
-			Campaign_mission_flags[Num_campaign_missions_with_info] = The_mission.game_type;
+			Campaign_mission_names[Num_campaign_missions_with_info] = vm_strdup(mission_name.c_str());
+			Campaign_mission_flags[Num_campaign_missions_with_info] = game_type;
 			int y = valid_missions_with_info * (font_height + 2);
 
 			// determine some extra information
@@ -574,6 +610,9 @@ int build_campaign_mission_list_do_frame()
 	Num_campaign_missions_with_info++;
 
 	if (Num_campaign_missions_with_info == Campaign.num_missions) {
+		if (mission_index_enabled())
+			mission_index_save();
+
 		valid_missions_with_info = 0;
 		Campaign_mission_names_inited = 1;
 		return 1;
@@ -0,0 +1,437 @@
+#include "mission/mission_index.h"
+
+#include "cfile/cfile.h"
+#include "cfile/cfilecache.h"
+#include "cmdline/cmdline.h"
+#include "freespace.h"
+#include "globalincs/version.h"
+#include "localization/localize.h"
+#include "mission/missioncampaign.h"
+#include "mission/missionparse.h"
+#include "mod_table/mod_table.h"
+#include "parse/parselo.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace {
+
+const cf_cache_type MISSION_INDEX_TYPE = { "mission_index-", 0x494D4246 /* "FBMI" */, 1 };
+
+// Strings in the index are never longer than this, anything else means the file is broken
+const int MISSION_INDEX_MAX_STRING = 64 * 1024;
+
+struct index_header {
+	cf_cache_header base;
+	int num_entries;
+};
+
+struct index_entry {
+	// The location of the file when it was indexed, if any of this changes the file has to be parsed again
+	SCP_string location;
+	std::int64_t offset = 0;
+	std::int64_t size = 0;
+	std::int64_t write_time = 0;
+
+	bool is_campaign = false;
+	bool valid = false;
+
+	mission_index_info mission;
+	campaign_index_info campaign;
+};
+
+struct index_state {
+	// The name of the file the entries belong to, it depends on everything that changes the parsed text
+	SCP_string filename;
+	bool dirty = false;
+
+	// Keyed by the lowercase file name including the extension
+	SCP_unordered_map<SCP_string, index_entry> entries;
+};
+
+index_state Index;
+
+SCP_string get_index_filename()
+{
+	SCP_string key_string;
+	// The parser and the translations of the XSTRs in the missions decide what gets indexed
+	sprintf(key_string, "%s:%d:%d:%d:%d:%d.%d.%d.%d:%08x", Cmdline_mod != nullptr ? Cmdline_mod : "", Lcl_current_lang,
+	        Unicode_text_mode ? 1 : 0, Lcl_pl ? 1 : 0, Fred_running ? 1 : 0, FS_VERSION_MAJOR, FS_VERSION_MINOR,
+	        FS_VERSION_BUILD, FS_VERSION_REVIS, lcl_get_string_tables_checksum());
+
+	return cf_cache_get_filename(MISSION_INDEX_TYPE, key_string);
+}
+
+// Reading helpers, they all fail once the file is broken so the callers only have to check the last result
+class index_reader {
+  public:
+	explicit index_reader(CFILE* cfp) : m_cfp(cfp) {}
+
+	bool ok() const { return m_ok; }
+
+	template <typename T>
+	T read_value()
+	{
+		T value{};
+		if (m_ok && cfread(&value, sizeof(value), 1, m_cfp) != 1) {
+			m_ok = false;
+		}
+		return value;
+	}
+
+	bool read_bool() { return read_value<ubyte>() != 0; }
+
+	SCP_string read_string()
+	{
+		auto len = read_value<int>();
+		if (!m_ok || len < 0 || len > MISSION_INDEX_MAX_STRING) {
+			m_ok = false;
+			return SCP_string();
+		}
+
+		SCP_string str(len, '\0');
+		if (len > 0 && cfread(&str[0], len, 1, m_cfp) != 1) {
+			m_ok = false;
+		}
+		return str;
+	}
+
+  private:
+	CFILE* m_cfp;
+	bool m_ok = true;
+};
+
+class index_writer {
+  public:
+	explicit index_writer(CFILE* cfp) : m_cfp(cfp) {}
+
+	bool ok() const { return m_ok; }
+
+	template <typename T>
+	void write_value(const T& value)
+	{
+		if (m_ok && cfwrite(&value, sizeof(value), 1, m_cfp) != 1) {
+			m_ok = false;
+		}
+	}
+
+	void write_bool(bool value) { write_value<ubyte>(value ? 1 : 0); }
+
+	void write_string(const SCP_string& str)
+	{
+		write_value<int>((int)str.size());
+		if (m_ok && !str.empty() && cfwrite(str.c_str(), (int)str.size(), 1, m_cfp) != 1) {
+			m_ok = false;
+		}
+	}
+
+  private:
+	CFILE* m_cfp;
+	bool m_ok = true;
+};
+
+bool read_entry(index_reader& in, SCP_string* key, index_entry* entry)
+{
+	*key = in.read_string();
+
+	entry->location   = in.read_string();
+	entry->offset     = in.read_value<std::int64_t>();
+	entry->size       = in.read_value<std::int64_t>();
+	entry->write_time = in.read_value<std::int64_t>();
+
+	entry->is_campaign = in.read_bool();
+	entry->valid       = in.read_bool();
+
+	if (entry->is_campaign) {
+		auto& info = entry->campaign;
+		info.name            = in.read_string();
+		info.type            = in.read_value<int>();
+		info.max_players     = in.read_value<int>();
+		info.has_description = in.read_bool();
+		info.description     = in.read_string();
+		info.first_mission   = in.read_string();
+	} else {
+		auto& info = entry->mission;
+		info.name                  = in.read_string();
+		info.author                = in.read_string();
+		info.description           = in.read_string();
+		info.game_type             = in.read_value<int>();
+		info.multi_game_type       = in.read_value<int>();
+		info.num_players           = in.read_value<int>();
+		info.num_respawns          = in.read_value<int>();
+		info.localization_mismatch = in.read_bool();
+	}
+
+	return in.ok();
+}
+
+void write_entry(index_writer& out, const SCP_string& key, const index_entry& entry)
+{
+	out.write_string(key);
+
+	out.write_string(entry.location);
+	out.write_value(entry.offset);
+	out.write_value(entry.size);
+	out.write_value(entry.write_time);
+
+	out.write_bool(entry.is_campaign);
+	out.write_bool(entry.valid);
+
+	if (entry.is_campaign) {
+		auto& info = entry.campaign;
+		out.write_string(info.name);
+		out.write_value(info.type);
+		out.write_value(info.max_players);
+		out.write_bool(info.has_description);
+		out.write_string(info.description);
+		out.write_string(info.first_mission);
+	} else {
+		auto& info = entry.mission;
+		out.write_string(info.name);
+		out.write_string(info.author);
+		out.write_string(info.description);
+		out.write_value(info.game_type);
+		out.write_value(info.multi_game_type);
+		out.write_value(info.num_players);
+		out.write_value(info.num_respawns);
+		out.write_bool(info.localization_mismatch);
+	}
+}
+
+void load_index(const SCP_string& filename)
+{
+	Index.filename = filename;
+	Index.dirty    = false;
+	Index.entries.clear();
+
+	auto cfp = cf_cache_open_read(filename);
+	if (cfp == nullptr) {
+		return;
+	}
+
+	index_header header;
+	if (cfread(&header, sizeof(header), 1, cfp) != 1 || !cf_cache_header_matches(header.base, MISSION_INDEX_TYPE)
+		|| header.num_entries < 0) {
+		nprintf(("MissionIndex", "Mission index %s is outdated, rebuilding it.\n", filename.c_str()));
+		cfclose(cfp);
+		return;
+	}
+
+	index_reader in(cfp);
+	for (int i = 0; i < header.num_entries; ++i) {
+		SCP_string key;
+		index_entry entry;
+
+		if (!read_entry(in, &key, &entry)) {
+			// Keep what we have, the rest is indexed again
+			nprintf(("MissionIndex", "Mission index %s is broken after %d entries.\n", filename.c_str(), i));
+			Index.dirty = true;
+			break;
+		}
+
+		Index.entries[key] = std::move(entry);
+	}
+
+	cfclose(cfp);
+
+	nprintf(("MissionIndex", "Loaded %d entries from mission index %s.\n", (int)Index.entries.size(), filename.c_str()));
+}
+
+// Makes sure the entries belong to the current mod and language
+void maybe_load_index()
+{
+	auto filename = get_index_filename();
+
+	if (filename != Index.filename) {
+		mission_index_save();
+		load_index(filename);
+	}
+}
+
+// Looks up the entry of a file, returns nullptr if the file does not exist.  fresh is set if the entry has to be filled.
+index_entry* find_entry(const char* filename, bool is_campaign, bool* fresh)
+{
+	SCP_string key = filename;
+	SCP_tolower(key);
+
+	auto location = cf_find_file_location(filename, CF_TYPE_MISSIONS);
+	if (!location.found) {
+		if (Index.entries.erase(key) > 0) {
+			Index.dirty = true;
+		}
+		return nullptr;
+	}
+
+	auto& entry = Index.entries[key];
+
+	*fresh = entry.is_campaign != is_campaign || entry.location != location.full_name
+		|| entry.offset != (std::int64_t)location.offset || entry.size != (std::int64_t)location.size
+		|| entry.write_time != (std::int64_t)location.write_time
+		// in-memory files have a different time every time the game starts so they are never indexed
+		|| location.data_ptr != nullptr;
+
+	if (*fresh) {
+		entry = index_entry();
+		entry.location    = location.full_name;
+		entry.offset      = (std::int64_t)location.offset;
+		entry.size        = (std::int64_t)location.size;
+		entry.write_time  = (std::int64_t)location.write_time;
+		entry.is_campaign = is_campaign;
+
+		Index.dirty = true;
+	}
+
+	return &entry;
+}
+
+void parse_mission_entry(const char* filename, index_entry* entry)
+{
+	auto& info = entry->mission;
+
+	// The list screens only show missions without localization problems so they check this while parsing
+	bool mismatch = false;
+	auto old_check = Lcl_unexpected_tstring_check;
+	Lcl_unexpected_tstring_check = &mismatch;
+
+	char multi_name[NAME_LENGTH + 1];
+	info.multi_game_type = mission_parse_is_multi(filename, multi_name);
+
+	std::unique_ptr<mission> parsed(new mission());
+	entry->valid = get_mission_info(filename, parsed.get(), true) == 0;
+
+	Lcl_unexpected_tstring_check = old_check;
+
+	if (entry->valid) {
+		info.name         = parsed->name;
+		info.author       = parsed->author;
+		info.description  = parsed->mission_desc;
+		info.game_type    = parsed->game_type;
+		info.num_players  = parsed->num_players;
+		info.num_respawns = (int)parsed->num_respawns;
+	}
+	info.localization_mismatch = mismatch;
+}
+
+void parse_campaign_entry(const char* filename, index_entry* entry)
+{
+	auto& info = entry->campaign;
+
+	char name[NAME_LENGTH];
+	char* desc          = nullptr;
+	char* first_mission = nullptr;
+
+	entry->valid = mission_campaign_get_info(filename, name, &info.type, &info.max_players, &desc, &first_mission) != 0;
+
+	if (entry->valid) {
+		info.name = name;
+	}
+
+	if (desc != nullptr) {
+		info.has_description = true;
+		info.description     = desc;
+		vm_free(desc);
+	}
+
+	if (first_mission != nullptr) {
+		info.first_mission = first_mission;
+		vm_free(first_mission);
+	}
+}
+
+} // namespace
+
+bool mission_index_enabled()
+{
+	return Cmdline_mission_index;
+}
+
+bool mission_index_get_mission(const char* filename, mission_index_info* info)
+{
+	maybe_load_index();
+
+	SCP_string full_name = cf_add_ext(filename, FS_MISSION_FILE_EXT);
+
+	bool fresh;
+	auto entry = find_entry(full_name.c_str(), false, &fresh);
+	if (entry == nullptr) {
+		return false;
+	}
+
+	if (fresh) {
+		parse_mission_entry(full_name.c_str(), entry);
+	}
+
+	*info = entry->mission;
+
+	if (info->localization_mismatch && Lcl_unexpected_tstring_check != nullptr) {
+		*Lcl_unexpected_tstring_check = true;
+	}
+
+	return entry->valid;
+}
+
+bool mission_index_get_campaign(const char* filename, campaign_index_info* info)
+{
+	maybe_load_index();
+
+	SCP_string full_name = cf_add_ext(filename, FS_CAMPAIGN_FILE_EXT);
+
+	bool fresh;
+	auto entry = find_entry(full_name.c_str(), true, &fresh);
+	if (entry == nullptr) {
+		return false;
+	}
+
+	if (fresh) {
+		parse_campaign_entry(full_name.c_str(), entry);
+	}
+
+	*info = entry->campaign;
+	return entry->valid;
+}
+
+void mission_index_save()
+{
+	if (!Index.dirty || Index.filename.empty()) {
+		return;
+	}
+
+	// Drop the files that were deleted since they were indexed
+	auto it = Index.entries.begin();
+	while (it != Index.entries.end()) {
+		if (!cf_find_file_location(it->first.c_str(), CF_TYPE_MISSIONS).found) {
+			it = Index.entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto cfp = cf_cache_open_write(Index.filename);
+	if (cfp == nullptr) {
+		return;
+	}
+
+	index_header header;
+	cf_cache_fill_header(&header.base, MISSION_INDEX_TYPE);
+	header.num_entries = (int)Index.entries.size();
+
+	index_writer out(cfp);
+	out.write_value(header);
+
+	for (auto& pair : Index.entries) {
+		write_entry(out, pair.first, pair.second);
+	}
+
+	cf_cache_close_write(cfp, Index.filename, out.ok());
+
+	if (!out.ok()) {
+		return;
+	}
+
+	Index.dirty = false;
+}
+
+void mission_index_purge_old()
+{
+	cf_cache_purge_old(MISSION_INDEX_TYPE);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+/**
+ * @brief The information about a mission which is shown in the mission lists
+ */
+struct mission_index_info {
+	SCP_string name;
+	SCP_string author;
+	SCP_string description;
+	int game_type = 0;
+	int multi_game_type = 0;	// what mission_parse_is_multi() returns, 0 if the mission can't be played in multiplayer
+	int num_players = 0;
+	int num_respawns = 0;
+	bool localization_mismatch = false;	// an XSTR of the mission did not match the string table
+};
+
+/**
+ * @brief The information about a campaign which is shown in the campaign lists
+ */
+struct campaign_index_info {
+	SCP_string name;
+	int type = -1;
+	int max_players = 0;
+	bool has_description = false;
+	SCP_string description;
+	SCP_string first_mission;
+};
+
+/**
+ * @brief Checks if the mission lists should use the mission index
+ */
+bool mission_index_enabled();
+
+/**
+ * @brief Gets the list information of a mission
+ *
+ * The information is read from the persistent index if the file did not change since it was indexed. Otherwise the
+ * mission is parsed like get_mission_info() does and the index is updated. If a localization mismatch is found and
+ * Lcl_unexpected_tstring_check is set, it is flagged just like parsing the mission would.
+ *
+ * @param[in] filename The file name of the mission, with or without extension
+ * @param[out] info    The information about the mission
+ *
+ * @returns true if the mission could be parsed
+ */
+bool mission_index_get_mission(const char* filename, mission_index_info* info);
+
+/**
+ * @brief Gets the list information of a campaign, like mission_campaign_get_info() does
+ *
+ * @param[in] filename The file name of the campaign, with or without extension
+ * @param[out] info    The information about the campaign
+ *
+ * @returns true if the campaign could be parsed
+ */
+bool mission_index_get_campaign(const char* filename, campaign_index_info* info);
+
+/**
+ * @brief Writes the index to disk if anything changed since it was loaded
+ *
+ * Call this once a list is complete instead of after every file.
+ */
+void mission_index_save();
+
+/**
+ * @brief Removes the indices of mods and languages which have not been written in a long time
+ */
+void mission_index_purge_old();
@@ -36,6 +36,7 @@
 #include "menuui/techmenu.h"
 #include "mission/missioncampaign.h"
 #include "mission/missiongoals.h"
+#include "mission/mission_index.h"
 #include "missionui/missionscreencommon.h"
 #include "missionui/redalert.h"
 #include "parse/parselo.h"
@@ -257,7 +258,22 @@ int mission_campaign_maybe_add(const char *filename)
 		return 0;
 	}
 
-	if ( mission_campaign_get_info( filename, name, &type, &max_players, &desc) ) {
+	bool found;
+	if (mission_index_enabled()) {
+		campaign_index_info info;
+		found = mission_index_get_campaign(filename, &info);
+
+		if (found) {
+			strcpy_s(name, info.name.c_str());
+			type = info.type;
+			if (info.has_description)
+				desc = vm_strdup(info.description.c_str());
+		}
+	} else {
+		found = mission_campaign_get_info( filename, name, &type, &max_players, &desc) != 0;
+	}
+
+	if ( found ) {
 		if ( !MC_multiplayer && (type == CAMPAIGN_TYPE_SINGLE) ) {
 			Campaign_names[Num_campaigns] = vm_strdup(name);
 
@@ -311,6 +327,9 @@ void mission_campaign_build_list(bool desc, bool sort, bool multiplayer)
 	rc = cf_get_file_list(MAX_CAMPAIGNS, Campaign_file_names, CF_TYPE_MISSIONS, wild_card, CF_SORT_NONE);
 	Assert( rc == Num_campaigns );
 
+	if (mission_index_enabled())
+		mission_index_save();
+
 	// now sort everything, if we are supposed to
 	if (sort) {
 		incr = Num_campaigns / 2;
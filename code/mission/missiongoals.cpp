@@ -32,6 +32,7 @@
 #include "network/stand_gui.h"
 #include "parse/parselo.h"
 #include "parse/sexp.h"
+#include "parse/sexp/sexp_profiler.h"
 #include "playerman/player.h"
 #include "tracing/tracing.h"
 #include "ui/ui.h"
@@ -368,11 +369,15 @@ void mission_init_goals()
 {
 	int i;
 
+	sexp::profiler_reset();
+
 	Num_goals = 0;
 	for (i=0; i<MAX_GOALS; i++) {
 		Mission_goals[i].satisfied = GOAL_INCOMPLETE;
 		Mission_goals[i].flags = 0;
 		Mission_goals[i].team = 0;
+		Mission_goals[i].dependencies = 0;
+		Mission_goals[i].dependency_sequence = -1;
 	}
 
 	Num_mission_events = 0;
@@ -392,6 +397,8 @@ void mission_init_goals()
 		Mission_events[i].event_log_argument_buffer.clear();
 		Mission_events[i].backup_log_buffer.clear();
 		Mission_events[i].previous_result = 0;
+		Mission_events[i].dependencies = 0;
+		Mission_events[i].dependency_sequence = -1;
 	}
 
 	Mission_goal_timestamp = timestamp(GOAL_TIMESTAMP);
@@ -404,6 +411,8 @@ void mission_event_shutdown()
 {
 	int i;
 
+	sexp::profiler_mission_end();
+
 	for (i=0; i<Num_mission_events; i++) {
 		if (Mission_events[i].objective_text) {
 			vm_free(Mission_events[i].objective_text);
@@ -901,6 +910,7 @@ void mission_process_event( int event )
 	int store_formula = Mission_events[event].formula;
 	int store_result = Mission_events[event].result;
 	int store_count = Mission_events[event].count;
+	int store_timestamp = Mission_events[event].timestamp;
 
 	int result, sindex;
 	bool bump_timestamp = false; 
@@ -942,7 +952,18 @@ void mission_process_event( int event )
 		}
 	}
 
+	// an event which was false last time stays false if nothing it depends on has changed since then.  Repeating
+	// events are always evaluated since each evaluation counts against their repeat count.
+	if ((sindex >= 0) && !result && !timestamp_valid(Mission_events[event].timestamp) && !Snapshot_all_events
+		&& (Mission_events[event].mission_log_flags == 0)
+		&& !sexp_state_changed_since(Mission_events[event].dependencies, Mission_events[event].dependency_sequence)) {
+		sindex = -1;  // bypass evaluation
+	}
+
 	if (sindex >= 0) {
+		int sequence = sexp_get_state_sequence();
+		Sexp_evaluation_dependencies = 0;
+
 		Sexp_useful_number = 1;
 		if (Snapshot_all_events || Mission_events[event].mission_log_flags != 0) {
 			Log_event = true;
@@ -952,7 +973,16 @@ void mission_process_event( int event )
 			Current_event_log_container_buffer = &Mission_events[event].event_log_container_buffer;
 			Current_event_log_argument_buffer = &Mission_events[event].event_log_argument_buffer;
 		}
-		result = eval_sexp(sindex);
+		if (sexp::Profiler_enabled) {
+			sexp::profiler_begin_event(event);
+			result = eval_sexp(sindex);
+			sexp::profiler_end_event();
+		} else {
+			result = eval_sexp(sindex);
+		}
+
+		Mission_events[event].dependencies = Sexp_evaluation_dependencies;
+		Mission_events[event].dependency_sequence = result ? -1 : sequence;
 
 		// if the directive count is a special value, deal with that first.  Mark the event as a special
 		// event, and unmark it when the directive is true again.
@@ -992,6 +1022,9 @@ void mission_process_event( int event )
 		Mission_events[event].repeat_count = 0;
 		Mission_events[event].formula = -1;
 
+		// let the events which check this one know about the change
+		sexp_state_changed(SEXP_DEP_EVENTS);
+
 		// Also send an update, if necessary.
 		if(MULTIPLAYER_MASTER && ((store_flags != Mission_events[event].flags) || (sindex != Mission_events[event].formula) || (store_formula != Mission_events[event].formula) || (store_result != Mission_events[event].result) || (store_count != Mission_events[event].count)) ){
 			send_event_update_packet(event);
@@ -1048,6 +1081,10 @@ void mission_process_event( int event )
 		}
 	}
 
+	if ((store_formula != Mission_events[event].formula) || (store_result != Mission_events[event].result) || (store_timestamp != Mission_events[event].timestamp)) {
+		sexp_state_changed(SEXP_DEP_EVENTS);
+	}
+
 	// see if anything has changed	
 	if(MULTIPLAYER_MASTER && ((store_flags != Mission_events[event].flags) || (store_formula != Mission_events[event].formula) || (store_result != Mission_events[event].result) || (store_count != Mission_events[event].count)) ){
 		send_event_update_packet(event);
@@ -1096,7 +1133,19 @@ void mission_eval_goals()
 		}
 
 		if (Mission_goals[i].satisfied == GOAL_INCOMPLETE) {
+			// the goal is still false if nothing it depends on has changed
+			if (!sexp_state_changed_since(Mission_goals[i].dependencies, Mission_goals[i].dependency_sequence)) {
+				continue;
+			}
+
+			int sequence = sexp_get_state_sequence();
+			Sexp_evaluation_dependencies = 0;
+
 			result = eval_sexp(Mission_goals[i].formula);
+
+			Mission_goals[i].dependencies = Sexp_evaluation_dependencies;
+			Mission_goals[i].dependency_sequence = result ? -1 : sequence;
+
 			if ( Sexp_nodes[Mission_goals[i].formula].value == SEXP_KNOWN_FALSE ) {
 				mission_goal_status_change( i, GOAL_FAILED );
 
@@ -60,6 +60,9 @@ typedef struct mission_goal {
 	int	score;							// score for this goal
 	int	flags;							// MGF_
 	int	team;								// which team is this objective for.
+
+	int	dependencies;					// SEXP_DEP_ flags read by the last evaluation of the formula
+	int	dependency_sequence;			// sexp state sequence at the last evaluation, -1 if it has to be evaluated
 } mission_goal;
 
 extern mission_goal Mission_goals[MAX_GOALS];	// structure for the goals of this mission
@@ -125,6 +128,9 @@ typedef struct mission_event {
 	SCP_vector<SCP_string> backup_log_buffer;
 	int	previous_result;		// result of previous evaluation of event
 
+	int	dependencies;			// SEXP_DEP_ flags read by the last evaluation of the formula
+	int	dependency_sequence;	// sexp state sequence at the last evaluation, -1 if it has to be evaluated
+
 } mission_event;
 
 extern int Num_mission_events;
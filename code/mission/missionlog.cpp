@@ -21,6 +21,7 @@
 #include "network/multimsgs.h"
 #include "network/multiutil.h"
 #include "parse/parselo.h"
+#include "parse/sexp.h"
 #include "playerman/player.h"
 #include "ship/ship.h"
 
@@ -69,12 +70,90 @@ static fix Log_line_timestamps[MAX_LOG_LINES];
 std::array<log_entry, MAX_LOG_ENTRIES> log_entries;	// static array because John says....
 int last_entry;
 
+// Index of log_entries so that the goal code doesn't have to scan the whole log.  Entries are grouped by type and
+// primary name, except for dock and undock entries which are grouped by both names since their order doesn't matter.
+// Each group holds the positions of its entries in log order.
+static SCP_unordered_map<SCP_string, SCP_vector<int>> Log_entry_index;
+
+static bool mission_log_is_dock_type(LogType type)
+{
+	return (type == LOG_SHIP_DOCKED) || (type == LOG_SHIP_UNDOCKED);
+}
+
+static SCP_string mission_log_index_key(LogType type, const char *pname, const char *sname)
+{
+	SCP_string key(1, static_cast<char>('A' + static_cast<int>(type)));
+
+	SCP_string primary = pname;
+	SCP_tolower(primary);
+
+	if (mission_log_is_dock_type(type)) {
+		SCP_string secondary = sname;
+		SCP_tolower(secondary);
+
+		if (secondary < primary) {
+			std::swap(primary, secondary);
+		}
+
+		key += primary;
+		key += '\n';
+		key += secondary;
+	} else {
+		key += primary;
+	}
+
+	return key;
+}
+
+static void mission_log_index_entry(int n)
+{
+	const auto& entry = log_entries[n];
+	Log_entry_index[mission_log_index_key(entry.type, entry.pname, entry.sname)].push_back(n);
+}
+
+static void mission_log_rebuild_index()
+{
+	Log_entry_index.clear();
+
+	for (int i = 0; i < last_entry; i++) {
+		mission_log_index_entry(i);
+	}
+}
+
+// returns the positions of all entries which may match the given query, or nullptr if there are none
+static const SCP_vector<int> *mission_log_find_entries(LogType type, const char *pname, const char *sname)
+{
+	auto it = Log_entry_index.find(mission_log_index_key(type, pname, sname));
+	if (it == Log_entry_index.end()) {
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+// The names are missing, which used to only be noticed once an entry of the type was found.  Keep it that way so
+// that goals about something that never happened don't break into the debugger.
+static int mission_log_missing_names(LogType type)
+{
+	for (int i = 0; i < last_entry; i++) {
+		if (log_entries[i].type == type) {
+			Int3();
+			break;
+		}
+	}
+
+	return 0;
+}
+
 void mission_log_init()
 {
 	last_entry = 0;
 
 	// zero out all the memory so we don't get bogus information when playing across missions!
 	log_entries.fill({});
+	Log_entry_index.clear();
+
+	sexp_state_changed(SEXP_DEP_MISSION_LOG);
 }
 
 // function to clean up the mission log removing obsolete entries.  Entries might get marked obsolete
@@ -96,6 +175,7 @@ void mission_log_cull_obsolete_entries()
 
 	// compact the log array, removing the obsolete entries.
 	index = i;						// index is the first obsolete entry
+	sexp_state_changed(SEXP_DEP_MISSION_LOG);
 
 	// 'index' should always point to the next element in the list
 	// which is getting compacted.  'i' points to the next array
@@ -110,6 +190,9 @@ void mission_log_cull_obsolete_entries()
 		log_entries[i++] = log_entries[index++];
 	} while ( i < last_entry );
 
+	// the positions of the remaining entries changed
+	mission_log_rebuild_index();
+
 #ifndef NDEBUG
 	nprintf(("missionlog", "Ending entry: %d.\n", last_entry));
 #endif
@@ -186,6 +269,9 @@ void mission_log_add_entry(LogType type, const char *pname, const char *sname, i
 		return;
 	}
 
+	// events which check the log have to be evaluated again
+	sexp_state_changed(SEXP_DEP_MISSION_LOG);
+
 	last_entry_save = last_entry;
 
 	// mark any entries as obsolete.  Part of the pruning is done based on the type (and name) passed
@@ -379,6 +465,7 @@ void mission_log_add_entry(LogType type, const char *pname, const char *sname, i
 		send_mission_log_packet( &log_entries[last_entry] );
 	}
 
+	mission_log_index_entry(last_entry);
 	last_entry++;
 
 #ifndef NDEBUG
@@ -461,6 +548,8 @@ void mission_log_add_entry_multi( LogType type, const char *pname, const char *s
 	Assert ( Game_mode & GM_MULTIPLAYER );
 	Assert ( !(Net_player->flags & NETINFO_FLAG_AM_MASTER) );
 
+	sexp_state_changed(SEXP_DEP_MISSION_LOG);
+
 	// mark any entries as obsolete.  Part of the pruning is done based on the type (and name) passed
 	// for a new entry
 	mission_log_obsolete_entries(type, pname);
@@ -489,70 +578,57 @@ void mission_log_add_entry_multi( LogType type, const char *pname, const char *s
 
 	entry->pname_display = entry->pname;
 	entry->sname_display = entry->sname;
+
+	mission_log_index_entry(last_entry - 1);
 }
 
 // function to determine is the given event has taken place count number of times.
 
 int mission_log_get_time_indexed( LogType type, const char *pname, const char *sname, int count, fix *time)
 {
-	int i, found;
 	log_entry *entry;
 	Assertion(count > 0, "The count parameter is %d; it should be greater than 0!", count);
 
-	entry = &log_entries[0];
+	// if we are looking for a dock/undock entry, then we don't care about the order in which the names
+	// were passed into this function.  The index already groups those entries by both names.
+	bool dock_type = mission_log_is_dock_type(type);
+	if ( (pname == NULL) || (dock_type && (sname == NULL)) ) {
+		return mission_log_missing_names(type);
+	}
 
-	for (i = 0; i < last_entry; i++, entry++) {
-		found = 0;
+	auto entries = mission_log_find_entries(type, pname, dock_type ? sname : NULL);
+	if (entries == nullptr) {
+		return 0;
+	}
 
-		if ( entry->type == type ) {
-			// if we are looking for a dock/undock entry, then we don't care about the order in which the names
-			// were passed into this function.  Count the entry as found if either name matches both in the other
-			// set.
-			if ( (type == LOG_SHIP_DOCKED) || (type == LOG_SHIP_UNDOCKED) ) {
-				if (sname == NULL) {
-					Int3();
-					return 0;
-				}
+	for (int i : *entries) {
+		entry = &log_entries[i];
+		Assert(entry->type == type);
 
-				if ( (!stricmp(entry->pname, pname) && !stricmp(entry->sname, sname)) || (!stricmp(entry->pname, sname) && !stricmp(entry->sname, pname)) ) {
-					found = 1;
+		// for non dock/undock goals, then the names are important!
+		if ( !dock_type && (sname != NULL) ) {
+			// if we are looking for a subsystem entry, the subsystem names must be compared
+			if ((type == LOG_SHIP_SUBSYS_DESTROYED || type == LOG_CAP_SUBSYS_CARGO_REVEALED)) {
+				if ( subsystem_stricmp(sname, entry->sname) != 0 ) {
+					continue;
 				}
 			} else {
-				// for non dock/undock goals, then the names are important!
-				if (pname == NULL) {
-					Int3();
-					return 0;
-				}
-
-				if ( stricmp(entry->pname, pname) != 0 ) {
+				if ( stricmp(sname, entry->sname) != 0 ) {
 					continue;
 				}
-
-				// if we are looking for a subsystem entry, the subsystem names must be compared
-				if ((type == LOG_SHIP_SUBSYS_DESTROYED || type == LOG_CAP_SUBSYS_CARGO_REVEALED)) {
-					if ( (sname == NULL) || !subsystem_stricmp(sname, entry->sname) ) {
-						found = 1;
-					}
-				} else {
-					if ( (sname == NULL) || !stricmp(sname, entry->sname) ) {
-						found = 1;
-					}
-				}
 			}
+		}
 
-			if ( found ) {
-				count--;
-
-				if ( !count ) {
-					entry->flags |= MLF_ESSENTIAL;				// since the goal code asked for this entry, mark it as essential
+		count--;
 
-					if (time) {
-						*time = entry->timestamp;
-					}
+		if ( !count ) {
+			entry->flags |= MLF_ESSENTIAL;				// since the goal code asked for this entry, mark it as essential
 
-					return 1;
-				}
+			if (time) {
+				*time = entry->timestamp;
 			}
+
+			return 1;
 		}
 	}
 
@@ -571,42 +647,27 @@ int mission_log_get_time( LogType type, const char *pname, const char *sname, fi
 
 int mission_log_get_count( LogType type, const char *pname, const char *sname )
 {
-	int i;
-	log_entry *entry;
-	int count = 0;  
-
-	entry = &log_entries[0];
-
-	for (i = 0; i < last_entry; i++, entry++) {
-
-		if ( entry->type == type ) {
-			// if we are looking for a dock/undock entry, then we don't care about the order in which the names
-			// were passed into this function.  Count the entry as found if either name matches both in the other
-			// set.
-			if ( (type == LOG_SHIP_DOCKED) || (type == LOG_SHIP_UNDOCKED) ) {
-				if (sname == NULL) {
-					Int3();
-					return 0;
-				}
+	// if we are looking for a dock/undock entry, then we don't care about the order in which the names
+	// were passed into this function.  The index already groups those entries by both names.
+	bool dock_type = mission_log_is_dock_type(type);
+	if ( (pname == NULL) || (dock_type && (sname == NULL)) ) {
+		return mission_log_missing_names(type);
+	}
 
-				if ( (!stricmp(entry->pname, pname) && !stricmp(entry->sname, sname)) || (!stricmp(entry->pname, sname) && !stricmp(entry->sname, pname)) ) {
-					count++;
-				}
-			} else {
-				// for non dock/undock goals, then the names are important!
-				if (pname == NULL) {
-					Int3();
-					return 0;
-				}
+	auto entries = mission_log_find_entries(type, pname, dock_type ? sname : NULL);
+	if (entries == nullptr) {
+		return 0;
+	}
 
-				if ( stricmp(entry->pname, pname) != 0 ) {
-					continue;
-				}
+	// for non dock/undock goals, then the names are important!
+	if ( dock_type || (sname == NULL) ) {
+		return (int)entries->size();
+	}
 
-				if ( (sname == NULL) || !stricmp(sname, entry->sname) ) {
-					count++;
-				}
-			}
+	int count = 0;
+	for (int i : *entries) {
+		if ( !stricmp(sname, log_entries[i].sname) ) {
+			count++;
 		}
 	}
 
@@ -62,6 +62,7 @@
 #include "parse/generic_log.h"
 #include "parse/parselo.h"
 #include "parse/sexp_container.h"
+#include "parse/sexp/sexp_bytecode.h"
 #include "scripting/hook_api.h"
 #include "scripting/scripting.h"
 #include "playerman/player.h"
@@ -4811,6 +4812,7 @@ void parse_wings(mission* pm)
 		Assert(Num_wings < MAX_WINGS);
 		parse_wing(pm);
 		Num_wings++;
+		wing_name_index_rebuild();
 	}
 
 	bool found = false;
@@ -5946,6 +5948,7 @@ bool parse_mission(mission *pm, int flags)
 	waypoint_parse_init();
 
 	Player_starts = Num_cargo = Num_goals = Num_wings = 0;
+	wing_name_index_rebuild();
 	Player_start_shipnum = -1;
 	*Player_start_shipname = 0;		// make the string 0 length for checking later
 	clear_texture_replacements();
@@ -6210,6 +6213,23 @@ bool post_process_mission()
 		}
 	}
 
+	// compile the formulas which are evaluated every frame
+	if (!Fred_running) {
+		int num_compiled = 0;
+
+		for (i = 0; i < Num_mission_events; i++) {
+			if (sexp::compile_formula(Mission_events[i].formula))
+				num_compiled++;
+		}
+
+		for (i = 0; i < Num_goals; i++) {
+			if (sexp::compile_formula(Mission_goals[i].formula))
+				num_compiled++;
+		}
+
+		nprintf(("SEXP", "Compiled %d of %d event and goal formulas.\n", num_compiled, Num_mission_events + Num_goals));
+	}
+
 	// multiplayer missions are handled just before mission start
 	if (!(Game_mode & GM_MULTIPLAYER) ){	
 		ai_post_process_mission();
@@ -98,6 +98,10 @@ struct submodel_instance
 	matrix	canonical_orient = vmd_identity_matrix;
 	matrix	canonical_prev_orient = vmd_identity_matrix;
 
+	// Must be incremented whenever canonical_orient is changed, so that the cached transforms of the model instance
+	// are recalculated.  submodel_canonicalize() does this for you.
+	uint	orient_generation = 0;
+
 	// --- these fields used to be in bsp_info ---
 
 	// Electrical Arc Effect Info
@@ -116,12 +120,24 @@ struct submodel_instance
 	}
 };
 
+// The accumulated transform from a submodel's frame of reference to the model's frame of reference, i.e.
+// model_pnt = unrotate(submodel_pnt, orient) + offset.  Cached per model instance and only valid as long as
+// generation matches the sum of the orient_generation of the submodel and all its parents.
+struct submodel_transform
+{
+	matrix	orient = vmd_identity_matrix;
+	vec3d	offset = vmd_zero_vector;
+	uint	generation = 0;
+	bool	valid = false;
+};
+
 // Data specific to a particular instance of a model.
 struct polymodel_instance
 {
 	int id = -1;							// global model_instance num index
 	int model_num = -1;						// global model num index, same as polymodel->id
 	submodel_instance *submodel = nullptr;	// array of submodel instances; mirrors the polymodel->submodel array
+	submodel_transform *transforms = nullptr;	// cached submodel transforms for the current frame; mirrors the submodel array
 
 	int objnum;								// id of the object using this pmi, or -1 if no object (e.g. skybox) 
 };
@@ -529,6 +545,14 @@ typedef struct shield_vertex {
 	float		u,v;
 } shield_vertex;
 
+// A node of the bounding volume hierarchy over the shield triangles.  The first child of an inner node directly
+// follows it and the second child is at the index in first.  Leaves reference a range of shield_info::bvh_tris.
+struct shield_bvh_node {
+	vec3d	min, max;
+	int		first;			// leaf: index of the first triangle in bvh_tris, inner node: index of the second child
+	int		num_tris;		// 0 for inner nodes
+};
+
 // the high level shield structure.  A ship without any shield has nverts and ntris set to 0.
 // The vertex list and the tris list are used by the shield_tri structure
 struct shield_info {
@@ -537,6 +561,10 @@ struct shield_info {
 	shield_vertex	*verts;
 	shield_tri		*tris;
 
+	// used for shield collisions if the model has no shield collision tree, see model_shield_bvh_create()
+	SCP_vector<shield_bvh_node>	bvh;
+	SCP_vector<int>				bvh_tris;
+
 	gr_buffer_handle buffer_id;
 	int buffer_n_verts;
 	vertex_layout layout;
@@ -558,8 +586,6 @@ typedef struct model_octant {
 	vec3d		min, max;				// The bounding box that makes up this octant defined as 2 points.
 	int			nverts;					// how many vertices are in this octant
 	vec3d		**verts;					// The vertices in this octant in the high-res hull.  A vertex can only be in one octant.
-	int			nshield_tris;			// how many shield triangles are in the octant
-	shield_tri	**shield_tris;			// the shield triangles that make up this octant. A tri could be in multiple octants.
 } model_octant;
 
 #define MAX_EYES	10
@@ -675,7 +701,7 @@ class polymodel
 public:
 	// initialize to 0 and NULL because previously a memset was used
 	polymodel()
-		: id(-1), version(0), flags(0), n_detail_levels(0), num_debris_objects(0), n_models(0), num_lights(0), lights(NULL),
+		: id(-1), version(0), pof_checksum(0), pof_size(0), flags(0), n_detail_levels(0), num_debris_objects(0), n_models(0), num_lights(0), lights(NULL),
 		n_view_positions(0), rad(0.0f), core_radius(0.0f), n_textures(0), submodel(NULL), n_guns(0), n_missiles(0), n_docks(0),
 		n_thrusters(0), gun_banks(NULL), missile_banks(NULL), docking_bays(NULL), thrusters(NULL), ship_bay(NULL), shield(),
 		shield_collision_tree(NULL), sldc_size(0), n_paths(0), paths(NULL), mass(0), num_xc(0), xc(NULL), num_split_plane(0),
@@ -706,6 +732,8 @@ public:
 	int			id;				// what the polygon model number is.  (Index in Polygon_models)
 	int			version;
 	char			filename[FILESPEC_LENGTH];
+	uint			pof_checksum;	// checksum and size of the POF file, used to share data between models with the same file contents
+	int			pof_size;
 
 	uint			flags;			// 1=allow tiling
 	int			n_detail_levels;
@@ -1208,6 +1236,10 @@ bsp_collision_tree *model_get_bsp_collision_tree(int tree_index);
 void model_remove_bsp_collision_tree(int tree_index);
 int model_create_bsp_collision_tree();
 
+// Waits until the collision trees of a model which are built on a worker thread during level load are done.  Must be
+// called before the collision trees of a model are used while the level is loading.
+void model_finish_collision_trees(polymodel *pm);
+
 //=========================== MODEL OCTANT STUFF ================================
 
 //  Models are now divided into 8 octants.    Shields too.
@@ -0,0 +1,298 @@
+#include "model/model_cache.h"
+
+#include "cfile/cfile.h"
+#include "cfile/cfilecache.h"
+#include "cmdline/cmdline.h"
+#include "model/model.h"
+#include "parse/parselo.h"
+
+namespace {
+
+const cf_cache_type MODEL_CACHE_TYPE = { "model_cache-", 0x444D4246 /* "FBMD" */, 1 };
+
+struct model_cache_header {
+	cf_cache_header base;
+
+	// The key, to protect against hash collisions
+	uint pof_checksum;
+	int pof_size;
+	int pof_version;
+	int n_models;
+
+	// The layout of the stored structures, in case they change without a version bump
+	int node_size;
+	int leaf_size;
+	int vert_size;
+};
+
+// Per submodel data following the header. A submodel without a collision tree only stores has_tree.
+struct model_cache_tree_header {
+	int has_tree;
+	int n_points;
+	int n_nodes;
+	int n_leaves;
+	int n_verts;
+};
+
+void fill_header(model_cache_header* header, const model_cache_key& key, int n_models)
+{
+	memset(header, 0, sizeof(*header));
+
+	cf_cache_fill_header(&header->base, MODEL_CACHE_TYPE);
+	header->pof_checksum = key.pof_checksum;
+	header->pof_size     = key.pof_size;
+	header->pof_version  = key.pof_version;
+	header->n_models     = n_models;
+	header->node_size    = (int)sizeof(bsp_collision_node);
+	header->leaf_size    = (int)sizeof(bsp_collision_leaf);
+	header->vert_size    = (int)sizeof(model_tmap_vert);
+}
+
+SCP_string get_cache_filename(const model_cache_key& key)
+{
+	SCP_string key_string;
+	sprintf(key_string, "%08x:%d:%d", key.pof_checksum, key.pof_size, key.pof_version);
+
+	return cf_cache_get_filename(MODEL_CACHE_TYPE, key_string);
+}
+
+bool needs_collision_tree(const bsp_info* sm)
+{
+	return !sm->flags[Model::Submodel_flags::Nocollide_this_only, Model::Submodel_flags::No_collisions];
+}
+
+// The number of entries in the vert_list of a tree, which is not stored in the tree itself
+int get_num_verts(const bsp_collision_tree* tree)
+{
+	int n_verts = 0;
+
+	for (int i = 0; i < tree->n_leaves; ++i) {
+		n_verts = std::max(n_verts, tree->leaf_list[i].vert_start + tree->leaf_list[i].num_verts);
+	}
+
+	return n_verts;
+}
+
+// Reads consecutive blocks out of the cache data while checking that they are in bounds
+class cache_reader {
+	const ubyte* m_data;
+	size_t m_remaining;
+
+  public:
+	cache_reader(const ubyte* data, size_t size) : m_data(data), m_remaining(size) {}
+
+	const ubyte* read(size_t size)
+	{
+		if (size > m_remaining) {
+			return nullptr;
+		}
+
+		auto block = m_data;
+		m_data += size;
+		m_remaining -= size;
+
+		return block;
+	}
+
+	template <typename T>
+	bool read_array(SCP_vector<T>& out, int count)
+	{
+		if (count < 0) {
+			return false;
+		}
+
+		auto block = read(sizeof(T) * count);
+		if (block == nullptr) {
+			return false;
+		}
+
+		out.resize(count);
+		if (count > 0) {
+			memcpy(out.data(), block, sizeof(T) * count);
+		}
+		return true;
+	}
+
+	bool at_end() const { return m_remaining == 0; }
+};
+
+struct cached_tree {
+	bool has_tree = false;
+	SCP_vector<vec3d> points;
+	SCP_vector<bsp_collision_node> nodes;
+	SCP_vector<bsp_collision_leaf> leaves;
+	SCP_vector<model_tmap_vert> verts;
+};
+
+template <typename T>
+T* copy_to_list(const SCP_vector<T>& values)
+{
+	if (values.empty()) {
+		return nullptr;
+	}
+
+	auto list = reinterpret_cast<T*>(vm_malloc(sizeof(T) * values.size()));
+	memcpy(list, values.data(), sizeof(T) * values.size());
+
+	return list;
+}
+
+bool parse_cache_data(const ubyte* data, size_t size, const model_cache_key& key, polymodel* pm)
+{
+	cache_reader reader(data, size);
+
+	model_cache_header expected;
+	fill_header(&expected, key, pm->n_models);
+
+	auto header = reader.read(sizeof(model_cache_header));
+	if (header == nullptr || memcmp(header, &expected, sizeof(expected)) != 0) {
+		return false;
+	}
+
+	// Read everything before touching the model so a broken entry does not leave half a model behind
+	SCP_vector<cached_tree> trees(pm->n_models);
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		model_cache_tree_header tree_header;
+
+		auto block = reader.read(sizeof(tree_header));
+		if (block == nullptr) {
+			return false;
+		}
+		memcpy(&tree_header, block, sizeof(tree_header));
+
+		auto& tree = trees[i];
+		tree.has_tree = tree_header.has_tree != 0;
+
+		if (tree.has_tree != needs_collision_tree(&pm->submodel[i])) {
+			return false;
+		}
+
+		if (!reader.read_array(tree.points, tree_header.n_points) || !reader.read_array(tree.nodes, tree_header.n_nodes)
+			|| !reader.read_array(tree.leaves, tree_header.n_leaves) || !reader.read_array(tree.verts, tree_header.n_verts)) {
+			return false;
+		}
+	}
+
+	if (!reader.at_end()) {
+		return false;
+	}
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		auto& cached = trees[i];
+		if (!cached.has_tree) {
+			continue;
+		}
+
+		pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
+		auto tree = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
+
+		tree->n_verts    = (int)cached.points.size();
+		tree->point_list = copy_to_list(cached.points);
+		tree->n_nodes    = (int)cached.nodes.size();
+		tree->node_list  = copy_to_list(cached.nodes);
+		tree->n_leaves   = (int)cached.leaves.size();
+		tree->leaf_list  = copy_to_list(cached.leaves);
+		tree->vert_list  = copy_to_list(cached.verts);
+	}
+
+	return true;
+}
+
+} // namespace
+
+bool model_cache_enabled()
+{
+	return Cmdline_model_cache;
+}
+
+bool model_cache_read(const model_cache_key& key, polymodel* pm)
+{
+	auto filename = get_cache_filename(key);
+	bool valid = false;
+
+	// Try memory mapping first since that avoids copying the data through the cfile buffers
+	auto cfp = cf_cache_open_read(filename, CFILE_MEMORY_MAPPED);
+	if (cfp != nullptr) {
+		auto length = static_cast<size_t>(cfilelength(cfp));
+		auto file_data = static_cast<const ubyte*>(cf_returndata(cfp));
+
+		valid = parse_cache_data(file_data, length, key, pm);
+
+		cfclose(cfp);
+	} else {
+		cfp = cf_cache_open_read(filename);
+		if (cfp == nullptr) {
+			return false;
+		}
+
+		SCP_vector<ubyte> file_data(static_cast<size_t>(cfilelength(cfp)));
+		if (file_data.empty() || cfread(file_data.data(), (int)file_data.size(), 1, cfp) == 1) {
+			valid = parse_cache_data(file_data.data(), file_data.size(), key, pm);
+		}
+
+		cfclose(cfp);
+	}
+
+	if (!valid) {
+		nprintf(("ModelCache", "Cache file %s does not match model %s.\n", filename.c_str(), pm->filename));
+	}
+	return valid;
+}
+
+void model_cache_write(const model_cache_key& key, const polymodel* pm)
+{
+	auto filename = get_cache_filename(key);
+
+	auto cfp = cf_cache_open_write(filename);
+	if (cfp == nullptr) {
+		return;
+	}
+
+	model_cache_header header;
+	fill_header(&header, key, pm->n_models);
+
+	bool success = cfwrite(&header, sizeof(header), 1, cfp) == 1;
+
+	for (int i = 0; success && i < pm->n_models; ++i) {
+		auto sm = &pm->submodel[i];
+
+		model_cache_tree_header tree_header;
+		memset(&tree_header, 0, sizeof(tree_header));
+
+		const bsp_collision_tree* tree = nullptr;
+		if (sm->collision_tree_index >= 0) {
+			tree = model_get_bsp_collision_tree(sm->collision_tree_index);
+
+			tree_header.has_tree = 1;
+			tree_header.n_points = tree->n_verts;
+			tree_header.n_nodes  = tree->n_nodes;
+			tree_header.n_leaves = tree->n_leaves;
+			tree_header.n_verts  = get_num_verts(tree);
+		}
+
+		success = cfwrite(&tree_header, sizeof(tree_header), 1, cfp) == 1;
+
+		if (success && tree != nullptr) {
+			if (tree_header.n_points > 0) {
+				success = success && cfwrite(tree->point_list, sizeof(vec3d), tree_header.n_points, cfp) == tree_header.n_points;
+			}
+			if (tree_header.n_nodes > 0) {
+				success = success && cfwrite(tree->node_list, sizeof(bsp_collision_node), tree_header.n_nodes, cfp) == tree_header.n_nodes;
+			}
+			if (tree_header.n_leaves > 0) {
+				success = success && cfwrite(tree->leaf_list, sizeof(bsp_collision_leaf), tree_header.n_leaves, cfp) == tree_header.n_leaves;
+			}
+			if (tree_header.n_verts > 0) {
+				success = success && cfwrite(tree->vert_list, sizeof(model_tmap_vert), tree_header.n_verts, cfp) == tree_header.n_verts;
+			}
+		}
+	}
+
+	cf_cache_close_write(cfp, filename, success);
+}
+
+void model_cache_purge_old()
+{
+	cf_cache_purge_old(MODEL_CACHE_TYPE);
+}
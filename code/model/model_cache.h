@@ -0,0 +1,48 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+class polymodel;
+
+/**
+ * @brief Identifies the processed data of one POF file in the model disk cache
+ *
+ * The key contains a checksum of the POF file so a cache entry automatically becomes invalid once the model changes.
+ * Old entries are removed by model_cache_purge_old().
+ */
+struct model_cache_key {
+	uint pof_checksum = 0;
+	int pof_size      = 0;
+	int pof_version   = 0;
+};
+
+/**
+ * @brief Checks if the model disk cache should be used
+ */
+bool model_cache_enabled();
+
+/**
+ * @brief Restores the BSP collision trees of a model from the cache
+ *
+ * The submodels must already be read from the POF file. Every submodel which needs a collision tree gets one assigned
+ * through its collision_tree_index. If the cache entry is missing or does not match the model, nothing is changed.
+ *
+ * @param[in] key The key of the POF file
+ * @param[in] pm  The model which receives the collision trees
+ *
+ * @returns true if the collision trees were restored from the cache
+ */
+bool model_cache_read(const model_cache_key& key, polymodel* pm);
+
+/**
+ * @brief Stores the BSP collision trees of a model in the cache
+ *
+ * @param[in] key The key of the POF file
+ * @param[in] pm  The model whose collision trees have been built
+ */
+void model_cache_write(const model_cache_key& key, const polymodel* pm);
+
+/**
+ * @brief Removes cache entries which have not been written in a long time
+ */
+void model_cache_purge_old();
@@ -23,6 +23,8 @@ namespace animation {
 	const size_t Num_animation_flags = sizeof(Animation_flags) / sizeof(flag_def_list_new<animation::Animation_Flags>);
 
 	std::map<int, ModelAnimationSet::RunningAnimationList> ModelAnimationSet::s_runningAnimations;
+	uint ModelAnimationSet::s_evaluationPass = 0;
+	std::vector<ModelAnimationSubmodelBuffer> ModelAnimationSet::s_evaluatedBuffers;
 	std::map<unsigned int, std::shared_ptr<ModelAnimation>> ModelAnimationSet::s_animationById;
 
 	ModelAnimation::ModelAnimation(bool isInitialType, bool isMultiCompatible, bool canStateChange, const ModelAnimationSet* defaultSet)
@@ -42,6 +44,7 @@ namespace animation {
 
 		instanceData.state = ModelAnimationState::NEED_RECALC;
 		instanceData.time = 0;
+		ModelAnimationSet::invalidateEvaluation(pmi->id);
 	}
 
 	ModelAnimationState ModelAnimation::play(float frametime, polymodel_instance* pmi, ModelAnimationSubmodelBuffer& applyBuffer, bool applyOnly) {
@@ -65,6 +68,7 @@ namespace animation {
 				auto thisPtr = shared_from_this();
 				
 				animEntry.animationList.push_back(thisPtr);
+				animEntry.idleApplied = false;
 			}
 
 			/* fall-thru */
@@ -180,6 +184,8 @@ namespace animation {
 			return;
 		}
 
+		ModelAnimationSet::invalidateEvaluation(pmi->id);
+
 		float timeOffset = multiOverrideTime != nullptr ? *multiOverrideTime : 0.0f;
 
 		//Make sure to recalculate the animation here, as otherwise we cannot inquire about things like length after starting.
@@ -228,8 +234,10 @@ namespace animation {
 		instanceData.time = 0.0f;
 		instanceData.state = ModelAnimationState::UNTRIGGERED;
 
-		if (cleanup)
+		if (cleanup) {
+			ModelAnimationSet::invalidateEvaluation(pmi->id);
 			ModelAnimationSet::cleanRunning();
+		}
 	}
 
 	float ModelAnimation::getTime(int pmi_id) const{
@@ -239,40 +247,80 @@ namespace animation {
 		return 0.0f;
 	}
 
-	void ModelAnimation::stepAnimations(float frametime, polymodel_instance* pmi) {
+	void ModelAnimation::evaluateAnimations(float frametime) {
+		ModelAnimationSet::s_evaluationPass++;
+
+		size_t numEvaluated = 0;
+		auto animListIt = ModelAnimationSet::s_runningAnimations.begin();
+		while (animListIt != ModelAnimationSet::s_runningAnimations.end()) {
+			auto& animList = animListIt->second;
+
+			//Clean up the animations that stopped since the last pass, including those of instances that weren't stepped
+			if (animList.removeUntriggered(animListIt->first)) {
+				animListIt = ModelAnimationSet::s_runningAnimations.erase(animListIt);
+				continue;
+			}
+
+			polymodel_instance* pmi = model_get_instance(animListIt->first);
+			++animListIt;
+
+			//Only evaluate the instances of objects that obj_move_all moves this frame
+			if (pmi == nullptr || pmi->objnum < 0)
+				continue;
+
+			const object* objp = &Objects[pmi->objnum];
+			if (objp->type == OBJ_NONE || objp->type == OBJ_OBSERVER || objp->flags[Object::Object_Flags::Should_be_dead] || object_get_model_instance(objp) != pmi->id)
+				continue;
+
+			//Completed or paused animations don't advance, and recalculating reads the submodels after they were moved this frame, so both are left to applyAnimations
+			if (animList.isIdle(pmi->id) || animList.needsRecalculation(pmi->id))
+				continue;
+
+			if (ModelAnimationSet::s_evaluatedBuffers.size() <= numEvaluated)
+				ModelAnimationSet::s_evaluatedBuffers.resize(numEvaluated + 1);
+
+			auto& applyBuffer = ModelAnimationSet::s_evaluatedBuffers[numEvaluated];
+			applyBuffer.clear();
+			animList.parentSet->initializeSubmodelBuffer(pmi, applyBuffer);
+			animList.evaluate(frametime, pmi, applyBuffer);
+
+			animList.evaluatedPass = ModelAnimationSet::s_evaluationPass;
+			animList.evaluatedIndex = numEvaluated;
+			animList.evaluationValid = true;
+			numEvaluated++;
+		}
+	}
+
+	void ModelAnimation::applyAnimations(float frametime, polymodel_instance* pmi) {
 		auto animListIt = ModelAnimationSet::s_runningAnimations.find(pmi->id);
 
 		if (animListIt == ModelAnimationSet::s_runningAnimations.end())
 			return;
 
-		const auto& animList = animListIt->second;
-
-		ModelAnimationSubmodelBuffer applyBuffer;
-		animList.parentSet->initializeSubmodelBuffer(pmi, applyBuffer);
+		auto& animList = animListIt->second;
 
-		for (const auto& anim : animList.animationList) {
-			switch (anim->m_instances[pmi->id].state) {
-			case ModelAnimationState::RUNNING_FWD:
-			case ModelAnimationState::RUNNING_RWD:
-			case ModelAnimationState::NEED_RECALC:
-				anim->play(frametime, pmi, applyBuffer);
-				break;
-			case ModelAnimationState::COMPLETED:
-			case ModelAnimationState::PAUSED:
-				anim->play(frametime, pmi, applyBuffer, true);
-				//Currently not moving. Keep in buffer in case some other animation starts on that submodel, but don't play without manual starting
-				break;
-			case ModelAnimationState::UNTRIGGERED:
-				UNREACHABLE("An untriggered animation should not be in the runningAnimations buffer");
-				break;
-			}
+		//Completed or paused animations whose submodels haven't been touched since they were last applied would only reapply the same state.
+		//Reapplying would also have marked the submodels as no longer moving, so that still needs to happen.
+		if (animList.isUnchanged(pmi)) {
+			animList.parentSet->resetPhysicsData(pmi);
+			return;
+		}
 
+		if (animList.evaluationValid && animList.evaluatedPass == ModelAnimationSet::s_evaluationPass) {
+			ModelAnimationSet::apply(pmi, ModelAnimationSet::s_evaluatedBuffers[animList.evaluatedIndex]);
+		}
+		else {
+			ModelAnimationSubmodelBuffer applyBuffer;
+			animList.parentSet->initializeSubmodelBuffer(pmi, applyBuffer);
+			animList.evaluate(frametime, pmi, applyBuffer);
+			ModelAnimationSet::apply(pmi, applyBuffer);
 		}
 
-		ModelAnimationSet::apply(pmi, applyBuffer);
+		animList.evaluationValid = false;
+		animList.updateIdleState(pmi);
 
-		//Clear Animations that might have completed this frame.
-		ModelAnimationSet::cleanRunning();
+		//Clear Animations of this instance that might have completed this frame. Instances that aren't applied are cleaned in the next evaluation pass.
+		ModelAnimationSet::cleanRunning(pmi->id);
 	}
 
 	ModelAnimationData<> ModelAnimationSubmodel::identity(ZERO_VECTOR, IDENTITY_MATRIX);
@@ -316,6 +364,7 @@ namespace animation {
 
 		submodel->canonical_prev_orient = submodel->canonical_orient;
 		submodel->canonical_orient = data.orientation;
+		submodel->orient_generation++;
 
 		matrix delta;
 		vm_copy_transpose(&delta, &submodel->canonical_prev_orient);
@@ -475,6 +524,7 @@ namespace animation {
 
 		submodel->canonical_prev_orient = submodel->canonical_orient;
 		submodel->canonical_orient = data.orientation;
+		submodel->orient_generation++;
 
 		float angle = 0.0f;
 		vm_closest_angle_to_matrix(&submodel->canonical_orient, &sm->rotation_axis, &angle);
@@ -575,19 +625,24 @@ namespace animation {
 		}
 	}
 
+	bool ModelAnimationSet::RunningAnimationList::removeUntriggered(int pmi_id) {
+		auto animIt = animationList.cbegin();
+		while (animIt != animationList.cend()) {
+			if ((*animIt)->m_instances[pmi_id].state == ModelAnimationState::UNTRIGGERED) {
+				animIt = animationList.erase(animIt);
+				idleApplied = false;
+			}
+			else
+				animIt++;
+		}
+
+		return animationList.empty();
+	}
+
 	void ModelAnimationSet::cleanRunning() {
 		auto removeIt = s_runningAnimations.begin();
 		while (removeIt != s_runningAnimations.end()) {
-			auto animIt = removeIt->second.animationList.cbegin();
-			while (animIt != removeIt->second.animationList.cend()) {
-				if ((*animIt)->m_instances[removeIt->first].state == ModelAnimationState::UNTRIGGERED) {
-					animIt = removeIt->second.animationList.erase(animIt);
-				}
-				else
-					animIt++;
-			}
-
-			if (removeIt->second.animationList.empty()) {
+			if (removeIt->second.removeUntriggered(removeIt->first)) {
 				removeIt = s_runningAnimations.erase(removeIt);
 			}
 			else
@@ -595,6 +650,18 @@ namespace animation {
 		}
 	}
 
+	void ModelAnimationSet::cleanRunning(int pmi_id) {
+		auto removeIt = s_runningAnimations.find(pmi_id);
+		if (removeIt != s_runningAnimations.end() && removeIt->second.removeUntriggered(pmi_id))
+			s_runningAnimations.erase(removeIt);
+	}
+
+	void ModelAnimationSet::invalidateEvaluation(int pmi_id) {
+		auto animListIt = s_runningAnimations.find(pmi_id);
+		if (animListIt != s_runningAnimations.end())
+			animListIt->second.evaluationValid = false;
+	}
+
 	void ModelAnimationSet::stopAnimations(polymodel_instance* pmi) {
 		if (pmi != nullptr) {
 			for (const auto& anim : s_runningAnimations[pmi->id].animationList) {
@@ -643,6 +710,101 @@ namespace animation {
 		}
 	}
 
+	uint ModelAnimationSet::getSubmodelGeneration(polymodel_instance* pmi) const {
+		uint generation = 0;
+		for (const auto& submodel : m_submodels) {
+			submodel_instance* smi = submodel->findSubmodel(pmi).first;
+			if (smi != nullptr)
+				generation += smi->orient_generation;
+		}
+		return generation;
+	}
+
+	void ModelAnimationSet::resetPhysicsData(polymodel_instance* pmi) const {
+		for (const auto& submodel : m_submodels)
+			submodel->resetPhysicsData(pmi);
+	}
+
+	bool ModelAnimationSet::RunningAnimationList::isIdle(int pmi_id) const {
+		for (const auto& anim : animationList) {
+			auto instance = anim->m_instances.find(pmi_id);
+			if (instance == anim->m_instances.end())
+				return false;
+
+			ModelAnimationState state = instance->second.state;
+			if (state != ModelAnimationState::COMPLETED && state != ModelAnimationState::PAUSED)
+				return false;
+		}
+		return true;
+	}
+
+	bool ModelAnimationSet::RunningAnimationList::needsRecalculation(int pmi_id) const {
+		for (const auto& anim : animationList) {
+			auto instance = anim->m_instances.find(pmi_id);
+			if (instance != anim->m_instances.end() && instance->second.state == ModelAnimationState::NEED_RECALC)
+				return true;
+		}
+		return false;
+	}
+
+	void ModelAnimationSet::RunningAnimationList::evaluate(float frametime, polymodel_instance* pmi, ModelAnimationSubmodelBuffer& applyBuffer) const {
+		for (const auto& anim : animationList) {
+			auto& instanceData = anim->m_instances[pmi->id];
+
+			//Animations evaluated earlier in this pass have already advanced, they only need their state recalculated
+			bool alreadyStepped = instanceData.steppedPass == s_evaluationPass;
+			float stepTime = alreadyStepped ? 0.0f : frametime;
+			instanceData.steppedPass = s_evaluationPass;
+
+			switch (instanceData.state) {
+			case ModelAnimationState::RUNNING_FWD:
+			case ModelAnimationState::RUNNING_RWD:
+			case ModelAnimationState::NEED_RECALC:
+				anim->play(stepTime, pmi, applyBuffer);
+				break;
+			case ModelAnimationState::COMPLETED:
+			case ModelAnimationState::PAUSED:
+				anim->play(stepTime, pmi, applyBuffer, true);
+				//Currently not moving. Keep in buffer in case some other animation starts on that submodel, but don't play without manual starting
+				break;
+			case ModelAnimationState::UNTRIGGERED:
+				//Only possible if the animation stopped itself when it was stepped earlier in this pass. It still sets its final state, and is cleaned up once this instance is applied
+				Assertion(alreadyStepped, "An untriggered animation should not be in the runningAnimations buffer");
+				if (alreadyStepped)
+					anim->play(stepTime, pmi, applyBuffer, true);
+				break;
+			}
+		}
+	}
+
+	void ModelAnimationSet::RunningAnimationList::updateIdleState(polymodel_instance* pmi) {
+		idleApplied = isIdle(pmi->id);
+		if (!idleApplied)
+			return;
+
+		idleTimes.clear();
+		for (const auto& anim : animationList)
+			idleTimes.push_back(anim->getTime(pmi->id));
+
+		idleGeneration = parentSet->getSubmodelGeneration(pmi);
+	}
+
+	bool ModelAnimationSet::RunningAnimationList::isUnchanged(polymodel_instance* pmi) const {
+		if (!idleApplied || !isIdle(pmi->id))
+			return false;
+
+		//Someone could have restarted and paused an animation at a different time without it ever being stepped
+		auto timeIt = idleTimes.cbegin();
+		for (const auto& anim : animationList) {
+			if (timeIt == idleTimes.cend() || *timeIt != anim->getTime(pmi->id))
+				return false;
+			++timeIt;
+		}
+
+		//Or something else moved the submodels in the meantime
+		return parentSet->getSubmodelGeneration(pmi) == idleGeneration;
+	}
+
 	bool ModelAnimationSet::start(polymodel_instance* pmi, ModelAnimationTriggerType type, const SCP_string& name, ModelAnimationDirection direction, bool forced, bool instant, bool pause, int subtype) const {
 		if (pmi == nullptr)
 			return false;
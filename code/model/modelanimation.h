@@ -246,6 +246,8 @@ namespace animation {
 			ModelAnimationState state = ModelAnimationState::UNTRIGGERED;
 			float time = 0.0f;
 			float duration = 0.0f;
+			//The evaluation pass this instance was last stepped in, so that it isn't stepped twice in one frame
+			uint steppedPass = 0;
 		};
 		//PMI ID -> Instance Data
 		std::map<int, instance_data> m_instances;
@@ -280,7 +282,10 @@ namespace animation {
 
 		float getTime(int pmi_id) const;
 		
-		static void stepAnimations(float frametime, polymodel_instance* pmi);
+		//Steps the running animations of all objects that are moved this frame into per-instance buffers. Call once per frame, before the objects are moved
+		static void evaluateAnimations(float frametime);
+		//Applies the evaluated animations of this instance to its submodels, evaluating them now if they weren't evaluated or were changed since
+		static void applyAnimations(float frametime, polymodel_instance* pmi);
 
 		unsigned int id = 0;
 		std::shared_ptr<ModelAnimationSegment> m_animation;
@@ -308,9 +313,34 @@ namespace animation {
 		static std::map<unsigned int, std::shared_ptr<ModelAnimation>> s_animationById;
 
 	private:
-		struct RunningAnimationList { const ModelAnimationSet* parentSet; std::list<std::shared_ptr<ModelAnimation>> animationList; };
+		struct RunningAnimationList {
+			const ModelAnimationSet* parentSet;
+			std::list<std::shared_ptr<ModelAnimation>> animationList;
+
+			//If all animations were completed or paused when this list was last applied, the times they were applied at and the resulting submodel generation.
+			//As long as neither changes, applying the list again would not change anything.
+			bool idleApplied = false;
+			std::vector<float> idleTimes;
+			uint idleGeneration = 0;
+
+			//The evaluation pass whose buffer at evaluatedIndex holds this list's state. Starting or stopping an animation of the list invalidates it
+			uint evaluatedPass = 0;
+			size_t evaluatedIndex = 0;
+			bool evaluationValid = false;
+
+			bool isIdle(int pmi_id) const;
+			bool needsRecalculation(int pmi_id) const;
+			void updateIdleState(polymodel_instance* pmi);
+			bool isUnchanged(polymodel_instance* pmi) const;
+			void evaluate(float frametime, polymodel_instance* pmi, ModelAnimationSubmodelBuffer& applyBuffer) const;
+			//Removes the animations that aren't running anymore. Returns true if none are left
+			bool removeUntriggered(int pmi_id);
+		};
 		//Polymodel Instance ID -> set + ModelAnimation* list (naturally ordered by beginning time))
 		static std::map<int, RunningAnimationList> s_runningAnimations;
+		//Incremented by every evaluateAnimations, the buffers hold the state of the running instances evaluated in the current pass
+		static uint s_evaluationPass;
+		static std::vector<ModelAnimationSubmodelBuffer> s_evaluatedBuffers;
 
 		std::vector< std::shared_ptr<ModelAnimationSubmodel>> m_submodels;
 		SCP_string m_SIPname;
@@ -328,8 +358,12 @@ namespace animation {
 
 		static void apply(polymodel_instance* pmi, const ModelAnimationSubmodelBuffer& applyBuffer);
 		static void cleanRunning();
+		static void cleanRunning(int pmi_id);
+		static void invalidateEvaluation(int pmi_id);
 
 		void initializeSubmodelBuffer(polymodel_instance* pmi, ModelAnimationSubmodelBuffer& applyBuffer) const;
+		uint getSubmodelGeneration(polymodel_instance* pmi) const;
+		void resetPhysicsData(polymodel_instance* pmi) const;
 
 		friend class ModelAnimation;
 		friend class ModelAnimationParseHelper;
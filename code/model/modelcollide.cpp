@@ -370,28 +370,6 @@ void model_collide_defpoints(ubyte * p)
 	} 
 }
 
-int model_collide_parse_bsp_defpoints(ubyte * p)
-{
-	int n;
-	int nverts = w(p+8);	
-	int offset = w(p+16);	
-
-	ubyte * normcount = p+20;
-	vec3d *src = vp(p+offset);
-
-	model_collide_allocate_point_list(nverts);
-
-	Assert( Mc_point_list != NULL );
-
-	for (n=0; n<nverts; n++ ) {
-		Mc_point_list[n] = src;
-
-		src += normcount[n]+1;
-	} 
-
-	return nverts;
-}
-
 // Flat Poly
 // +0      int         id
 // +4      int         size 
@@ -745,7 +723,11 @@ void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int vers
 
 	Assert(chunk_type == OP_DEFPOINTS);
 
-	int n_verts = model_collide_parse_bsp_defpoints(p);
+	// Read the points directly instead of going through Mc_point_list since the trees may be built on worker threads
+	// during level load
+	int n_verts = w(p+8);
+	ubyte *normcount = p+20;
+	vec3d *points = vp(p+w(p+16));
 
 	if ( n_verts <= 0) {
 		tree->point_list = NULL;
@@ -888,7 +870,9 @@ void model_collide_parse_bsp(bsp_collision_tree *tree, void *model_ptr, int vers
 	tree->point_list = (vec3d*)vm_malloc(sizeof(vec3d) * n_verts);
 
 	for ( i = 0; i < (size_t)n_verts; ++i ) {
-		tree->point_list[i] = *Mc_point_list[i];
+		tree->point_list[i] = *points;
+
+		points += normcount[i]+1;
 	}
 
 	tree->n_verts = n_verts;
@@ -1022,11 +1006,29 @@ bool mc_check_sldc(int offset)
 	return false;
 }
 
+// checks the shield triangles below a node of the shield bounding volume hierarchy
+static void mc_check_shield_bvh(int node_index)
+{
+	shield_bvh_node *node = &Mc_pm->shield.bvh[node_index];
+
+	if (!mc_ray_boundingbox( &node->min, &node->max, &Mc_p0, &Mc_direction, NULL ))	{
+		return;
+	}
+
+	if (node->num_tris > 0) {
+		for (int i = node->first; i < node->first + node->num_tris; i++) {
+			mc_shield_check_common(&Mc_pm->shield.tris[Mc_pm->shield.bvh_tris[i]]);
+		}
+		return;
+	}
+
+	mc_check_shield_bvh(node_index + 1);
+	mc_check_shield_bvh(node->first);
+}
+
 // checks a vector collision against a ships shield (if it has shield points defined).
 void mc_check_shield()
 {
-	int i;
-
 
 	if ( Mc_pm->shield.ntris < 1 )
 		return;
@@ -1034,21 +1036,9 @@ void mc_check_shield()
 	{
 		mc_check_sldc(0); // see if we hit the SLDC
 	}
-	else
+	else if (!Mc_pm->shield.bvh.empty())
 	{
-		int o;
-		for (o=0; o<8; o++ )	{
-			model_octant * poct1 = &Mc_pm->octants[o];
-
-			if (!mc_ray_boundingbox( &poct1->min, &poct1->max, &Mc_p0, &Mc_direction, NULL ))	{
-				continue;
-			}
-			
-			for (i = 0; i < poct1->nshield_tris; i++) {
-				shield_tri	* tri = poct1->shield_tris[i];
-				mc_shield_check_common(tri);
-			}
-		}
+		mc_check_shield_bvh(0);
 	}//model has shield_collsion_tree
 }
 
@@ -1226,6 +1216,7 @@ int model_collide(mc_info *mc_info_obj)
 
 	//Fill in some global variables that all the model collide routines need internally.
 	Mc_pm = model_get(Mc->model_num);
+	model_finish_collision_trees(Mc_pm);
 	Mc_orient = *Mc->orient;
 	Mc_base = *Mc->pos;
 	Mc_mag = vm_vec_dist( Mc->p0, Mc->p1 );
@@ -1271,6 +1271,8 @@ void submodel_get_two_random_points_better(int model_num, int submodel_num, vec3
 			submodel_num = pm->detail[0];
 		}
 
+		model_finish_collision_trees(pm);
+
 		// the Shivan Comm Node does not have a collision tree, for one
 		if (pm->submodel[submodel_num].collision_tree_index < 0) {
 			nprintf(("Model", "In submodel_get_two_random_points_better(), model %s does not have a collision tree!  Falling back to submodel_get_two_random_points().\n", pm->filename));
@@ -1312,6 +1314,8 @@ void submodel_get_cross_sectional_avg_pos(int model_num, int submodel_num, float
 			submodel_num = pm->detail[0];
 		}
 
+		model_finish_collision_trees(pm);
+
 		// the Shivan Comm Node does not have a collision tree, for one
 		if (pm->submodel[submodel_num].collision_tree_index < 0) {
 			nprintf(("Model", "In submodel_get_cross_sectional_avg_pos(), model %s does not have a collision tree!\n", pm->filename));
@@ -1355,6 +1359,8 @@ void submodel_get_cross_sectional_random_pos(int model_num, int submodel_num, fl
 			submodel_num = pm->detail[0];
 		}
 
+		model_finish_collision_trees(pm);
+
 		// the Shivan Comm Node does not have a collision tree, for one
 		if (pm->submodel[submodel_num].collision_tree_index < 0) {
 			nprintf(("Model", "In submodel_get_cross_sectional_random_pos(), model %s does not have a collision tree!\n", pm->filename));
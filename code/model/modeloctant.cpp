@@ -10,6 +10,7 @@
 
 
 
+#include <algorithm>
 #include <cmath>
 
 #define MODEL_LIB
@@ -36,55 +37,93 @@ int point_in_octant( polymodel *  /*pm*/, model_octant * oct, vec3d *vert )
 }
 
 
-void model_octant_find_shields( polymodel * pm, model_octant * oct )
+// Leaves of the shield bounding volume hierarchy hold at most this many triangles
+static const int SHIELD_BVH_MAX_LEAF_TRIS = 4;
+
+// Builds the part of the shield bounding volume hierarchy for the triangles in [start, end) of bvh_tris and returns
+// the index of its root node
+static int shield_bvh_build( shield_info * shield, const SCP_vector<vec3d> &centers, int start, int end )
 {
-	int i, j, n;
-	shield_tri *tri;
+	int node_index = (int)shield->bvh.size();
+	shield->bvh.emplace_back();
+
+	shield_bvh_node node;
+	vec3d center_min, center_max;
+
+	node.min = node.max = shield->verts[shield->tris[shield->bvh_tris[start]].verts[0]].pos;
+	center_min = center_max = centers[shield->bvh_tris[start]];
 
-	n = 0;
-		
-	//	Scan all the triangles in the mesh to find how many tris there are.
-	for (i=0; i<pm->shield.ntris; i++ )	{
+	for (int i = start; i < end; i++ )	{
+		int tri = shield->bvh_tris[i];
 
-		tri = &pm->shield.tris[i];
+		for (int j = 0; j < 3; j++ )	{
+			auto pos = &shield->verts[shield->tris[tri].verts[j]].pos;
 
-		for (j=0; j<3; j++ )	{
-			if ( point_in_octant( pm, oct, &pm->shield.verts[tri->verts[j]].pos ))	{
-				n++;
-				break;
+			for (int axis = 0; axis < 3; axis++ )	{
+				node.min.a1d[axis] = MIN( node.min.a1d[axis], pos->a1d[axis] );
+				node.max.a1d[axis] = MAX( node.max.a1d[axis], pos->a1d[axis] );
 			}
 		}
+
+		for (int axis = 0; axis < 3; axis++ )	{
+			center_min.a1d[axis] = MIN( center_min.a1d[axis], centers[tri].a1d[axis] );
+			center_max.a1d[axis] = MAX( center_max.a1d[axis], centers[tri].a1d[axis] );
+		}
 	}
 
-	//mprintf(( "Octant has %d shield polys in it\n", n ));
+	if ( end - start <= SHIELD_BVH_MAX_LEAF_TRIS )	{
+		node.first = start;
+		node.num_tris = end - start;
+	} else {
+		// split at the median along the axis in which the triangles are spread out the most
+		int split_axis = 0;
+		for (int axis = 1; axis < 3; axis++ )	{
+			if ( center_max.a1d[axis] - center_min.a1d[axis] > center_max.a1d[split_axis] - center_min.a1d[split_axis] )
+				split_axis = axis;
+		}
 
-	oct->nshield_tris = n;
+		int mid = (start + end) / 2;
+		std::nth_element( shield->bvh_tris.begin() + start, shield->bvh_tris.begin() + mid, shield->bvh_tris.begin() + end,
+			[&centers, split_axis](int a, int b) { return centers[a].a1d[split_axis] < centers[b].a1d[split_axis]; } );
 
-	// if we don't have any shield polys then don't bother continuing - taylor
-	if (oct->nshield_tris <= 0) {
-		oct->shield_tris = NULL;
-		return;
+		// the first child directly follows this node
+		shield_bvh_build( shield, centers, start, mid );
+
+		node.first = shield_bvh_build( shield, centers, mid, end );
+		node.num_tris = 0;
 	}
 
-	oct->shield_tris = (shield_tri **)vm_malloc( sizeof(shield_tri *) * oct->nshield_tris );
-	Assert(oct->shield_tris!=NULL);
+	shield->bvh[node_index] = node;
+
+	return node_index;
+}
+
+// Creates the bounding volume hierarchy over the shield triangles
+//
+// The hull faces are left out on purpose.  Collisions with the hull already walk the bounding box trees which
+// model_collide_parse_bsp() builds for every submodel, and the octants only keep the hull vertices for picking AI
+// attack points and beam targets, which never search the faces.
+static void model_shield_bvh_create( polymodel * pm )
+{
+	shield_info *shield = &pm->shield;
+
+	shield->bvh.clear();
+	shield->bvh_tris.clear();
 
-	n = 0;
-		
-	//	Rescan all the triangles in the mesh.
-	for (i=0; i<pm->shield.ntris; i++ )	{
+	if ( shield->ntris <= 0 )
+		return;
 
-		tri = &pm->shield.tris[i];
+	SCP_vector<vec3d> centers(shield->ntris);
 
-		for (j=0; j<3; j++ )	{
-			if ( point_in_octant( pm, oct, &pm->shield.verts[tri->verts[j]].pos ))	{
-				oct->shield_tris[n++] = tri;
-				break;
-			}
-		}
+	for (int i = 0; i < shield->ntris; i++ )	{
+		auto tri = &shield->tris[i];
+
+		vm_vec_avg3( &centers[i], &shield->verts[tri->verts[0]].pos, &shield->verts[tri->verts[1]].pos, &shield->verts[tri->verts[2]].pos );
+		shield->bvh_tris.push_back(i);
 	}
 
-	Assert( oct->nshield_tris == n );
+	shield->bvh.reserve( 2 * shield->ntris / SHIELD_BVH_MAX_LEAF_TRIS + 1 );
+	shield_bvh_build( shield, centers, 0, shield->ntris );
 }
 
     
@@ -351,11 +390,13 @@ void model_octant_create( polymodel * pm )
 			pm->octants[i].min.xyz.z = min.xyz.z;
 		}
 
-		model_octant_find_shields( pm, &pm->octants[i] );
 		model_octant_find_faces( pm, &pm->octants[i] );
 
 	}
-	
+
+	// shields don't use the octants since a large shield puts thousands of triangles into each of them
+	if ( !pm->shield_collision_tree )
+		model_shield_bvh_create( pm );
 }
 
 
@@ -372,12 +413,10 @@ void model_octant_free( polymodel * pm )
 			oct->verts = NULL;
 		}
 
-		if ( oct->shield_tris )	{
-			vm_free( oct->shield_tris );
-			oct->shield_tris = NULL;
-		}
+	}
 
-	}	
+	pm->shield.bvh.clear();
+	pm->shield.bvh_tris.clear();
 }
 
 
@@ -31,6 +31,7 @@
 #include "math/fvi.h"
 #include "math/vecmat.h"
 #include "model/model.h"
+#include "model/model_cache.h"
 #include "model/modelsinc.h"
 #include "parse/parselo.h"
 #include "render/3dinternal.h"
@@ -38,6 +39,7 @@
 #include "starfield/starfield.h"
 #include "weapon/weapon.h"
 #include "tracing/tracing.h"
+#include "utils/ThreadPool.h"
 
 #include <algorithm>
 #include <stack>
@@ -74,6 +76,131 @@ int ss_warning_shown = 0;		// have we shown the warning dialog concerning the su
 
 static uint Global_checksum = 0;
 
+// Models read from POF files with the same contents (e.g. the same file loaded with the duplicate flag or a copy under
+// another name) share their bsp data and collision trees.  These count the models using each shared piece of data;
+// anything not in here belongs to a single model.
+static SCP_unordered_map<const ubyte*, int> Model_shared_bsp_data_refs;
+static SCP_unordered_map<int, int> Model_shared_collision_tree_refs;
+
+template <typename T>
+static void model_add_shared_ref(SCP_unordered_map<T, int>& refs, T key)
+{
+	auto& count = refs[key];
+	count = (count == 0) ? 2 : count + 1;
+}
+
+// Returns true if another model still uses the data, in which case it must not be freed
+template <typename T>
+static bool model_release_shared_ref(SCP_unordered_map<T, int>& refs, T key)
+{
+	auto it = refs.find(key);
+	if (it == refs.end()) {
+		return false;
+	}
+
+	if (--it->second <= 1) {
+		refs.erase(it);
+	}
+	return true;
+}
+
+// Finds another loaded model which was read from a POF file with the same contents
+static polymodel *model_find_same_pof(const polymodel *pm)
+{
+	for (auto other : Polygon_models) {
+		if (other != nullptr && other != pm && other->pof_checksum == pm->pof_checksum && other->pof_size == pm->pof_size && other->n_models == pm->n_models) {
+			return other;
+		}
+	}
+
+	return nullptr;
+}
+
+// Uses the collision trees of a model with the same POF contents, returns false if they don't match up
+static bool model_share_collision_trees(polymodel *pm, polymodel *source)
+{
+	model_finish_collision_trees(source);
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		bool needs_tree = !pm->submodel[i].flags[Model::Submodel_flags::Nocollide_this_only, Model::Submodel_flags::No_collisions];
+
+		if (needs_tree != (source->submodel[i].collision_tree_index >= 0)) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < pm->n_models; ++i) {
+		int tree_index = source->submodel[i].collision_tree_index;
+
+		if (tree_index >= 0) {
+			pm->submodel[i].collision_tree_index = tree_index;
+			model_add_shared_ref(Model_shared_collision_tree_refs, tree_index);
+		}
+	}
+
+	return true;
+}
+
+// While a level is loading, the collision trees of newly loaded models are built on worker threads so that the main
+// thread can continue with the next model.  The trees are handed to the model once it is used or the level is loaded.
+struct model_collision_job {
+	model_cache_key cache_key;
+	std::future<SCP_vector<std::pair<int, bsp_collision_tree>>> trees;
+};
+
+static std::unique_ptr<util::ThreadPool> Model_page_in_pool;
+static SCP_unordered_map<int, model_collision_job> Model_collision_jobs;	// indexed by polymodel id
+
+// Builds the collision trees of the given submodels.  Only reads the bsp data, so this can run on a worker thread.
+static SCP_vector<std::pair<int, bsp_collision_tree>> model_build_collision_trees(const SCP_vector<std::pair<int, const ubyte*>>& bsp_submodels, int version)
+{
+	SCP_vector<std::pair<int, bsp_collision_tree>> trees;
+	trees.reserve(bsp_submodels.size());
+
+	for (auto& submodel : bsp_submodels) {
+		bsp_collision_tree tree;
+		model_collide_parse_bsp(&tree, const_cast<ubyte*>(submodel.second), version);
+		tree.used = true;
+
+		trees.emplace_back(submodel.first, tree);
+	}
+
+	return trees;
+}
+
+// Hands the built collision trees to the submodels and stores them in the model cache
+static void model_assign_collision_trees(polymodel *pm, const SCP_vector<std::pair<int, bsp_collision_tree>>& trees, const model_cache_key& cache_key)
+{
+	for (auto& entry : trees) {
+		int tree_index = model_create_bsp_collision_tree();
+		*model_get_bsp_collision_tree(tree_index) = entry.second;
+
+		pm->submodel[entry.first].collision_tree_index = tree_index;
+	}
+
+	if (model_cache_enabled()) {
+		model_cache_write(cache_key, pm);
+	}
+}
+
+void model_finish_collision_trees(polymodel *pm)
+{
+	if (Model_collision_jobs.empty()) {
+		return;
+	}
+
+	auto job = Model_collision_jobs.find(pm->id);
+	if (job == Model_collision_jobs.end()) {
+		return;
+	}
+
+	auto trees = job->second.trees.get();
+	auto cache_key = job->second.cache_key;
+	Model_collision_jobs.erase(job);
+
+	model_assign_collision_trees(pm, trees, cache_key);
+}
+
 // Anything less than this is considered incompatible.
 #define PM_COMPATIBLE_VERSION 1900
 
@@ -192,6 +319,9 @@ void model_unload(int modelnum, int force)
 
 	Assert( pm->used_this_mission >= 0 );
 
+	// a worker may still be reading the bsp data
+	model_finish_collision_trees(pm);
+
 	if (!force && (--pm->used_this_mission > 0))
 		return;
 
@@ -276,11 +406,11 @@ void model_unload(int modelnum, int force)
 		for (i = 0; i < pm->n_models; i++) {
 			pm->submodel[i].buffer.clear();
 
-			if ( pm->submodel[i].bsp_data )	{
+			if ( pm->submodel[i].bsp_data && !model_release_shared_ref<const ubyte*>(Model_shared_bsp_data_refs, pm->submodel[i].bsp_data) )	{
 				vm_free(pm->submodel[i].bsp_data);
 			}
 
-			if ( pm->submodel[i].collision_tree_index >= 0 ) {
+			if ( pm->submodel[i].collision_tree_index >= 0 && !model_release_shared_ref(Model_shared_collision_tree_refs, pm->submodel[i].collision_tree_index) ) {
 				model_remove_bsp_collision_tree(pm->submodel[i].collision_tree_index);
 			}
 
@@ -413,6 +543,10 @@ void model_page_in_start()
 {
 	int i;
 
+	if (Cmdline_page_in_threads > 0 && !Model_page_in_pool) {
+		Model_page_in_pool.reset(new util::ThreadPool(Cmdline_page_in_threads));
+	}
+
 	if ( !model_initted ) {
 		model_init();
 		return;
@@ -434,6 +568,14 @@ void model_page_in_stop()
 
 	mprintf(( "Stopping model page in...\n" ));
 
+	for (i=0; i<MAX_POLYGON_MODELS; i++) {
+		if (Polygon_models[i] != NULL)
+			model_finish_collision_trees(Polygon_models[i]);
+	}
+
+	Assert( Model_collision_jobs.empty() );
+	Model_page_in_pool.reset();
+
 	for (i=0; i<MAX_POLYGON_MODELS; i++) {
 		if (Polygon_models[i] == NULL)
 			continue;
@@ -458,6 +600,10 @@ void model_init()
 		Polygon_models[i] = NULL;
 	}
 
+	if (model_cache_enabled()) {
+		model_cache_purge_old();
+	}
+
 	model_initted = 1;
 }
 
@@ -1414,6 +1560,9 @@ int read_model_file(polymodel * pm, const char *filename, int n_subsystems, mode
 	cf_chksum_long(fp, &Global_checksum);
 	cfseek(fp, 0, SEEK_SET);
 
+	pm->pof_checksum = Global_checksum;
+	pm->pof_size = cfilelength(fp);
+
 
 	// code to get a filename to write out subsystem information for each model that
 	// is read.  This info is essentially debug stuff that is used to help get models
@@ -1890,8 +2039,23 @@ int read_model_file(polymodel * pm, const char *filename, int n_subsystems, mode
 					}
 				}
 
+				// if the same file contents are already loaded, use their bsp data instead of reading it again
+				auto same_pm = model_find_same_pof(pm);
+
+				if (same_pm != nullptr && same_pm->version == pm->version)
+				{
+					int bsp_data_size = cfread_int(fp);
+					cfseek(fp, bsp_data_size, CF_SEEK_CUR);
+
+					sm->bsp_data_size = same_pm->submodel[n].bsp_data_size;
+					sm->bsp_data = same_pm->submodel[n].bsp_data;
+
+					if (sm->bsp_data != nullptr) {
+						model_add_shared_ref<const ubyte*>(Model_shared_bsp_data_refs, sm->bsp_data);
+					}
+				}
 				//ShivanSpS - if pof version is 2200 or higher load bsp_data as it is, otherwise, align it
-				if (pm->version >= 2200)
+				else if (pm->version >= 2200)
 				{
 					sm->bsp_data_size = cfread_int(fp);
 					if (sm->bsp_data_size > 0) {
@@ -3171,11 +3335,33 @@ int model_load(const  char *filename, int n_subsystems, model_subsystem *subsyst
 
 	TRACE_SCOPE(tracing::ModelParseAllBSPTrees);
 
-	for (i = 0; i < pm->n_models; ++i) {
-		if (!pm->submodel[i].flags[Model::Submodel_flags::Nocollide_this_only, Model::Submodel_flags::No_collisions]) {
-			pm->submodel[i].collision_tree_index = model_create_bsp_collision_tree();
-			bsp_collision_tree* tree             = model_get_bsp_collision_tree(pm->submodel[i].collision_tree_index);
-			model_collide_parse_bsp(tree, pm->submodel[i].bsp_data, pm->version);
+	// the collision trees only depend on the POF data, so they can be reused from the last time this file was loaded
+	model_cache_key cache_key;
+	cache_key.pof_checksum = pm->pof_checksum;
+	cache_key.pof_size = pm->pof_size;
+	cache_key.pof_version = pm->version;
+
+	auto same_pm = model_find_same_pof(pm);
+
+	if (same_pm != nullptr && same_pm->version == pm->version && model_share_collision_trees(pm, same_pm)) {
+		nprintf(("Model", "Model '%s' shares its collision trees with '%s'\n", pm->filename, same_pm->filename));
+	} else if (!model_cache_enabled() || !model_cache_read(cache_key, pm)) {
+		SCP_vector<std::pair<int, const ubyte*>> bsp_submodels;
+
+		for (i = 0; i < pm->n_models; ++i) {
+			if (!pm->submodel[i].flags[Model::Submodel_flags::Nocollide_this_only, Model::Submodel_flags::No_collisions]) {
+				bsp_submodels.emplace_back(i, pm->submodel[i].bsp_data);
+			}
+		}
+
+		if (Model_page_in_pool) {
+			auto& job = Model_collision_jobs[pm->id];
+			int version = pm->version;
+
+			job.cache_key = cache_key;
+			job.trees = Model_page_in_pool->submit([bsp_submodels, version]() { return model_build_collision_trees(bsp_submodels, version); });
+		} else {
+			model_assign_collision_trees(pm, model_build_collision_trees(bsp_submodels, pm->version), cache_key);
 		}
 	}
 
@@ -3234,8 +3420,10 @@ int model_create_instance(int objnum, int model_num)
 	}
 	pmi->id = open_slot;
 
-	if (pm->n_models > 0)
+	if (pm->n_models > 0) {
 		pmi->submodel = new submodel_instance[pm->n_models];
+		pmi->transforms = new submodel_transform[pm->n_models];
+	}
 
 	// add intrinsic_motion instances if this model is intrinsic-moving
 	if (pm->flags & PM_FLAG_HAS_INTRINSIC_MOTION) {
@@ -3273,6 +3461,11 @@ void model_delete_instance(int model_instance_num)
 		pmi->submodel = nullptr;
 	}
 
+	if ( pmi->transforms ) {
+		delete[] pmi->transforms;
+		pmi->transforms = nullptr;
+	}
+
 	delete pmi;
 
 	Polygon_model_instances[model_instance_num] = nullptr;
@@ -3750,6 +3943,8 @@ void submodel_canonicalize(bsp_info *sm, submodel_instance *smi, bool clamp)
 			vm_quaternion_rotate(&smi->canonical_orient, smi->cur_angle, &sm->rotation_axis);
 			break;
 	}
+
+	smi->orient_generation++;
 }
 
 // Does stepped rotation of a submodel
@@ -4001,6 +4196,7 @@ int model_rotate_gun(object *objp, polymodel *pm, polymodel_instance *pmi, ship_
 		// Pretend the base is pointing directly at the target
 		save_base_orient = base_smi->canonical_orient;
 		vm_quaternion_rotate(&base_smi->canonical_orient, desired_base_angle, &base_sm->rotation_axis);
+		base_smi->orient_generation++;
 
 		//------------
 		// Project the destination point onto the turret gun plane with the base in the desired orientation
@@ -4024,6 +4220,7 @@ int model_rotate_gun(object *objp, polymodel *pm, polymodel_instance *pmi, ship_
 		//------------
 		// Restore the base
 		base_smi->canonical_orient = save_base_orient;
+		base_smi->orient_generation++;
 
 	} else {
 		desired_base_angle = base_smi->turret_idle_angle;
@@ -4139,6 +4336,37 @@ void model_instance_local_to_global_point(vec3d *outpnt, const vec3d *mpnt, int
 	return model_instance_local_to_global_point(outpnt, mpnt, pm, pmi, submodel_num, objorient, objpos, use_last_frame);
 }
 
+// Gets the transform from the submodel's frame of reference to the model's frame of reference, recalculating it
+// if the submodel or any of its parents was rotated since it was last cached.  Returns nullptr if the instance
+// has no transform cache.
+static const submodel_transform *model_instance_get_transform(const polymodel *pm, const polymodel_instance *pmi, int submodel_num)
+{
+	if (pmi->transforms == nullptr)
+		return nullptr;
+
+	auto transform = &pmi->transforms[submodel_num];
+	int parent = pm->submodel[submodel_num].parent;
+
+	// the orientation of the root submodel is never applied, so its transform is always the identity
+	if (parent < 0)
+		return transform;
+
+	auto parent_transform = model_instance_get_transform(pm, pmi, parent);
+	auto smi = &pmi->submodel[submodel_num];
+	uint generation = parent_transform->generation + smi->orient_generation;
+
+	if (!transform->valid || transform->generation != generation) {
+		transform->orient = smi->canonical_orient * parent_transform->orient;
+		vm_vec_unrotate(&transform->offset, &pm->submodel[submodel_num].offset, &parent_transform->orient);
+		vm_vec_add2(&transform->offset, &parent_transform->offset);
+
+		transform->generation = generation;
+		transform->valid = true;
+	}
+
+	return transform;
+}
+
 void model_instance_local_to_global_point(vec3d *outpnt, const vec3d *mpnt, const polymodel *pm, const polymodel_instance *pmi, int submodel_num, const matrix *objorient, const vec3d *objpos, bool use_last_frame)
 {
 	vec3d pnt;
@@ -4149,12 +4377,18 @@ void model_instance_local_to_global_point(vec3d *outpnt, const vec3d *mpnt, cons
 	pnt = *mpnt;
 	mn = submodel_num;
 
-	//instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		vm_vec_unrotate(&tpnt, &pnt, use_last_frame ? &pmi->submodel[mn].canonical_prev_orient : &pmi->submodel[mn].canonical_orient);
-		vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
+	const submodel_transform *transform;
+	if ( !use_last_frame && (mn >= 0) && (transform = model_instance_get_transform(pm, pmi, mn)) != nullptr ) {
+		vm_vec_unrotate(&tpnt, &pnt, &transform->orient);
+		vm_vec_add(&pnt, &tpnt, &transform->offset);
+	} else {
+		//instance up the tree for this point
+		while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
+			vm_vec_unrotate(&tpnt, &pnt, use_last_frame ? &pmi->submodel[mn].canonical_prev_orient : &pmi->submodel[mn].canonical_orient);
+			vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
 
-		mn = pm->submodel[mn].parent;
+			mn = pm->submodel[mn].parent;
+		}
 	}
 
 	//now instance for the entire object
@@ -4176,15 +4410,24 @@ void model_instance_local_to_global_point_dir(vec3d *out_pnt, vec3d *out_dir, co
 	dir = *in_dir;
 	mn = submodel_num;
 
-	// instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
-		vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
+	const submodel_transform *transform;
+	if ( (mn >= 0) && (transform = model_instance_get_transform(pm, pmi, mn)) != nullptr ) {
+		vm_vec_unrotate(&tpnt, &pnt, &transform->orient);
+		vm_vec_add(&pnt, &tpnt, &transform->offset);
 
-		vm_vec_unrotate(&tdir, &dir, &pmi->submodel[mn].canonical_orient);
+		vm_vec_unrotate(&tdir, &dir, &transform->orient);
 		dir = tdir;
+	} else {
+		// instance up the tree for this point
+		while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
+			vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
+			vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
 
-		mn = pm->submodel[mn].parent;
+			vm_vec_unrotate(&tdir, &dir, &pmi->submodel[mn].canonical_orient);
+			dir = tdir;
+
+			mn = pm->submodel[mn].parent;
+		}
 	}
 
 	// now instance for the entire object
@@ -4210,14 +4453,22 @@ void model_instance_local_to_global_point_orient(vec3d *outpnt, matrix *outorien
 	orient = *submodel_orient;
 	mn = submodel_num;
 
-	// instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
-		vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
+	const submodel_transform *transform;
+	if ( (mn >= 0) && (transform = model_instance_get_transform(pm, pmi, mn)) != nullptr ) {
+		vm_vec_unrotate(&tpnt, &pnt, &transform->orient);
+		vm_vec_add(&pnt, &tpnt, &transform->offset);
 
-		orient = orient * pmi->submodel[mn].canonical_orient;
+		orient = orient * transform->orient;
+	} else {
+		// instance up the tree for this point
+		while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
+			vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
+			vm_vec_add(&pnt, &tpnt, &pm->submodel[mn].offset);
 
-		mn = pm->submodel[mn].parent;
+			orient = orient * pmi->submodel[mn].canonical_orient;
+
+			mn = pm->submodel[mn].parent;
+		}
 	}
 
 	// now instance for the entire object
@@ -4241,6 +4492,20 @@ void model_instance_global_to_local_point(vec3d* outpnt, const vec3d* mpnt, int
 void model_instance_global_to_local_point(vec3d* outpnt, const vec3d* mpnt, const polymodel* pm, const polymodel_instance* pmi, int submodel_num, const matrix* objorient, const vec3d* objpos, bool use_last_frame) {
 	Assert(pm->id == pmi->model_num);
 
+	const submodel_transform* transform;
+	if (!use_last_frame && (transform = model_instance_get_transform(pm, pmi, submodel_num)) != nullptr) {
+		vec3d resultPnt = *mpnt;
+
+		if (objorient != nullptr && objpos != nullptr) {
+			vm_vec_sub2(&resultPnt, objpos);
+			vm_vec_rotate(&resultPnt, &resultPnt, objorient);
+		}
+
+		vm_vec_sub2(&resultPnt, &transform->offset);
+		vm_vec_rotate(outpnt, &resultPnt, &transform->orient);
+		return;
+	}
+
 	constexpr int preallocatedStackDepth = 5;
 	std::pair<const matrix*, const vec3d*> preallocatedStack[preallocatedStackDepth];
 
@@ -4289,6 +4554,17 @@ void model_instance_global_to_local_dir(vec3d* out_dir, const vec3d* in_dir, int
 void model_instance_global_to_local_dir(vec3d* out_dir, const vec3d* in_dir, const polymodel* pm, const polymodel_instance* pmi, int submodel_num, const matrix* objorient, bool use_last_frame) {
 	Assert(pm->id == pmi->model_num);
 
+	const submodel_transform* transform;
+	if (!use_last_frame && (transform = model_instance_get_transform(pm, pmi, submodel_num)) != nullptr) {
+		vec3d resultDir = *in_dir;
+
+		if (objorient != nullptr)
+			vm_vec_rotate(&resultDir, &resultDir, objorient);
+
+		vm_vec_rotate(out_dir, &resultDir, &transform->orient);
+		return;
+	}
+
 	constexpr int preallocatedStackDepth = 5;
 	const matrix* preallocatedStack[preallocatedStackDepth];
 
@@ -4461,12 +4737,18 @@ void model_instance_local_to_global_dir(vec3d *out_dir, const vec3d *in_dir, con
 	pnt = *in_dir;
 	mn = submodel_num;
 
-	// instance up the tree for this point
-	while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
-		vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
+	const submodel_transform *transform;
+	if ( (mn >= 0) && (transform = model_instance_get_transform(pm, pmi, mn)) != nullptr ) {
+		vm_vec_unrotate(&tpnt, &pnt, &transform->orient);
 		pnt = tpnt;
+	} else {
+		// instance up the tree for this point
+		while ( (mn >= 0) && (pm->submodel[mn].parent >= 0) ) {
+			vm_vec_unrotate(&tpnt, &pnt, &pmi->submodel[mn].canonical_orient);
+			pnt = tpnt;
 
-		mn = pm->submodel[mn].parent;
+			mn = pm->submodel[mn].parent;
+		}
 	}
 
 	// now instance for the entire object
@@ -4556,6 +4838,7 @@ void model_replicate_submodel_instance_sub(polymodel *pm, polymodel_instance *pm
 				r_smi->canonical_orient = smi->canonical_orient;
 				r_smi->canonical_prev_orient = smi->canonical_prev_orient;
 			}
+			r_smi->orient_generation++;
 		}
 	} else {
 		// If submodel isn't yet blown off and has a -destroyed replacement model, we prevent
@@ -4571,6 +4854,7 @@ void model_replicate_submodel_instance_sub(polymodel *pm, polymodel_instance *pm
 		smi->cur_angle = copy_from->cur_angle;
 		smi->canonical_orient = copy_from->canonical_orient;
 		smi->canonical_prev_orient = copy_from->canonical_prev_orient;
+		smi->orient_generation++;
 	}
 
 	// For all the detail levels of this submodel, set them also.
@@ -1240,6 +1240,13 @@ void model_render_buffers(model_draw_list* scene, model_material *rendering_mate
 			rendering_material->set_texture_map(TM_HEIGHT_TYPE, texture_maps[TM_HEIGHT_TYPE]);
 			rendering_material->set_texture_map(TM_AMBIENT_TYPE, texture_maps[TM_AMBIENT_TYPE]);
 			rendering_material->set_texture_map(TM_MISC_TYPE,	texture_maps[TM_MISC_TYPE]);
+
+			// close enough that the full resolution of streamed textures is visible
+			if (detail_level < 2) {
+				for (auto texture : texture_maps) {
+					bm_request_full_mipmaps(texture);
+				}
+			}
 		}
 
 		scene->add_buffer_draw(rendering_material, &pm->vert_source, buffer, i, tmap_flags);
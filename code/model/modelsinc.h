@@ -73,7 +73,7 @@ class polymodel;
 
 extern int model_interp(matrix * orient, ubyte * data, polymodel * pm );
 
-// Creates the octants for a given polygon model
+// Creates the octants and the shield bounding volume hierarchy for a given polygon model
 void model_octant_create( polymodel * pm );
 
 // frees the memory the octants use for a given polygon model
@@ -1997,12 +1997,14 @@ int multi_oo_unpack_data(net_player* pl, ubyte* data, int seq_num)
 				if (flags[i] & OO_SUBSYS_ROTATION_1) {
 					vm_angles_2_matrix(&subsysp->submodel_instance_1->canonical_prev_orient, prev_angs_1);
 					vm_angles_2_matrix(&subsysp->submodel_instance_1->canonical_orient, angs_1);
+					subsysp->submodel_instance_1->orient_generation++;
 					delete prev_angs_1;
 					delete angs_1;
 				}
 				if (flags[i] & OO_SUBSYS_ROTATION_2) {
 					vm_angles_2_matrix(&subsysp->submodel_instance_2->canonical_prev_orient, prev_angs_2);
 					vm_angles_2_matrix(&subsysp->submodel_instance_2->canonical_orient, angs_2);
+					subsysp->submodel_instance_2->orient_generation++;
 					delete prev_angs_2;
 					delete angs_2;
 				}
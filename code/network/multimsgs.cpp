@@ -8512,6 +8512,8 @@ void process_event_update_packet(ubyte *data, header *hinfo)
 	GET_INT(Mission_events[u_event].count);
 	PACKET_SET_SIZE();
 
+	sexp_state_changed(SEXP_DEP_EVENTS);
+
 	// went from non directive special to directive special
 	if(!(store_flags & MEF_DIRECTIVE_SPECIAL) && (Mission_events[u_event].flags & MEF_DIRECTIVE_SPECIAL)){
 		mission_event_set_directive_special(u_event);
@@ -8572,6 +8574,7 @@ void process_variable_update_packet( ubyte *data, header *hinfo)
 	if ( (variable_index >= 0) && (variable_index < sexp_variable_count()) )
 	{
 		strcpy_s(Sexp_variables[variable_index].text, value); 
+		sexp_state_changed(SEXP_DEP_VARIABLES);
 	}	
 
 	// send the packet on to all clients. 
@@ -32,6 +32,7 @@
 #include "network/stand_gui.h"
 #include "network/multiteamselect.h"
 #include "mission/missioncampaign.h"
+#include "mission/mission_index.h"
 #include "mission/missionload.h"
 #include "graphics/font.h"
 #include "io/mouse.h"
@@ -4511,7 +4512,16 @@ void multi_create_list_load_missions()
 		// activate tstrings check
 		Lcl_unexpected_tstring_check = &lcl_weirdness;
 
-		flags = mission_parse_is_multi(filename, mission_name);
+		mission_index_info index_info;
+		bool use_index = mission_index_enabled();
+
+		if (use_index) {
+			mission_index_get_mission(filename, &index_info);
+			flags = index_info.multi_game_type;
+			strcpy_s(mission_name, index_info.name.c_str());
+		} else {
+			flags = mission_parse_is_multi(filename, mission_name);
+		}
 
 		// maybe log
 		if (lcl_weirdness)
@@ -4522,8 +4532,13 @@ void multi_create_list_load_missions()
 
 		// if the mission is a multiplayer mission, and we can list it, then add it to the mission list
 		if (flags && !mission_is_ignored(filename) && !lcl_weirdness) {
-			max_players = mission_parse_get_multi_mission_info( filename );
-			m_respawn = The_mission.num_respawns;
+			if (use_index) {
+				max_players = index_info.num_players;
+				m_respawn = (uint)index_info.num_respawns;
+			} else {
+				max_players = mission_parse_get_multi_mission_info( filename );
+				m_respawn = The_mission.num_respawns;
+			}
 
 			multi_create_info mcip;
 
@@ -4556,6 +4571,10 @@ void multi_create_list_load_missions()
 
 	Multi_create_slider.set_numberItems(int(Multi_create_mission_list.size()) > gr_get_dynamic_font_lines(Multi_create_list_max_display[gr_screen.res]) ? int(Multi_create_mission_list.size())-gr_get_dynamic_font_lines(Multi_create_list_max_display[gr_screen.res]) : 0);
 
+	if (mission_index_enabled()) {
+		mission_index_save();
+	}
+
 	// maybe create a standalone dialog
 	if (Game_mode & GM_STANDALONE_SERVER) {
 		std_destroy_gen_dialog();		
@@ -4603,10 +4622,32 @@ void multi_create_list_load_campaigns()
 			std_gen_set_text(filename, 2);
 		}
 
-		flags = mission_campaign_parse_is_multi( filename, name );
+		campaign_index_info index_info;
+		bool use_index = mission_index_enabled();
+		bool valid = true;
+
+		if (use_index) {
+			// an invalid campaign is dropped just like mission_campaign_get_info() failing drops it below
+			valid = mission_index_get_campaign(filename, &index_info);
+			flags = valid ? index_info.type : -1;
+			if (valid) {
+				strcpy_s(name, index_info.name.c_str());
+			}
+		} else {
+			flags = mission_campaign_parse_is_multi( filename, name );
+		}
 
 		// if the campaign is a multiplayer campaign, and we can list it, and we can get its info, then add the data to the campaign list items
-		if( flags != CAMPAIGN_TYPE_SINGLE && !campaign_is_ignored(filename) && mission_campaign_get_info(filename, title, &campaign_type, &max_players)) {
+		bool listed = valid && (flags != CAMPAIGN_TYPE_SINGLE) && !campaign_is_ignored(filename);
+		if (listed) {
+			if (use_index) {
+				max_players = index_info.max_players;
+			} else {
+				listed = mission_campaign_get_info(filename, title, &campaign_type, &max_players) != 0;
+			}
+		}
+
+		if (listed) {
 			multi_create_info mcip;
 
 			strcpy_s(mcip.filename, filename );
@@ -4648,6 +4689,10 @@ void multi_create_list_load_campaigns()
 		file_list = NULL;
 	}
 
+	if (mission_index_enabled()) {
+		mission_index_save();
+	}
+
 	// maybe create a standalone dialog
 	if (Game_mode & GM_STANDALONE_SERVER) {
 		std_destroy_gen_dialog();		
@@ -1444,6 +1444,9 @@ void obj_move_all(float frametime)
 
 	MONITOR_INC( NumObjects, Num_objects );	
 
+	// step the running submodel animations of all objects at once; each object applies its own below
+	animation::ModelAnimation::evaluateAnimations(frametime);
+
 	for (objp = GET_FIRST(&obj_used_list); objp != END_OF_LIST(&obj_used_list); objp = GET_NEXT(objp)) {
 		// skip objects which should be dead
 		if (objp->flags[Object::Object_Flags::Should_be_dead]) {
@@ -1507,7 +1510,7 @@ void obj_move_all(float frametime)
 		int model_instance_num = object_get_model_instance(objp);
 		if (model_instance_num > -1) {
 			polymodel_instance* pmi = model_get_instance(model_instance_num);
-			animation::ModelAnimation::stepAnimations(frametime, pmi);
+			animation::ModelAnimation::applyAnimations(frametime, pmi);
 		}
 
 		// finally, do intrinsic motion on this object
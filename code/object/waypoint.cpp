@@ -9,6 +9,11 @@
 //********************GLOBALS********************
 SCP_list<waypoint_list> Waypoint_lists;
 
+// Waypoint lists by name.  This is rebuilt on the next lookup whenever a list is added, removed or renamed.  Since
+// FRED edits the names directly it always searches Waypoint_lists instead.
+static SCP_unordered_map<SCP_string, waypoint_list*, SCP_string_lcase_hash, SCP_string_lcase_equal_to> Waypoint_list_index;
+static bool Waypoint_list_index_valid = false;
+
 // In order to restore ai_info to a plain-old-data struct, ai_info->wp_index
 // now uses size_t rather than iterator to index into the list.  If ai_info
 // eventually becomes an actual class, we ought to go back to using iterators.
@@ -96,17 +101,20 @@ void waypoint_list::set_name(const char *name)
 {
 	Assert(name != NULL);
 	strcpy_s(this->m_name, name);
+	Waypoint_list_index_valid = false;
 }
 
 //********************FUNCTIONS********************
 void waypoint_parse_init()
 {
 	Waypoint_lists.clear();
+	Waypoint_list_index_valid = false;
 }
 
 void waypoint_level_close()
 {
 	Waypoint_lists.clear();
+	Waypoint_list_index_valid = false;
 }
 
 int calc_waypoint_instance(int waypoint_list_index, int waypoint_index)
@@ -170,6 +178,23 @@ waypoint_list *find_matching_waypoint_list(const char *name)
 	Assert(name != NULL);
 	SCP_list<waypoint_list>::iterator ii;
 
+	if (!Fred_running)
+	{
+		if (!Waypoint_list_index_valid)
+		{
+			Waypoint_list_index.clear();
+
+			// the first list with a name wins, just like in the search below
+			for (ii = Waypoint_lists.begin(); ii != Waypoint_lists.end(); ++ii)
+				Waypoint_list_index.emplace(ii->get_name(), &(*ii));
+
+			Waypoint_list_index_valid = true;
+		}
+
+		auto it = Waypoint_list_index.find(name);
+		return (it == Waypoint_list_index.end()) ? NULL : it->second;
+	}
+
 	for (ii = Waypoint_lists.begin(); ii != Waypoint_lists.end(); ++ii)
 	{
 		if (!stricmp(ii->get_name(), name))
@@ -387,6 +412,7 @@ void waypoint_add_list(const char *name, SCP_vector<vec3d> &vec_list)
 
 	waypoint_list new_list(name);
 	Waypoint_lists.push_back(new_list);
+	Waypoint_list_index_valid = false;
 	waypoint_list *wp_list = &Waypoint_lists.back();
 
 	wp_list->get_waypoints().reserve(vec_list.size());
@@ -419,6 +445,7 @@ int waypoint_add(vec3d *pos, int waypoint_instance)
 		// add new list with that name
 		waypoint_list new_list(buf);
 		Waypoint_lists.push_back(new_list);
+		Waypoint_list_index_valid = false;
 		wp_list = &Waypoint_lists.back();
 
 		// set up references
@@ -484,6 +511,7 @@ void waypoint_remove(waypoint *wpt)
 		if (Waypoint_lists.size() == 1)
 		{
 			Waypoint_lists.clear();
+			Waypoint_list_index_valid = false;
 		}
 		// shift the other waypoint lists down
 		else
@@ -496,6 +524,7 @@ void waypoint_remove(waypoint *wpt)
 				if (i == this_list)
 				{
 					Waypoint_lists.erase(ii);
+					Waypoint_list_index_valid = false;
 					break;
 				}
 			}
@@ -19,14 +19,18 @@
 #include "localization/fhash.h"
 #include "localization/localize.h"
 #include "mission/missionparse.h"
+#include "cfile/cfilecompression.h"
+#include "cmdline/cmdline.h"
 #include "parse/encrypt.h"
 #include "parse/parselo.h"
 #include "parse/sexp.h"
+#include "parse/table_cache.h"
 #include "ship/ship.h"
 #include "weapon/weapon.h"
 #include "mod_table/mod_table.h"
 
 #include "utils/encoding.h"
+#include "utils/ThreadPool.h"
 #include "utils/unicode.h"
 
 #include <utf8.h>
@@ -822,6 +826,39 @@ void copy_to_eoln(SCP_string &outstr, const char *more_terminators, const char *
 	}
 }
 
+bool parse_string_view::equals(const char *str) const
+{
+	return (strlen(str) == length) && (length == 0 || !strnicmp(data, str, length));
+}
+
+//	Return the rest of the line (or the text up to one of the terminators) without the surrounding white space, and
+//	advance Mp past it.  Same result as copy_to_eoln(), drop_trailing_white_space() and advance_to_eoln() together.
+parse_string_view stuff_string_view(const char *terminators)
+{
+	char	all_terminators[128];
+
+	Assert((terminators == NULL) || (strlen(terminators) < 125));
+
+	all_terminators[0] = EOLN;
+	all_terminators[1] = 0;
+	if (terminators != NULL)
+		strcat_s(all_terminators, terminators);
+
+	ignore_gray_space();
+
+	parse_string_view view;
+	view.data = Mp;
+
+	while ((*Mp != '\0') && (strchr(all_terminators, *Mp) == NULL))
+		Mp++;
+
+	view.length = Mp - view.data;
+	while ((view.length > 0) && is_white_space(view.data[view.length - 1]))
+		view.length--;
+
+	return view;
+}
+
 //	Copy characters from instr to outstr until next white space is found, or until max
 //	characters have been copied (including terminator).
 void copy_to_next_white(char *outstr, const char *instr, int max)
@@ -1273,11 +1310,11 @@ void stuff_string(SCP_string &outstr, int type, const char *terminators)
 		case F_FILESPEC:
 		case F_PATHNAME:
 		case F_MESSAGE:
-			ignore_gray_space();
-			copy_to_eoln(read_str, terminators, Mp);
-			drop_trailing_white_space(read_str);
-			advance_to_eoln(terminators);
+		{
+			auto view = stuff_string_view(terminators);
+			read_str.assign(view.data, view.length);
 			break;
+		}
 
 		case F_NOTES:
 			ignore_white_space();
@@ -1328,7 +1365,7 @@ void stuff_string(SCP_string &outstr, int type, const char *terminators)
 	}
 	else
 	{
-		outstr = read_str;
+		outstr = std::move(read_str);
 	}
 
 	diag_printf("Stuffed string = [%.30s]\n", outstr.c_str());
@@ -2044,6 +2081,105 @@ int parse_get_line(char *lineout, int max_line_len, const char *start, int max_s
 	return  num_chars_read;
 }
 
+static void process_file_text(char* processed_text, const char* raw_text, int raw_text_len);
+
+// Checks if the processed text of files in the given directory may be stored in the table cache
+static bool can_cache_file_text(int mode)
+{
+	return ((mode == CF_TYPE_TABLES) || (mode == CF_TYPE_MISSIONS)) && table_cache_enabled();
+}
+
+// Text of modular tables which parse_modular_table() already processed on worker threads, keyed by the file name
+struct prefetched_table {
+	int mode;
+	SCP_vector<char> text;
+};
+static SCP_unordered_map<SCP_string, prefetched_table> Prefetched_tables;
+
+// Moves the prefetched text of a table into Parse_text, returns false if the table was not prefetched
+static bool read_prefetched_file_text(const char *filename, int mode)
+{
+	auto it = Prefetched_tables.find(filename);
+	if (it == Prefetched_tables.end() || it->second.mode != mode)
+		return false;
+
+	auto& text = it->second.text;
+	allocate_parse_text(text.size());
+	memcpy(Parse_text, text.data(), text.size());
+
+	Prefetched_tables.erase(it);
+	return true;
+}
+
+// Opens a file memory mapped so its text can be processed without copying it into Parse_text_raw first.  Returns
+// nullptr if the file can't be mapped (e.g. because it is in a VP) or has to be decoded first, read_raw_file_text()
+// handles those.  The text stays valid until the returned file is closed.
+static CFILE *map_file_text(const char *filename, int mode, const char **text_out, int *len_out)
+{
+	auto mf = cfopen(filename, "rb", CFILE_MEMORY_MAPPED, mode);
+	if (mf == nullptr)
+		return nullptr;
+
+	auto file_len = cfilelength(mf);
+	auto text = static_cast<const char*>(cf_returndata(mf));
+
+	// short files are not worth the trouble and let the regular path report empty files
+	bool usable = file_len >= 10;
+
+	// encrypted and compressed files need to be decoded
+	if (usable) {
+		int header;
+		memcpy(&header, text, sizeof(header));
+		usable = !is_encrypted(const_cast<char*>(text)) && (comp_check_header(header) != COMP_HEADER_MATCH);
+	}
+
+	// files in the wrong encoding are either converted or reported by the regular path
+	if (usable) {
+		SCP_string probe(text, 10);
+		usable = util::guess_encoding(probe, Unicode_text_mode) == (Unicode_text_mode ? util::Encoding::UTF8 : util::Encoding::ASCII);
+
+		if (usable && Unicode_text_mode) {
+			if (util::has_bom(probe)) {
+				text += 3;
+				file_len -= 3;
+			}
+			usable = utf8::find_invalid(text, text + file_len) == text + file_len;
+		}
+	}
+
+	if (!usable) {
+		cfclose(mf);
+		return nullptr;
+	}
+
+	*text_out = text;
+	*len_out = file_len;
+	return mf;
+}
+
+// Processes a file straight from its memory mapping, returns false if map_file_text() can't handle it
+static bool read_mapped_file_text(const char *filename, int mode, bool use_cache)
+{
+	const char *text;
+	int file_len;
+
+	auto mf = map_file_text(filename, mode, &text, &file_len);
+	if (mf == nullptr)
+		return false;
+
+	allocate_parse_text((size_t) (file_len + 1));
+
+	if (!use_cache || !table_cache_read(text, (size_t)file_len, Parse_text, Parse_text_size)) {
+		process_file_text(Parse_text, text, file_len);
+
+		if (use_cache)
+			table_cache_write(text, (size_t)file_len, Parse_text);
+	}
+
+	cfclose(mf);
+	return true;
+}
+
 //	Read mission text, stripping comments.
 //	When a comment is found, it is removed.  If an entire line
 //	consisted of a comment, a blank line is left in the input file.
@@ -2061,6 +2197,16 @@ void read_file_text(const char *filename, int mode, char *processed_text, char *
 		Error(LOCATION, "ERROR: Neither processed_text nor raw_text may be NULL when parsing is paused!!\n");
 	}
 
+	// tables and missions can reuse the text from the last time they were processed, but only if we know how large the
+	// buffer is
+	bool use_cache = can_cache_file_text(mode) && (processed_text == NULL);
+
+	// when parsing into the global buffers the raw text is not needed afterwards, so skip copying it if possible
+	if ((processed_text == NULL) && (raw_text == NULL)) {
+		if (read_prefetched_file_text(filename, mode) || read_mapped_file_text(filename, mode, use_cache))
+			return;
+	}
+
 	// read the raw text
 	read_raw_file_text(filename, mode, raw_text);
 
@@ -2070,8 +2216,14 @@ void read_file_text(const char *filename, int mode, char *processed_text, char *
 	if (raw_text == NULL)
 		raw_text = Parse_text_raw;
 
+	if (use_cache && table_cache_read(raw_text, strlen(raw_text), processed_text, Parse_text_size))
+		return;
+
 	// process it (strip comments)
 	process_raw_file_text(processed_text, raw_text);
+
+	if (use_cache)
+		table_cache_write(raw_text, strlen(raw_text), processed_text);
 }
 
 // Goober5000
@@ -2305,31 +2457,49 @@ void coerce_to_utf8(SCP_string &buffer, const char *str)
 	Warning(LOCATION, "Truncating non-UTF-8 string '%s' to '%s'!\n", str, buffer.c_str());
 }
 
-// Goober5000
-void process_raw_file_text(char* processed_text, char* raw_text)
+// The retail strings which process_raw_file_text() has to fix, in the encoding of the current text mode
+struct retail_parse_exceptions {
+	SCP_string exception_1402;
+	SCP_string exception_1117;
+	SCP_string exception_1337;
+	SCP_string exception_3966;
+};
+
+static const retail_parse_exceptions& get_retail_parse_exceptions()
+{
+	// converting these is expensive, so only do it once for each text mode
+	static retail_parse_exceptions exceptions[2];
+	static bool converted[2] = { false, false };
+
+	auto mode = Unicode_text_mode ? 1 : 0;
+	if (!converted[mode]) {
+		auto& e = exceptions[mode];
+		unicode::convert_encoding(e.exception_1402, "1402, \"Sie haben IPX-Protokoll als Protokoll ausgew\xE4hlt, aber dieses Protokoll ist auf Ihrer Maschine nicht installiert.\".\"\n", unicode::Encoding::Encoding_iso8859_1);
+		unicode::convert_encoding(e.exception_1117, "1117, \"\\r\\n\"Aucun web browser trouva. Del\xE0 isn't on emm\xE9nagea ou if \\r\\non est emm\xE9nagea, ca isn't set pour soient la default browser.\\r\\n\\r\\n\"\n", unicode::Encoding::Encoding_iso8859_1);
+		unicode::convert_encoding(e.exception_1337, "1337, \"(fr)Loading\"\n", unicode::Encoding::Encoding_iso8859_1);
+		unicode::convert_encoding(e.exception_3966, "3966, \"Es sieht so aus, als habe Staffel Kappa Zugriff auf die GTVA-Zugangscodes f\xFCr das System gehabt. Das ist ein ernstes Sicherheitsleck. Ihre IFF-Kennung erschien als \"verb\xFCndet\", so da\xDF sie sich dem Konvoi ungehindert n\xE4hern konnten. Zum Gl\xFC\x63k flogen Sie und  Alpha 2 Geleitschutz und lie\xDF\x65n den Schwindel auffliegen, bevor Kappa ihren Befehl ausf\xFChren konnte.\"\n", unicode::Encoding::Encoding_iso8859_1);
+		converted[mode] = true;
+	}
+
+	return exceptions[mode];
+}
+
+// Strips the comments from raw_text, which does not have to be null-terminated.  processed_text needs room for
+// raw_text_len + 1 characters in unicode mode.
+static void process_file_text(char* processed_text, const char* raw_text, int raw_text_len)
 {
-	SCP_string parse_exception_1402;
-	unicode::convert_encoding(parse_exception_1402, "1402, \"Sie haben IPX-Protokoll als Protokoll ausgew\xE4hlt, aber dieses Protokoll ist auf Ihrer Maschine nicht installiert.\".\"\n", unicode::Encoding::Encoding_iso8859_1);
-	SCP_string parse_exception_1117;
-	unicode::convert_encoding(parse_exception_1117, "1117, \"\\r\\n\"Aucun web browser trouva. Del\xE0 isn't on emm\xE9nagea ou if \\r\\non est emm\xE9nagea, ca isn't set pour soient la default browser.\\r\\n\\r\\n\"\n", unicode::Encoding::Encoding_iso8859_1);
-	SCP_string parse_exception_1337;
-	unicode::convert_encoding(parse_exception_1337, "1337, \"(fr)Loading\"\n", unicode::Encoding::Encoding_iso8859_1);
-	SCP_string parse_exception_3966;
-	unicode::convert_encoding(parse_exception_3966, "3966, \"Es sieht so aus, als habe Staffel Kappa Zugriff auf die GTVA-Zugangscodes f\xFCr das System gehabt. Das ist ein ernstes Sicherheitsleck. Ihre IFF-Kennung erschien als \"verb\xFCndet\", so da\xDF sie sich dem Konvoi ungehindert n\xE4hern konnten. Zum Gl\xFC\x63k flogen Sie und  Alpha 2 Geleitschutz und lie\xDF\x65n den Schwindel auffliegen, bevor Kappa ihren Befehl ausf\xFChren konnte.\"\n", unicode::Encoding::Encoding_iso8859_1);
+	auto& exceptions = get_retail_parse_exceptions();
+	auto& parse_exception_1402 = exceptions.exception_1402;
+	auto& parse_exception_1117 = exceptions.exception_1117;
+	auto& parse_exception_1337 = exceptions.exception_1337;
+	auto& parse_exception_3966 = exceptions.exception_3966;
 
 	char* mp;
-	char* mp_raw;
-	char outbuf[PARSE_BUF_SIZE];
+	const char* mp_raw;
+	char outbuf_foreign[PARSE_BUF_SIZE];
 	bool in_quote = false;
 	bool in_multiline_comment_a = false;
 	bool in_multiline_comment_b = false;
-	int raw_text_len = (int)strlen(raw_text);
-
-	if (processed_text == NULL)
-		processed_text = Parse_text;
-
-	if (raw_text == NULL)
-		raw_text = Parse_text_raw;
 
 	Assert(processed_text != NULL);
 	Assert(raw_text != NULL);
@@ -2337,6 +2507,10 @@ void process_raw_file_text(char* processed_text, char* raw_text)
 	mp = processed_text;
 	mp_raw = raw_text;
 
+	// In unicode mode the text is used as it is, so each line is read straight into the processed text and the
+	// comments are stripped there.  Otherwise the characters have to be converted, which may make the line longer.
+	auto outbuf = Unicode_text_mode ? mp : outbuf_foreign;
+
 	// strip comments from raw text, reading into file_text
 	int num_chars_read = 0;
 	while ((num_chars_read = parse_get_line(outbuf, PARSE_BUF_SIZE, raw_text, raw_text_len, mp_raw)) != 0) {
@@ -2369,17 +2543,29 @@ void process_raw_file_text(char* processed_text, char* raw_text)
 
 		if (Unicode_text_mode) {
 			// In unicode mode we simply assume that the text is already properly encoded in UTF-8
-			// Also, since we don't know how big mp actually is since we get the pointer from the outside we can't use one of
-			// the "safe" strcpy variants here...
-			strcpy(mp, outbuf);
-			mp += strlen(outbuf);
+			mp += strlen(mp);
+			outbuf = mp;
 		} else {
 			mp += maybe_convert_foreign_characters(outbuf, mp, false);
 		}
 	}
 
 	// Make sure the string is terminated properly
-	*mp = *mp_raw = '\0';
+	*mp = '\0';
+}
+
+// Goober5000
+void process_raw_file_text(char* processed_text, char* raw_text)
+{
+	if (processed_text == NULL)
+		processed_text = Parse_text;
+
+	if (raw_text == NULL)
+		raw_text = Parse_text_raw;
+
+	Assert(raw_text != NULL);
+
+	process_file_text(processed_text, raw_text, (int)strlen(raw_text));
 /*
 	while (cfgets(outbuf, PARSE_BUF_SIZE, mf) != NULL) {
 		if (strlen(outbuf) >= PARSE_BUF_SIZE-1)
@@ -4278,6 +4464,84 @@ void parse_string_map(SCP_map<SCP_string, SCP_string>& outMap, const char* end_m
 	required_string(end_marker);
 }
 
+// Reads the given tables and strips their comments on worker threads so that read_file_text() only has to copy the
+// result once the table is parsed.  The files are opened and closed on the main thread since cfile is not thread safe.
+static void prefetch_table_text(const SCP_vector<SCP_string> &filenames, int mode, int num_threads)
+{
+	struct prefetch_job {
+		CFILE *mapped = nullptr;
+		SCP_string raw;			// the text of files which could not be mapped
+		const char *text = nullptr;
+		int len = 0;
+		bool cached = false;
+		SCP_vector<char> processed;
+		std::future<void> done;
+	};
+
+	bool use_cache = can_cache_file_text(mode);
+
+	// the exceptions are created on first use which must not happen on several threads at once
+	get_retail_parse_exceptions();
+
+	SCP_vector<std::unique_ptr<prefetch_job>> jobs(filenames.size());
+	util::ThreadPool pool(num_threads);
+
+	for (size_t i = 0; i < filenames.size(); ++i) {
+		auto filename = filenames[i].c_str();
+		std::unique_ptr<prefetch_job> job(new prefetch_job());
+
+		job->mapped = map_file_text(filename, mode, &job->text, &job->len);
+		if (job->mapped == nullptr) {
+			try {
+				read_raw_file_text(filename, mode, nullptr);
+			} catch (const parse::ParseException&) {
+				// leave it to the callback so the error is reported the same way as without prefetching
+				continue;
+			}
+
+			job->raw = Parse_text_raw;
+			job->text = job->raw.c_str();
+			job->len = (int)job->raw.size();
+		}
+
+		// converting foreign characters may make the text longer
+		job->processed.resize(Unicode_text_mode ? job->len + 1 : job->len * 2 + 1);
+
+		if (use_cache && table_cache_read(job->text, (size_t)job->len, job->processed.data(), job->processed.size())) {
+			job->cached = true;
+		} else {
+			auto job_ptr = job.get();
+			job->done = pool.submit([job_ptr]() {
+				process_file_text(job_ptr->processed.data(), job_ptr->text, job_ptr->len);
+			});
+		}
+
+		jobs[i] = std::move(job);
+	}
+
+	// collect the results in order, files which failed to load are read again by their callback
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		auto &job = jobs[i];
+		if (!job)
+			continue;
+
+		if (job->done.valid())
+			job->done.get();
+
+		if (use_cache && !job->cached)
+			table_cache_write(job->text, (size_t)job->len, job->processed.data());
+
+		if (job->mapped != nullptr)
+			cfclose(job->mapped);
+
+		job->processed.resize(strlen(job->processed.data()) + 1);
+
+		auto &entry = Prefetched_tables[filenames[i]];
+		entry.mode = mode;
+		entry.text = std::move(job->processed);
+	}
+}
+
 // parse a modular table of type "name_check" and parse it using the specified function callback
 int parse_modular_table(const char *name_check, void (*parse_callback)(const char *filename), int path_type, int sort_type)
 {
@@ -4295,14 +4559,27 @@ int parse_modular_table(const char *name_check, void (*parse_callback)(const cha
 
 	const auto ext = strrchr(name_check, '.');
 
-	for (i = 0; i < num_files; i++){
-		if (ext != nullptr) {
+	if (ext != nullptr) {
+		for (i = 0; i < num_files; i++) {
 			tbl_file_names[i] += ext;
 		}
+	}
+
+	// The tables are still parsed one after another in the sorted order so the result does not depend on the threads,
+	// only reading them and stripping the comments happens in parallel.  That is not possible while parsing is paused
+	// since it uses the global parse buffers.
+	if ((Cmdline_table_threads > 0) && (num_files > 1) && Bookmarks.empty()) {
+		prefetch_table_text(tbl_file_names, path_type, Cmdline_table_threads);
+	}
+
+	for (i = 0; i < num_files; i++){
 		mprintf(("TBM  =>  Starting parse of '%s' ...\n", tbl_file_names[i].c_str()));
 		(*parse_callback)(tbl_file_names[i].c_str());
 	}
 
+	// callbacks are not required to read their file
+	Prefetched_tables.clear();
+
 	Parsing_modular_table = false;
 
 	return num_files;
@@ -136,6 +136,22 @@ extern void stuff_string_until(SCP_string &outstr, const char *endstr);
 extern void stuff_string(SCP_string &outstr, int type, const char *terminators = NULL);
 extern void stuff_string_line(SCP_string &outstr);
 
+// A part of the text that is being parsed.  It points into the parse text instead of copying it, so it is only valid
+// until the next file is read; use to_string() to keep it longer.
+struct parse_string_view {
+	const char *data = nullptr;
+	size_t length = 0;
+
+	bool empty() const { return length == 0; }
+	SCP_string to_string() const { return SCP_string(data, length); }
+
+	// case insensitive, like the other token comparisons
+	bool equals(const char *str) const;
+};
+
+// reads the rest of the line like stuff_string() with F_RAW, but without copying it
+extern parse_string_view stuff_string_view(const char *terminators = NULL);
+
 //alloc
 extern char* alloc_block(const char* startstr, const char* endstr, int extra_chars = 0);
 
@@ -104,6 +104,8 @@
 #include "weapon/shockwave.h"
 #include "weapon/weapon.h"
 
+#include "parse/sexp/sexp_bytecode.h"
+#include "parse/sexp/sexp_profiler.h"
 #include "parse/sexp/sexp_lookup.h"
 
 #ifndef NDEBUG
@@ -839,6 +841,12 @@ const char *Skybox_flags[] = {
 
 int	Directive_count;
 int	Sexp_useful_number;  // a variable to pass useful info in from external modules
+int	Sexp_evaluation_dependencies = 0;
+
+// the mission state changes are numbered so that an event can tell what changed since it was evaluated
+static int Sexp_state_sequence = 0;
+static int Sexp_state_changed_at[SEXP_NUM_TRACKED_DEPS];
+
 int	Locked_sexp_true, Locked_sexp_false;
 int	Num_sexp_ai_goal_links = sizeof(Sexp_ai_goal_links) / sizeof(sexp_ai_goal_link);
 int	Sexp_clipboard = -1;  // used by Fred
@@ -1174,6 +1182,11 @@ void init_sexp()
 	Sexp_applicable_argument_list.expunge();
 	Sexp_current_argument_nesting_level = 0;
 	Current_sexp_network_packet.initialize();
+	sexp::clear_compiled_formulas();
+
+	Sexp_evaluation_dependencies = 0;
+	Sexp_state_sequence = 0;
+	memset(Sexp_state_changed_at, 0, sizeof(Sexp_state_changed_at));
 
 	sexp_nodes_init();
 	init_sexp_vars();
@@ -1669,6 +1682,10 @@ int find_argnum(int parent_node, int arg_node)
 	return -1;
 }
 
+// Operator names to their index in Operators, extended whenever dynamic SEXPs are appended to Operators
+static SCP_unordered_map<SCP_string, int> Operator_name_index;
+static size_t Operator_name_index_size = 0;
+
 /**
  * From an operator name, return its index in the array Operators
  */
@@ -1676,13 +1693,25 @@ int get_operator_index(const char *token)
 {
 	Assertion(token != nullptr, "get_operator_index(char*) called with a null token; get a coder!\n");
 
-	for (size_t i=0; i < Operators.size(); i++){
-		if (Operators[i].text == token){
-			return (int)i;
+	if (Operator_name_index_size != Operators.size()) {
+		if (Operator_name_index_size > Operators.size()) {
+			Operator_name_index.clear();
+			Operator_name_index_size = 0;
+		}
+
+		// emplace keeps the first operator of a name, just like a search from the front would
+		for (auto i = Operator_name_index_size; i < Operators.size(); i++) {
+			Operator_name_index.emplace(Operators[i].text, (int)i);
 		}
+		Operator_name_index_size = Operators.size();
+	}
+
+	auto it = Operator_name_index.find(token);
+	if (it == Operator_name_index.end()) {
+		return NOT_A_SEXP_OPERATOR;
 	}
 
-	return NOT_A_SEXP_OPERATOR;
+	return it->second;
 }
 
 /**
@@ -6049,8 +6078,10 @@ int sexp_check_objective_delay(int delay_node, int objective_node, int(*objectiv
 	{
 		if ((Missiontime - time) >= delay)
 			return val;
-		else
-			return SEXP_FALSE;
+
+		// the result changes once the delay has passed
+		Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
+		return SEXP_FALSE;
 	}
 
 	return val;
@@ -6492,8 +6523,10 @@ int sexp_are_waypoints_done_delay(int n)
 	{
 		if ((Missiontime - time) >= delay)
 			return val;
-		else
-			return SEXP_FALSE;
+
+		// the result changes once the delay has passed
+		Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
+		return SEXP_FALSE;
 	}
 
 	return val;
@@ -6593,6 +6626,8 @@ int sexp_has_docked_or_undocked(int n, int op_num)
 		{
 			if ((Missiontime - time) >= delay)
 				return SEXP_KNOWN_TRUE;
+
+			Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
 		}
 		// if either ship has exited, no way to dock
 		else if (docker->status == ShipStatus::EXITED || dockee->status == ShipStatus::EXITED)
@@ -15742,6 +15777,7 @@ int sexp_event_delay_status( int n, int want_true, bool use_msecs = false)
 		// look for the event name, check it's status.  If formula is gone, we know the state won't ever change.
 		if ( !stricmp(Mission_events[i].name, name) ) {
 			if ( (fix) Mission_events[i].timestamp + delay >= Missiontime ) {
+				Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
 				rval = SEXP_FALSE;
 				break;
 			}
@@ -15826,6 +15862,8 @@ int sexp_goal_delay_status( int n, int want_true )
 		else if ( mission_log_get_time(LOG_GOAL_SATISFIED, name, nullptr, &time) ) {
 			if ( (Missiontime - time) >= delay )
 				return SEXP_KNOWN_TRUE;
+
+			Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
 		}
 	} else {
 		// if we are looking for a goal false entry and we find a true, then return known false here
@@ -15834,6 +15872,8 @@ int sexp_goal_delay_status( int n, int want_true )
 		else if ( mission_log_get_time(LOG_GOAL_FAILED, name, nullptr, &time) ) {
 			if ( (Missiontime - time) >= delay )
 				return SEXP_KNOWN_TRUE;
+
+			Sexp_evaluation_dependencies |= SEXP_DEP_TIME;
 		}
 	}
 
@@ -24118,6 +24158,116 @@ void add_to_event_log_buffer(int node, int op_num, int result)
 	Current_event_log_buffer->push_back(tmp);
 }
 
+/**
+ * Records that some mission state which operators depend on has changed
+ */
+void sexp_state_changed(int dependencies)
+{
+	++Sexp_state_sequence;
+
+	for (int i = 0; i < SEXP_NUM_TRACKED_DEPS; ++i) {
+		if (dependencies & (1 << i))
+			Sexp_state_changed_at[i] = Sexp_state_sequence;
+	}
+}
+
+/**
+ * Returns the number of the most recent state change.  Store this before evaluating a formula and pass it
+ * to sexp_state_changed_since() later.
+ */
+int sexp_get_state_sequence()
+{
+	return Sexp_state_sequence;
+}
+
+/**
+ * Checks if any of the given dependencies changed after the state change with the given number.
+ * A negative sequence means the formula was never evaluated.
+ */
+bool sexp_state_changed_since(int dependencies, int sequence)
+{
+	if (sequence < 0 || (dependencies & (SEXP_DEP_TIME | SEXP_DEP_UNKNOWN)))
+		return true;
+
+	for (int i = 0; i < SEXP_NUM_TRACKED_DEPS; ++i) {
+		if ((dependencies & (1 << i)) && Sexp_state_changed_at[i] > sequence)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Stores the result of an operator in its node and converts special values into the value returned by eval_sexp()
+ */
+int eval_sexp_finish(int cur_node, int sexp_val)
+{
+	// check the sexp value of the sexpression evaluation.  A special value of known true or
+	// known false means that we should set the sexp.value field for short circuit eval.
+	if (sexp_val == SEXP_KNOWN_TRUE) {
+		Sexp_nodes[cur_node].value = SEXP_KNOWN_TRUE;
+		return SEXP_TRUE;
+	}
+
+	if (sexp_val == SEXP_KNOWN_FALSE) {
+		Sexp_nodes[cur_node].value = SEXP_KNOWN_FALSE;
+		return SEXP_FALSE;
+	}
+
+	if ( sexp_val == SEXP_NAN ) {
+		Sexp_nodes[cur_node].value = SEXP_NAN;			// not a number values are false I would suspect
+		return SEXP_FALSE;
+	}
+
+	if ( sexp_val == SEXP_NAN_FOREVER ) {
+		Sexp_nodes[cur_node].value = SEXP_NAN_FOREVER;
+		// Goober5000 changed from sexp_val to SEXP_FALSE on 2/21/2006 in accordance with above comment
+		// NOTE: we return false rather than known-false to match the SEXP_KNOWN_FALSE case above
+		return SEXP_FALSE;
+	}
+
+	if ( sexp_val == SEXP_CANT_EVAL ) {
+		Sexp_nodes[cur_node].value = SEXP_CANT_EVAL;
+		Sexp_useful_number = 0;  // indicate sexp isn't current yet
+		return SEXP_FALSE;
+	}
+
+	if ( Sexp_nodes[cur_node].value == SEXP_NAN ) {	// if we had a nan, but now don't, reset the value
+		Sexp_nodes[cur_node].value = SEXP_UNKNOWN;
+		return sexp_val;
+	}
+
+#ifndef NDEBUG
+	// now, reconcile positive and negative - Goober5000
+	if (sexp_val < 0 && sexp_val > SEXP_UNLIKELY_RETURN_VALUE_BOUND)
+	{
+		int parent_node = find_parent_operator(cur_node);
+
+		// if the SEXP has no parent, the point is moot
+		if (parent_node >= 0)
+		{
+			int arg_num = find_argnum(parent_node, cur_node);
+			Assertion(arg_num >= 0, "Error finding sexp argument.  The SEXP is not listed among its parent's children.");
+
+			// if we need a positive value, make it positive
+			if (query_operator_argument_type(get_operator_index(parent_node), arg_num) == OPF_POSITIVE)
+			{
+				Warning(LOCATION, "Parent node %s, argument %d (value %d) is negative, but is required to be positive!", Sexp_nodes[parent_node].text, arg_num + 1, sexp_val);
+				sexp_val *= -1;
+			}
+		}
+	}
+#endif
+
+	if ( sexp_val ){
+		Sexp_nodes[cur_node].value = SEXP_TRUE;
+	} else {
+		Sexp_nodes[cur_node].value = SEXP_FALSE;
+	}
+
+	return sexp_val;
+}
+
 /**
  * High-level sexpression evaluator
  */
@@ -24129,6 +24279,13 @@ int eval_sexp(int cur_node, int referenced_node)
 
 	Assert(cur_node >= 0);			// we have special sexp nodes <= -1!!!  MWA
 									// which should be intercepted before we get here.  HOFFOSS
+
+	// event and goal formulas which were compiled at mission load run their program instead of walking the tree.
+	// The tree is still used when logging since the program does not produce log entries, and when profiling so
+	// that the time is attributed to the operators.
+	if ((Sexp_nodes[cur_node].flags & SNF_COMPILED_FORMULA) && referenced_node == -1 && !Log_event && !sexp::Profiler_enabled)
+		return sexp::eval_compiled_formula(cur_node);
+
 	type = SEXP_NODE_TYPE(cur_node);
 	Assert( (type == SEXP_LIST) || (type == SEXP_ATOM) );
 
@@ -24176,6 +24333,10 @@ int eval_sexp(int cur_node, int referenced_node)
 		// add the op_num to the stack if it is an actual operator rather than a number
 		if (op_num) {
 			Current_sexp_operator.push_back(op_num); 
+			Sexp_evaluation_dependencies |= query_operator_dependencies(op_num);
+
+			if (sexp::Profiler_enabled)
+				sexp::profiler_begin_operator(op_num);
 		}
 		switch ( op_num ) {
 		// arithmetic operators will always return just their value
@@ -26388,73 +26549,12 @@ int eval_sexp(int cur_node, int referenced_node)
 		Assert(!Current_sexp_operator.empty()); 
 		Current_sexp_operator.pop_back();
 
-		Assertion(sexp_val != UNINITIALIZED, "SEXP %s didn't return a value!", CTEXT(cur_node));
+		if (sexp::Profiler_enabled)
+			sexp::profiler_end_operator();
 
-		// if we haven't returned, check the sexp value of the sexpression evaluation.  A special
-		// value of known true or known false means that we should set the sexp.value field for
-		// short circuit eval.
-		if (sexp_val == SEXP_KNOWN_TRUE) {
-			Sexp_nodes[cur_node].value = SEXP_KNOWN_TRUE;
-			return SEXP_TRUE;
-		}
-
-		if (sexp_val == SEXP_KNOWN_FALSE) {
-			Sexp_nodes[cur_node].value = SEXP_KNOWN_FALSE;
-			return SEXP_FALSE;
-		}
-
-		if ( sexp_val == SEXP_NAN ) {
-			Sexp_nodes[cur_node].value = SEXP_NAN;			// not a number values are false I would suspect
-			return SEXP_FALSE;
-		}
-
-		if ( sexp_val == SEXP_NAN_FOREVER ) {
-			Sexp_nodes[cur_node].value = SEXP_NAN_FOREVER;
-			// Goober5000 changed from sexp_val to SEXP_FALSE on 2/21/2006 in accordance with above comment
-			// NOTE: we return false rather than known-false to match the SEXP_KNOWN_FALSE case above
-			return SEXP_FALSE;
-		}
-
-		if ( sexp_val == SEXP_CANT_EVAL ) {
-			Sexp_nodes[cur_node].value = SEXP_CANT_EVAL;
-			Sexp_useful_number = 0;  // indicate sexp isn't current yet
-			return SEXP_FALSE;
-		}
-
-		if ( Sexp_nodes[cur_node].value == SEXP_NAN ) {	// if we had a nan, but now don't, reset the value
-			Sexp_nodes[cur_node].value = SEXP_UNKNOWN;
-			return sexp_val;
-		}
-
-#ifndef NDEBUG
-		// now, reconcile positive and negative - Goober5000
-		if (sexp_val < 0 && sexp_val > SEXP_UNLIKELY_RETURN_VALUE_BOUND)
-		{
-			int parent_node = find_parent_operator(cur_node);
-
-			// if the SEXP has no parent, the point is moot
-			if (parent_node >= 0)
-			{
-				int arg_num = find_argnum(parent_node, cur_node);
-				Assertion(arg_num >= 0, "Error finding sexp argument.  The SEXP is not listed among its parent's children.");
-
-				// if we need a positive value, make it positive
-				if (query_operator_argument_type(get_operator_index(parent_node), arg_num) == OPF_POSITIVE)
-				{
-					Warning(LOCATION, "Parent node %s, argument %d (value %d) is negative, but is required to be positive!", Sexp_nodes[parent_node].text, arg_num + 1, sexp_val);
-					sexp_val *= -1;
-				}
-			}
-		}
-#endif
-
-		if ( sexp_val ){
-			Sexp_nodes[cur_node].value = SEXP_TRUE;
-		} else {
-			Sexp_nodes[cur_node].value = SEXP_FALSE;
-		}
+		Assertion(sexp_val != UNINITIALIZED, "SEXP %s didn't return a value!", CTEXT(cur_node));
 
-		return sexp_val;
+		return eval_sexp_finish(cur_node, sexp_val);
 	}
 }
 
@@ -27546,6 +27646,82 @@ int query_operator_return_type(int op)
 	return 0;
 }
 
+/**
+ * Returns the SEXP_DEP_* flags of the mission state an operator reads.
+ *
+ * Arguments are not included since they are evaluated as operators of their own, and variables are recorded when
+ * they are read.  An operator should only declare its dependencies here if its result can't change while they stay
+ * the same.  Operators that only depend on time for part of their result add SEXP_DEP_TIME while being evaluated.
+ */
+int query_operator_dependencies(int op)
+{
+	switch (op)
+	{
+		case OP_TRUE:
+		case OP_FALSE:
+		case OP_AND:
+		case OP_AND_IN_SEQUENCE:
+		case OP_OR:
+		case OP_NOT:
+		case OP_XOR:
+		case OP_EQUALS:
+		case OP_GREATER_THAN:
+		case OP_LESS_THAN:
+		case OP_NOT_EQUAL:
+		case OP_GREATER_OR_EQUAL:
+		case OP_LESS_OR_EQUAL:
+		case OP_STRING_EQUALS:
+		case OP_STRING_GREATER_THAN:
+		case OP_STRING_LESS_THAN:
+		case OP_PLUS:
+		case OP_MINUS:
+		case OP_MUL:
+		case OP_DIV:
+		case OP_MOD:
+		case OP_ABS:
+		case OP_MIN:
+		case OP_MAX:
+		case OP_AVG:
+		case OP_WHEN:
+			return 0;
+
+		case OP_IS_DESTROYED:
+		case OP_IS_DESTROYED_DELAY:
+		case OP_IS_SUBSYSTEM_DESTROYED:
+		case OP_IS_SUBSYSTEM_DESTROYED_DELAY:
+		case OP_HAS_ARRIVED:
+		case OP_HAS_ARRIVED_DELAY:
+		case OP_HAS_DEPARTED:
+		case OP_HAS_DEPARTED_DELAY:
+		case OP_IS_DISABLED:
+		case OP_IS_DISABLED_DELAY:
+		case OP_IS_DISARMED:
+		case OP_IS_DISARMED_DELAY:
+		case OP_HAS_DOCKED:
+		case OP_HAS_DOCKED_DELAY:
+		case OP_HAS_UNDOCKED:
+		case OP_HAS_UNDOCKED_DELAY:
+		case OP_WAYPOINTS_DONE:
+		case OP_WAYPOINTS_DONE_DELAY:
+			return SEXP_DEP_MISSION_LOG | SEXP_DEP_SHIP_STATUS;
+
+		case OP_GOAL_TRUE_DELAY:
+		case OP_GOAL_FALSE_DELAY:
+		case OP_GOAL_INCOMPLETE:
+			return SEXP_DEP_MISSION_LOG;
+
+		case OP_EVENT_TRUE_DELAY:
+		case OP_EVENT_FALSE_DELAY:
+		case OP_EVENT_TRUE_MSECS_DELAY:
+		case OP_EVENT_FALSE_MSECS_DELAY:
+		case OP_EVENT_INCOMPLETE:
+			return SEXP_DEP_EVENTS;
+
+		default:
+			return SEXP_DEP_UNKNOWN;
+	}
+}
+
 /**
  * Return the data type of a specified argument to an operator.  
  *
@@ -30609,6 +30785,7 @@ const char *CTEXT(int n)
 		}
 		// Reference a Sexp_variable
 		// string format -- "Sexp_variables[xx]=number" or "Sexp_variables[xx]=string", where xx is the index
+		Sexp_evaluation_dependencies |= SEXP_DEP_VARIABLES;
 
 		Assert( !(Sexp_variables[sexp_variable_index].type & SEXP_VARIABLE_NOT_USED) );
 		Assert(Sexp_variables[sexp_variable_index].type & SEXP_VARIABLE_SET);
@@ -30622,6 +30799,7 @@ const char *CTEXT(int n)
 	}
 	else if (Sexp_nodes[n].subtype == SEXP_ATOM_CONTAINER)
 	{
+		Sexp_evaluation_dependencies |= SEXP_DEP_UNKNOWN;
 		return sexp_container_CTEXT(n);
 	}
 	else
@@ -30734,6 +30912,7 @@ void sexp_modify_variable(const char *text, int index, bool sexp_callback)
 		Sexp_variables[index].text[maxCopyLen] = 0;
 	}
 	Sexp_variables[index].type |= SEXP_VARIABLE_MODIFIED;
+	sexp_state_changed(SEXP_DEP_VARIABLES);
 
 	// do multi_callback_here
 	// if we're called from the sexp code send a SEXP packet (more efficient) 
@@ -30769,6 +30948,7 @@ void multi_sexp_modify_variable()
 		}
 
 		strcpy_s(Sexp_variables[variable_index].text, value);
+		sexp_state_changed(SEXP_DEP_VARIABLES);
 	}	
 }
 
@@ -1189,8 +1189,19 @@ typedef struct sexp_node {
 #define SNF_SPECIAL_ARG_IN_TREE		(1<<3)
 #define SNF_SPECIAL_ARG_NOT_IN_TREE	(1<<4)
 #define SNF_CHECKED_ARG_FOR_VAR		(1<<5)
+#define SNF_COMPILED_FORMULA		(1<<6)	// the node is the root of a formula which has a compiled program
 #define SNF_DEFAULT_VALUE			SNF_ARGUMENT_VALID
 
+// The mission state an operator reads.  Events and goals whose dependencies did not change since they last
+// evaluated to false are not evaluated again.
+#define SEXP_DEP_MISSION_LOG		(1<<0)	// entries of the mission log
+#define SEXP_DEP_SHIP_STATUS		(1<<1)	// arrival and exit of ships and wings
+#define SEXP_DEP_VARIABLES			(1<<2)	// values of sexp variables
+#define SEXP_DEP_EVENTS				(1<<3)	// results of mission events
+#define SEXP_DEP_TIME				(1<<4)	// the result may change as mission time passes
+#define SEXP_DEP_UNKNOWN			(1<<5)	// the operator does not declare what it reads
+#define SEXP_NUM_TRACKED_DEPS		4		// the dependencies which have a change counter
+
 typedef struct sexp_variable {
 	int		type;
 	char	text[TOKEN_LENGTH];
@@ -1215,6 +1226,7 @@ extern SCP_vector<sexp_oper> Operators;
 extern int Locked_sexp_true, Locked_sexp_false;
 extern int Directive_count;
 extern int Sexp_useful_number;  // a variable to pass useful info in from external modules
+extern int Sexp_evaluation_dependencies;  // SEXP_DEP_* flags of everything read since this was last cleared
 extern int Training_context;
 extern int Training_context_speed_min;
 extern int Training_context_speed_max;
@@ -1264,9 +1276,14 @@ extern int get_sexp_main(void);	//	Returns start node
 extern int run_sexp(const char* sexpression, bool run_eval_num = false, bool *is_nan_or_nan_forever = nullptr); // debug and lua sexps
 extern int stuff_sexp_variable_list();
 extern int eval_sexp(int cur_node, int referenced_node = -1);
+extern int eval_sexp_finish(int cur_node, int sexp_val);
 extern int eval_num(int n, bool &is_nan, bool &is_nan_forever);
 extern bool is_sexp_true(int cur_node, int referenced_node = -1);
 extern int query_operator_return_type(int op);
+extern int query_operator_dependencies(int op);
+extern void sexp_state_changed(int dependencies);
+extern int sexp_get_state_sequence();
+extern bool sexp_state_changed_since(int dependencies, int sequence);
 extern int query_operator_argument_type(int op, int argnum);
 extern void update_sexp_references(const char *old_name, const char *new_name);
 extern void update_sexp_references(const char *old_name, const char *new_name, int format);
@@ -1290,6 +1307,7 @@ extern bool sexp_can_construe_as_integer(int node);
 
 // Goober5000
 void do_action_for_each_special_argument(int cur_node);
+void eval_when_do_one_exp(int exp);
 bool special_argument_appears_in_sexp_tree(int node);
 bool special_argument_appears_in_sexp_list(int node);
 
@@ -0,0 +1,550 @@
+#include "parse/sexp/sexp_bytecode.h"
+
+#include "parse/parselo.h"
+#include "parse/sexp.h"
+
+namespace {
+
+enum class opcode : ubyte {
+	Tree,		// evaluated by eval_sexp()
+	Action,		// an action of a when which needs eval_when_do_one_exp()
+	Number,		// a number which was resolved at compile time
+	Leaf,		// a number which can change, e.g. a variable
+	List,		// a list node which takes the value of its first element
+	True,
+	False,
+	And,
+	Or,
+	Not,
+	Plus,
+	Minus,
+	Mul,
+	Compare,	// the operator constant is stored in the operand
+	When,
+};
+
+struct instruction {
+	opcode op;
+	int node;		// the node this instruction evaluates and which receives its value
+	int operand;	// Number: the value, Compare: the operator, logical and arithmetic operators: 1 if the first argument is a bare atom
+	int first_arg;	// index of the first argument in Arguments
+	int num_args;
+};
+
+// All programs share these so that the instructions of a formula are stored next to each other
+SCP_vector<instruction> Instructions;
+SCP_vector<int> Arguments;
+
+// maps the root node of a formula to the index of its root instruction
+SCP_unordered_map<int, int> Formulas;
+
+int emit(opcode op, int node, int operand = 0, const SCP_vector<int>& args = SCP_vector<int>())
+{
+	instruction ins;
+	ins.op = op;
+	ins.node = node;
+	ins.operand = operand;
+	ins.first_arg = static_cast<int>(Arguments.size());
+	ins.num_args = static_cast<int>(args.size());
+
+	Arguments.insert(Arguments.end(), args.begin(), args.end());
+	Instructions.push_back(ins);
+
+	return static_cast<int>(Instructions.size()) - 1;
+}
+
+int emit_leaf(int node)
+{
+	// numeric literals never change so they can be resolved right away
+	if (Sexp_nodes[node].subtype == SEXP_ATOM_NUMBER && !(Sexp_nodes[node].type & SEXP_FLAG_VARIABLE)
+		&& !(Sexp_nodes[node].flags & SNF_SPECIAL_ARG_IN_NODE)) {
+		return emit(opcode::Number, node, sexp_atoi(node));
+	}
+
+	return emit(opcode::Leaf, node);
+}
+
+int compile_node(int node);
+
+// and, or, not and the arithmetic operators evaluate their first argument as an operator but the other arguments as
+// list nodes. A first argument which is a bare atom is read without checking its value.
+int compile_first_arg_operator(opcode op, int node)
+{
+	SCP_vector<int> args;
+	int first_is_atom = 0;
+
+	int n = CDR(node);
+	if (n != -1) {
+		if (CAR(n) != -1) {
+			args.push_back(compile_node(CAR(n)));
+		} else {
+			args.push_back(emit_leaf(n));
+			first_is_atom = 1;
+		}
+
+		for (n = CDR(n); n != -1; n = CDR(n)) {
+			args.push_back(compile_node(n));
+		}
+	}
+
+	return emit(op, node, first_is_atom, args);
+}
+
+int compile_compare(int op_num, int node)
+{
+	SCP_vector<int> args;
+
+	for (int n = CDR(node); n != -1; n = CDR(n)) {
+		args.push_back(compile_node(n));
+	}
+
+	// the comparison evaluates its first argument even if there is none
+	if (args.empty()) {
+		return emit(opcode::Tree, node);
+	}
+
+	return emit(opcode::Compare, node, op_num, args);
+}
+
+int compile_when(int node)
+{
+	int n = CDR(node);
+	if (n == -1 || CAR(n) == -1) {
+		return emit(opcode::Tree, node);
+	}
+
+	SCP_vector<int> args;
+	args.push_back(compile_node(CAR(n)));
+
+	for (int actions = CDR(n); actions != -1; actions = CDR(actions)) {
+		int exp = CAR(actions);
+		if (exp == -1) {
+			continue;
+		}
+
+		if (get_operator_const(exp) == OP_DO_FOR_VALID_ARGUMENTS || special_argument_appears_in_sexp_tree(exp)) {
+			args.push_back(emit(opcode::Action, exp));
+		} else {
+			args.push_back(compile_node(exp));
+		}
+	}
+
+	return emit(opcode::When, node, 0, args);
+}
+
+// Compiles a node the same way eval_sexp() dispatches it
+int compile_node(int node)
+{
+	if (node < 0) {
+		return emit(opcode::Tree, node);
+	}
+
+	if (Sexp_nodes[node].first != -1) {
+		SCP_vector<int> args;
+		args.push_back(compile_node(CAR(node)));
+
+		return emit(opcode::List, node, 0, args);
+	}
+
+	int op_num = get_operator_const(node);
+	switch (op_num) {
+		case 0:
+			return emit_leaf(node);
+
+		case OP_TRUE:
+			return emit(opcode::True, node);
+
+		case OP_FALSE:
+			return emit(opcode::False, node);
+
+		case OP_AND:
+			return compile_first_arg_operator(opcode::And, node);
+
+		case OP_OR:
+			return compile_first_arg_operator(opcode::Or, node);
+
+		case OP_NOT:
+			return compile_first_arg_operator(opcode::Not, node);
+
+		case OP_PLUS:
+			return compile_first_arg_operator(opcode::Plus, node);
+
+		case OP_MINUS:
+			return compile_first_arg_operator(opcode::Minus, node);
+
+		case OP_MUL:
+			return compile_first_arg_operator(opcode::Mul, node);
+
+		case OP_EQUALS:
+		case OP_NOT_EQUAL:
+		case OP_GREATER_THAN:
+		case OP_GREATER_OR_EQUAL:
+		case OP_LESS_THAN:
+		case OP_LESS_OR_EQUAL:
+			return compile_compare(op_num, node);
+
+		case OP_WHEN:
+			return compile_when(node);
+
+		default:
+			return emit(opcode::Tree, node);
+	}
+}
+
+int run(int index);
+
+inline int value_of(int index)
+{
+	return Sexp_nodes[Instructions[index].node].value;
+}
+
+inline bool is_true(int index)
+{
+	int result = run(index);
+	return result == SEXP_TRUE || result == SEXP_KNOWN_TRUE;
+}
+
+// matches sexp_and()
+int run_and(const instruction& ins, const int* args)
+{
+	if (ins.num_args == 0) {
+		return SEXP_KNOWN_TRUE;
+	}
+
+	bool all_true = true;
+	bool result;
+	int i = 0;
+
+	if (ins.operand) {
+		result = run(args[0]) != 0;
+		i = 1;
+	}
+	else {
+		result = true;
+	}
+
+	for (; i < ins.num_args; ++i) {
+		result = is_true(args[i]) && result;
+
+		int value = value_of(args[i]);
+		if (value == SEXP_KNOWN_FALSE || value == SEXP_NAN_FOREVER)
+			return SEXP_KNOWN_FALSE;
+		if (value != SEXP_KNOWN_TRUE)
+			all_true = false;
+	}
+
+	if (all_true)
+		return SEXP_KNOWN_TRUE;
+
+	return result ? SEXP_TRUE : SEXP_FALSE;
+}
+
+// matches sexp_or()
+int run_or(const instruction& ins, const int* args)
+{
+	if (ins.num_args == 0) {
+		return SEXP_KNOWN_FALSE;
+	}
+
+	bool all_false = true;
+	bool result;
+	int i = 0;
+
+	if (ins.operand) {
+		result = run(args[0]) != 0;
+		i = 1;
+	}
+	else {
+		result = false;
+	}
+
+	for (; i < ins.num_args; ++i) {
+		result = is_true(args[i]) || result;
+
+		int value = value_of(args[i]);
+		if (value == SEXP_KNOWN_TRUE)
+			return SEXP_KNOWN_TRUE;
+		if (value != SEXP_KNOWN_FALSE)
+			all_false = false;
+	}
+
+	if (all_false)
+		return SEXP_KNOWN_FALSE;
+
+	return result ? SEXP_TRUE : SEXP_FALSE;
+}
+
+// matches sexp_not()
+int run_not(const instruction& ins, const int* args)
+{
+	bool result = false;
+
+	if (ins.num_args > 0) {
+		if (ins.operand) {
+			result = run(args[0]) != 0;
+		} else {
+			result = is_true(args[0]);
+
+			int value = value_of(args[0]);
+			if (value == SEXP_KNOWN_FALSE || value == SEXP_NAN_FOREVER)
+				return SEXP_KNOWN_TRUE;
+			else if (value == SEXP_KNOWN_TRUE)
+				return SEXP_KNOWN_FALSE;
+			else if (value == SEXP_NAN)
+				return SEXP_TRUE;
+		}
+	}
+
+	return result ? SEXP_FALSE : SEXP_TRUE;
+}
+
+// matches add_sexps(), sub_sexps() and mul_sexps()
+int run_arithmetic(const instruction& ins, const int* args)
+{
+	int sum = 0;
+
+	for (int i = 0; i < ins.num_args; ++i) {
+		int val = run(args[i]);
+
+		if (i > 0 || !ins.operand) {
+			int value = value_of(args[i]);
+			if (value == SEXP_NAN)
+				return SEXP_NAN;
+			else if (value == SEXP_NAN_FOREVER)
+				return SEXP_NAN_FOREVER;
+		}
+
+		if (i == 0) {
+			sum = val;
+		} else if (ins.op == opcode::Plus) {
+			sum += val;
+		} else if (ins.op == opcode::Minus) {
+			sum -= val;
+		} else {
+			sum *= val;
+		}
+	}
+
+	return sum;
+}
+
+// checks the nodes sexp_number_compare() checks for NaN values before evaluating an argument
+inline int compare_nan_check(int node)
+{
+	for (int check : {CAR(node), CDR(node)}) {
+		if (check != -1) {
+			if (Sexp_nodes[check].value == SEXP_NAN)
+				return SEXP_FALSE;
+			if (Sexp_nodes[check].value == SEXP_NAN_FOREVER)
+				return SEXP_KNOWN_FALSE;
+		}
+	}
+
+	return SEXP_UNKNOWN;
+}
+
+// matches sexp_number_compare()
+int run_compare(const instruction& ins, const int* args)
+{
+	int first_number = run(args[0]);
+
+	int bail = compare_nan_check(Instructions[args[0]].node);
+	if (bail != SEXP_UNKNOWN)
+		return bail;
+
+	for (int i = 1; i < ins.num_args; ++i) {
+		bail = compare_nan_check(Instructions[args[i]].node);
+		if (bail != SEXP_UNKNOWN)
+			return bail;
+
+		int current_number = run(args[i]);
+
+		switch (ins.operand) {
+			case OP_EQUALS:
+				if (first_number != current_number) return SEXP_FALSE;
+				break;
+
+			case OP_NOT_EQUAL:
+				if (first_number == current_number) return SEXP_FALSE;
+				break;
+
+			case OP_GREATER_THAN:
+				if (first_number <= current_number) return SEXP_FALSE;
+				break;
+
+			case OP_GREATER_OR_EQUAL:
+				if (first_number < current_number) return SEXP_FALSE;
+				break;
+
+			case OP_LESS_THAN:
+				if (first_number >= current_number) return SEXP_FALSE;
+				break;
+
+			case OP_LESS_OR_EQUAL:
+				if (first_number > current_number) return SEXP_FALSE;
+				break;
+
+			default:
+				UNREACHABLE("Unhandled comparison operator %d!", ins.operand);
+				break;
+		}
+	}
+
+	return SEXP_TRUE;
+}
+
+// matches eval_when() for a plain when without arguments
+int run_when(const instruction& ins, const int* args)
+{
+	int val = run(args[0]);
+
+	if (val == SEXP_TRUE) {
+		for (int i = 1; i < ins.num_args; ++i) {
+			run(args[i]);
+		}
+	}
+
+	int cond_value = value_of(args[0]);
+	if (cond_value == SEXP_KNOWN_FALSE || cond_value == SEXP_NAN_FOREVER)
+		return SEXP_KNOWN_FALSE;
+
+	return val;
+}
+
+int run(int index)
+{
+	const auto& ins = Instructions[index];
+
+	switch (ins.op) {
+		case opcode::Tree:
+			return eval_sexp(ins.node);
+
+		case opcode::Action:
+			eval_when_do_one_exp(ins.node);
+			return SEXP_TRUE;
+
+		default:
+			break;
+	}
+
+	// the same short circuit eval_sexp() does for known values
+	switch (Sexp_nodes[ins.node].value) {
+		case SEXP_KNOWN_TRUE:
+			return SEXP_TRUE;
+
+		case SEXP_KNOWN_FALSE:
+		case SEXP_NAN_FOREVER:
+			return SEXP_FALSE;
+
+		default:
+			break;
+	}
+
+	const int* args = Arguments.data() + ins.first_arg;
+	int sexp_val;
+
+	switch (ins.op) {
+		case opcode::Number:
+			return ins.operand;
+
+		case opcode::Leaf:
+			return sexp_atoi(ins.node);
+
+		case opcode::List:
+			sexp_val = run(args[0]);
+			Sexp_nodes[ins.node].value = value_of(args[0]);
+			return sexp_val;
+
+		case opcode::True:
+			sexp_val = SEXP_KNOWN_TRUE;
+			break;
+
+		case opcode::False:
+			sexp_val = SEXP_KNOWN_FALSE;
+			break;
+
+		case opcode::And:
+			sexp_val = run_and(ins, args);
+			break;
+
+		case opcode::Or:
+			sexp_val = run_or(ins, args);
+			break;
+
+		case opcode::Not:
+			sexp_val = run_not(ins, args);
+			break;
+
+		case opcode::Plus:
+		case opcode::Minus:
+		case opcode::Mul:
+			sexp_val = run_arithmetic(ins, args);
+			break;
+
+		case opcode::Compare:
+			sexp_val = run_compare(ins, args);
+			break;
+
+		case opcode::When:
+			sexp_val = run_when(ins, args);
+			break;
+
+		default:
+			UNREACHABLE("Unhandled SEXP opcode %d!", static_cast<int>(ins.op));
+			return SEXP_FALSE;
+	}
+
+	return eval_sexp_finish(ins.node, sexp_val);
+}
+
+} // namespace
+
+namespace sexp {
+
+bool compile_formula(int node)
+{
+	Assertion(!Fred_running, "Compiled formulas rely on SEXP caching which is not set up to work in FRED!");
+
+	if (node < 0 || Sexp_nodes[node].first != -1) {
+		return false;
+	}
+
+	// the value of formulas with special arguments depends on the argument being evaluated
+	if (special_argument_appears_in_sexp_tree(node)) {
+		return false;
+	}
+
+	auto root = compile_node(node);
+	if (Instructions[root].op == opcode::Tree) {
+		// nothing would be gained
+		return false;
+	}
+
+	Formulas[node] = root;
+	Sexp_nodes[node].flags |= SNF_COMPILED_FORMULA;
+
+	return true;
+}
+
+int eval_compiled_formula(int node)
+{
+	auto iter = Formulas.find(node);
+	Assertion(iter != Formulas.end(), "Node %d is marked as compiled but has no program!", node);
+
+	return run(iter->second);
+}
+
+void clear_compiled_formulas()
+{
+	for (auto& formula : Formulas) {
+		if (formula.first < Num_sexp_nodes) {
+			Sexp_nodes[formula.first].flags &= ~SNF_COMPILED_FORMULA;
+		}
+	}
+
+	Formulas.clear();
+	Instructions.clear();
+	Arguments.clear();
+}
+
+} // namespace sexp
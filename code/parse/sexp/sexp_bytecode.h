@@ -0,0 +1,38 @@
+#pragma once
+
+namespace sexp {
+
+/**
+ * @brief Compiles the formula of an event or goal into a flat program
+ *
+ * The program stores the nodes of the formula in evaluation order with their arguments already resolved so
+ * evaluating it does not need to look up operators or walk the node list. Only the most common logical, arithmetic and
+ * comparison operators are executed by the program itself. Every other operator is handed back to eval_sexp() so the
+ * result is always identical to evaluating the tree.
+ *
+ * Formulas which use special arguments are not compiled since their value depends on the argument currently being
+ * evaluated.
+ *
+ * @param node The root node of the formula
+ * @return @c true if the formula was compiled, @c false if it will still be evaluated by the tree interpreter
+ */
+bool compile_formula(int node);
+
+/**
+ * @brief Evaluates a formula which was compiled by compile_formula()
+ *
+ * This is called by eval_sexp() for nodes that have the SNF_COMPILED_FORMULA flag.
+ *
+ * @param node The root node of the formula
+ * @return The same value eval_sexp() would have returned for the node
+ */
+int eval_compiled_formula(int node);
+
+/**
+ * @brief Removes all compiled programs
+ *
+ * This has to be called whenever the SEXP nodes are reset since the programs refer to node indices.
+ */
+void clear_compiled_formulas();
+
+} // namespace sexp
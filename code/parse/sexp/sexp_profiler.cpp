@@ -0,0 +1,284 @@
+#include "parse/sexp/sexp_profiler.h"
+
+#include "cfile/cfile.h"
+#include "debugconsole/console.h"
+#include "io/timer.h"
+#include "mission/missiongoals.h"
+#include "mission/missionparse.h"
+#include "parse/parselo.h"
+#include "parse/sexp.h"
+
+#include <algorithm>
+
+namespace {
+
+struct profile_entry {
+	std::uint64_t calls = 0;
+	std::uint64_t inclusive = 0;	// nanoseconds, including the operators called by this one
+	std::uint64_t exclusive = 0;	// nanoseconds, without the operators called by this one
+};
+
+struct profile_frame {
+	bool is_event;
+	int id;						// the operator constant or the event index
+	std::uint64_t start;
+	std::uint64_t children;		// inclusive time of the frames started while this one was running
+};
+
+struct report_row {
+	bool is_event;
+	SCP_string name;
+	profile_entry entry;
+};
+
+SCP_unordered_map<int, profile_entry> Operator_profiles;
+SCP_vector<profile_entry> Event_profiles;
+SCP_vector<profile_frame> Profile_stack;
+
+profile_entry* get_entry(const profile_frame& frame)
+{
+	if (frame.is_event) {
+		if (frame.id >= (int)Event_profiles.size())
+			Event_profiles.resize(frame.id + 1);
+
+		return &Event_profiles[frame.id];
+	}
+
+	return &Operator_profiles[frame.id];
+}
+
+void begin_frame(bool is_event, int id)
+{
+	Profile_stack.push_back({ is_event, id, timer_get_nanoseconds(), 0 });
+}
+
+void end_frame()
+{
+	// profiling may have been switched on while this was already being evaluated
+	if (Profile_stack.empty())
+		return;
+
+	auto frame = Profile_stack.back();
+	Profile_stack.pop_back();
+
+	auto elapsed = timer_get_nanoseconds() - frame.start;
+	auto entry = get_entry(frame);
+
+	entry->calls++;
+	entry->inclusive += elapsed;
+	entry->exclusive += (elapsed > frame.children) ? elapsed - frame.children : 0;
+
+	if (!Profile_stack.empty())
+		Profile_stack.back().children += elapsed;
+}
+
+const char* get_operator_name(int op_num)
+{
+	for (auto& op : Operators) {
+		if (op.value == op_num)
+			return op.text.c_str();
+	}
+
+	return "<unknown operator>";
+}
+
+SCP_vector<report_row> get_report_rows()
+{
+	SCP_vector<report_row> rows;
+
+	for (auto& pair : Operator_profiles)
+		rows.push_back({ false, get_operator_name(pair.first), pair.second });
+
+	for (int i = 0; i < (int)Event_profiles.size(); i++) {
+		if (Event_profiles[i].calls == 0)
+			continue;
+
+		SCP_string name;
+		if (i < Num_mission_events)
+			name = Mission_events[i].name;
+		else
+			sprintf(name, "<event %d>", i);
+
+		rows.push_back({ true, name, Event_profiles[i] });
+	}
+
+	// the most expensive entries first.  Events come first and are sorted by their inclusive time since almost all
+	// of their time is spent in their operators.
+	std::sort(rows.begin(), rows.end(), [](const report_row& a, const report_row& b) {
+		if (a.is_event != b.is_event)
+			return a.is_event;
+
+		auto a_time = a.is_event ? a.entry.inclusive : a.entry.exclusive;
+		auto b_time = b.is_event ? b.entry.inclusive : b.entry.exclusive;
+		if (a_time != b_time)
+			return a_time > b_time;
+
+		return a.name < b.name;
+	});
+
+	return rows;
+}
+
+SCP_vector<SCP_string> format_report(size_t max_rows)
+{
+	SCP_vector<SCP_string> lines;
+	SCP_string line;
+
+	auto rows = get_report_rows();
+	bool events_done = false;
+	size_t count = 0;
+
+	sprintf(line, "%-8s %-32s %10s %14s %14s %12s", "Type", "Name", "Calls", "Inclusive ms", "Exclusive ms", "Avg us");
+	lines.push_back(line);
+
+	for (auto& row : rows) {
+		// the limit applies to events and operators separately
+		if (!row.is_event && !events_done) {
+			events_done = true;
+			count = 0;
+		}
+		if (max_rows > 0 && count++ >= max_rows)
+			continue;
+
+		sprintf(line, "%-8s %-32s %10llu %14.3f %14.3f %12.3f", row.is_event ? "event" : "operator", row.name.c_str(),
+			(unsigned long long)row.entry.calls, row.entry.inclusive / 1000000.0, row.entry.exclusive / 1000000.0,
+			row.entry.inclusive / 1000.0 / row.entry.calls);
+		lines.push_back(line);
+	}
+
+	return lines;
+}
+
+SCP_string csv_quote(const SCP_string& text)
+{
+	SCP_string quoted = "\"";
+	for (auto c : text) {
+		if (c == '"')
+			quoted += '"';
+		quoted += c;
+	}
+	quoted += '"';
+
+	return quoted;
+}
+
+} // namespace
+
+namespace sexp {
+
+bool Profiler_enabled = false;
+
+void profiler_begin_operator(int op_num)
+{
+	begin_frame(false, op_num);
+}
+
+void profiler_end_operator()
+{
+	end_frame();
+}
+
+void profiler_begin_event(int event)
+{
+	begin_frame(true, event);
+}
+
+void profiler_end_event()
+{
+	end_frame();
+}
+
+void profiler_reset()
+{
+	Operator_profiles.clear();
+	Event_profiles.clear();
+	Profile_stack.clear();
+}
+
+void profiler_log_report()
+{
+	mprintf(("SEXP profile of mission '%s':\n", The_mission.name));
+	for (auto& line : format_report(0))
+		mprintf(("%s\n", line.c_str()));
+}
+
+bool profiler_write_csv(const char* filename)
+{
+	auto out = cfopen(filename, "wt", CFILE_NORMAL, CF_TYPE_DATA, false,
+		CF_LOCATION_ROOT_USER | CF_LOCATION_ROOT_GAME | CF_LOCATION_TYPE_ROOT);
+	if (out == nullptr) {
+		mprintf(("Could not open %s for writing the SEXP profile!\n", filename));
+		return false;
+	}
+
+	cfputs("type,name,calls,inclusive_us,exclusive_us\n", out);
+	for (auto& row : get_report_rows()) {
+		SCP_string line = row.is_event ? "event" : "operator";
+		line += "," + csv_quote(row.name);
+		line += "," + std::to_string(row.entry.calls);
+		line += "," + std::to_string(row.entry.inclusive / 1000);
+		line += "," + std::to_string(row.entry.exclusive / 1000) + "\n";
+
+		cfputs(line.c_str(), out);
+	}
+
+	cfclose(out);
+	return true;
+}
+
+void profiler_mission_end()
+{
+	if (!Operator_profiles.empty() || !Event_profiles.empty()) {
+		profiler_log_report();
+		profiler_write_csv("sexp_profile.csv");
+	}
+
+	profiler_reset();
+}
+
+} // namespace sexp
+
+DCF(sexp_profile, "Profiles the evaluation of SEXP operators and mission events")
+{
+	if (dc_optional_string_either("help", "--help")) {
+		dc_printf("Usage: sexp_profile [arg]\nWhere arg can be any of the following:\n");
+		dc_printf("\ton          Starts measuring.\n");
+		dc_printf("\toff         Stops measuring. The measurements are kept.\n");
+		dc_printf("\treset       Discards all measurements.\n");
+		dc_printf("\treport [x]  Shows the x most expensive events and operators. (Default is 20, 0 shows all.)\n");
+		dc_printf("\tcsv         Writes all measurements to data/sexp_profile.csv in the user directory.\n");
+		dc_printf("\t?           Displays whether the profiler is running.\n");
+		dc_printf("The measurements are written to the log and to sexp_profile.csv when the mission ends.\n");
+		dc_printf("The file is comma separated, with names in double quotes.\n");
+		return;
+	}
+
+	if (dc_optional_string_either("status", "--status") || dc_optional_string_either("?", "--?")) {
+		dc_printf("SEXP profiling is %s\n", sexp::Profiler_enabled ? "ON" : "OFF");
+		return;
+	}
+
+	if (dc_optional_string("on")) {
+		sexp::Profiler_enabled = true;
+		dc_printf("SEXP profiling is ON\n");
+	} else if (dc_optional_string("off")) {
+		sexp::Profiler_enabled = false;
+		dc_printf("SEXP profiling is OFF\n");
+	} else if (dc_optional_string("reset")) {
+		sexp::profiler_reset();
+		dc_printf("SEXP profile reset\n");
+	} else if (dc_optional_string("report")) {
+		int max_rows = 20;
+		dc_maybe_stuff_int(&max_rows);
+
+		for (auto& line : format_report(max_rows > 0 ? (size_t)max_rows : 0))
+			dc_printf("%s\n", line.c_str());
+	} else if (dc_optional_string("csv")) {
+		if (sexp::profiler_write_csv("sexp_profile.csv"))
+			dc_printf("SEXP profile written to sexp_profile.csv\n");
+		else
+			dc_printf("Could not write sexp_profile.csv\n");
+	} else {
+		dc_printf("<sexp_profile> No argument given\n");
+	}
+}
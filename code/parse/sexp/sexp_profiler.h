@@ -0,0 +1,61 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+namespace sexp {
+
+/**
+ * @brief Set while SEXP evaluation is being profiled
+ *
+ * Enabled by -profile_sexp or the sexp_profile debug console command. The hooks below must only be called while this
+ * is set so the profiler costs nothing otherwise.
+ */
+extern bool Profiler_enabled;
+
+/**
+ * @brief Starts timing an operator
+ * @param op_num The operator constant, e.g. OP_AND
+ */
+void profiler_begin_operator(int op_num);
+
+/**
+ * @brief Stops timing the operator passed to the matching profiler_begin_operator()
+ */
+void profiler_end_operator();
+
+/**
+ * @brief Starts timing the formula of a mission event
+ * @param event The index into Mission_events
+ */
+void profiler_begin_event(int event);
+
+/**
+ * @brief Stops timing the event passed to the matching profiler_begin_event()
+ */
+void profiler_end_event();
+
+/**
+ * @brief Discards everything that has been measured so far
+ */
+void profiler_reset();
+
+/**
+ * @brief Writes the measurements to the log, the most expensive events and operators first
+ */
+void profiler_log_report();
+
+/**
+ * @brief Writes the measurements to a comma separated file in the data directory of the user
+ * @param filename The name of the file
+ * @return @c true if the file was written
+ */
+bool profiler_write_csv(const char* filename);
+
+/**
+ * @brief Reports the measurements of the mission that is ending and starts over for the next one
+ *
+ * This has to be called while the mission events still exist since the report refers to them by name.
+ */
+void profiler_mission_end();
+
+} // namespace sexp
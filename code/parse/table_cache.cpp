@@ -0,0 +1,179 @@
+#include "parse/table_cache.h"
+
+#include "cfile/cfile.h"
+#include "cfile/cfilecache.h"
+#include "cmdline/cmdline.h"
+#include "globalincs/version.h"
+#include "localization/localize.h"
+#include "mod_table/mod_table.h"
+#include "parse/parselo.h"
+
+#include <climits>
+
+namespace {
+
+const cf_cache_type TBL_CACHE_TYPE = { "tbl_cache-", 0x43544246 /* "FBTC" */, 2 };
+
+// settings which change the output of process_raw_file_text()
+const int TBL_CACHE_UNICODE = 1 << 0;
+const int TBL_CACHE_POLISH  = 1 << 1;
+const int TBL_CACHE_FRED    = 1 << 2;
+
+struct tbl_cache_key {
+	uint raw_checksum = 0;
+	uint raw_size     = 0;
+	int flags         = 0;
+
+	// the ;;FSO x.y.z;; comments are stripped depending on the engine version
+	int version_major = FS_VERSION_MAJOR;
+	int version_minor = FS_VERSION_MINOR;
+	int version_build = FS_VERSION_BUILD;
+	int version_revis = FS_VERSION_REVIS;
+};
+
+struct tbl_cache_header {
+	cf_cache_header base;
+
+	// The key, to protect against hash collisions
+	uint raw_checksum;
+	uint raw_size;
+	int flags;
+	int version_major;
+	int version_minor;
+	int version_build;
+	int version_revis;
+
+	uint data_size;
+};
+
+bool make_key(tbl_cache_key* key, const char* raw_text, size_t size)
+{
+	if (size > UINT_MAX) {
+		return false;
+	}
+
+	key->raw_size     = (uint)size;
+	key->raw_checksum = cf_add_chksum_long(0, reinterpret_cast<ubyte*>(const_cast<char*>(raw_text)), size);
+
+	key->flags = 0;
+	if (Unicode_text_mode) {
+		key->flags |= TBL_CACHE_UNICODE;
+	}
+	if (Lcl_pl) {
+		key->flags |= TBL_CACHE_POLISH;
+	}
+	if (Fred_running) {
+		key->flags |= TBL_CACHE_FRED;
+	}
+
+	return true;
+}
+
+void fill_header(tbl_cache_header* header, const tbl_cache_key& key)
+{
+	memset(header, 0, sizeof(*header));
+
+	cf_cache_fill_header(&header->base, TBL_CACHE_TYPE);
+	header->raw_checksum = key.raw_checksum;
+	header->raw_size     = key.raw_size;
+	header->flags        = key.flags;
+
+	header->version_major = key.version_major;
+	header->version_minor = key.version_minor;
+	header->version_build = key.version_build;
+	header->version_revis = key.version_revis;
+}
+
+bool header_matches(const tbl_cache_header& header, const tbl_cache_key& key)
+{
+	tbl_cache_header expected;
+	fill_header(&expected, key);
+
+	return cf_cache_header_matches(header.base, TBL_CACHE_TYPE)
+		&& header.raw_checksum == expected.raw_checksum && header.raw_size == expected.raw_size
+		&& header.flags == expected.flags && header.version_major == expected.version_major
+		&& header.version_minor == expected.version_minor && header.version_build == expected.version_build
+		&& header.version_revis == expected.version_revis;
+}
+
+SCP_string get_cache_filename(const tbl_cache_key& key)
+{
+	SCP_string key_string;
+	sprintf(key_string, "%08x:%u:%d:%d.%d.%d.%d", key.raw_checksum, key.raw_size, key.flags, key.version_major,
+		key.version_minor, key.version_build, key.version_revis);
+
+	return cf_cache_get_filename(TBL_CACHE_TYPE, key_string);
+}
+
+} // namespace
+
+bool table_cache_enabled()
+{
+	return Cmdline_table_cache;
+}
+
+bool table_cache_read(const char* raw_text, size_t raw_len, char* processed_text, size_t capacity)
+{
+	tbl_cache_key key;
+	if (!make_key(&key, raw_text, raw_len)) {
+		return false;
+	}
+
+	auto filename = get_cache_filename(key);
+
+	auto cfp = cf_cache_open_read(filename);
+	if (cfp == nullptr) {
+		return false;
+	}
+
+	tbl_cache_header header;
+	bool valid = false;
+
+	if (cfread(&header, sizeof(header), 1, cfp) == 1 && header_matches(header, key)
+		&& header.data_size < capacity && static_cast<size_t>(cfilelength(cfp)) == sizeof(header) + header.data_size
+		&& (header.data_size == 0 || cfread(processed_text, (int)header.data_size, 1, cfp) == 1)) {
+		processed_text[header.data_size] = '\0';
+		valid = true;
+	}
+
+	cfclose(cfp);
+
+	if (!valid) {
+		nprintf(("TableCache", "Cache file %s does not match its key.\n", filename.c_str()));
+	}
+	return valid;
+}
+
+void table_cache_write(const char* raw_text, size_t raw_len, const char* processed_text)
+{
+	tbl_cache_key key;
+	if (!make_key(&key, raw_text, raw_len)) {
+		return;
+	}
+
+	auto size = strlen(processed_text);
+	if (size > UINT_MAX) {
+		return;
+	}
+
+	auto filename = get_cache_filename(key);
+
+	auto cfp = cf_cache_open_write(filename);
+	if (cfp == nullptr) {
+		return;
+	}
+
+	tbl_cache_header header;
+	fill_header(&header, key);
+	header.data_size = (uint)size;
+
+	bool success = cfwrite(&header, sizeof(header), 1, cfp) == 1
+		&& (size == 0 || cfwrite(processed_text, (int)size, 1, cfp) == 1);
+
+	cf_cache_close_write(cfp, filename, success);
+}
+
+void table_cache_purge_old()
+{
+	cf_cache_purge_old(TBL_CACHE_TYPE);
+}
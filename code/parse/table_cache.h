@@ -0,0 +1,42 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+/**
+ * @brief Checks if preprocessed table text should be cached on disk
+ *
+ * Mission files are preprocessed the same way and share the cache. Only the comment stripping and encoding handling
+ * of process_raw_file_text() is skipped, the text is still parsed into the game structures on every start. The
+ * ParseloBench benchmarks compare both parts.
+ */
+bool table_cache_enabled();
+
+/**
+ * @brief Reads the preprocessed text of a table file from the cache
+ *
+ * The cache is keyed by a checksum of the raw text, the settings which change the preprocessing and the engine version,
+ * which decides the version specific comments that are stripped. An entry automatically becomes invalid once the table
+ * file changes or a different build reads it. Old entries are removed by table_cache_purge_old().
+ *
+ * @param[in] raw_text       The raw text of the table, as read from the file
+ * @param[in] raw_len        The length of the raw text, which does not need to be null-terminated
+ * @param[out] processed_text The buffer which receives the text with the comments stripped
+ * @param[in] capacity       The size of processed_text in characters, including the terminating null character
+ *
+ * @returns true if the text was found in the cache
+ */
+bool table_cache_read(const char* raw_text, size_t raw_len, char* processed_text, size_t capacity);
+
+/**
+ * @brief Stores the preprocessed text of a table file in the cache
+ *
+ * @param[in] raw_text       The raw text of the table
+ * @param[in] raw_len        The length of the raw text
+ * @param[in] processed_text The text produced by process_raw_file_text()
+ */
+void table_cache_write(const char* raw_text, size_t raw_len, const char* processed_text);
+
+/**
+ * @brief Removes cache entries which have not been written in a long time
+ */
+void table_cache_purge_old();
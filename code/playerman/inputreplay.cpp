@@ -0,0 +1,510 @@
+
+#include "playerman/inputreplay.h"
+
+#include "cfile/cfile.h"
+#include "cmdline/cmdline.h"
+#include "freespace.h"
+#include "globalincs/linklist.h"
+#include "globalincs/systemvars.h"
+#include "io/keycontrol.h"
+#include "io/timer.h"
+#include "math/staticrand.h"
+#include "object/object.h"
+#include "parse/encrypt.h"
+#include "parse/parselo.h"
+#include "physics/physics.h"
+#include "utils/Random.h"
+
+namespace {
+
+const uint INPUT_REPLAY_MAGIC = 0x50525346; // "FSRP"
+const int INPUT_REPLAY_VERSION = 2;
+
+const ubyte FRAME_CONTROLS_READ    = 1 << 0;
+const ubyte FRAME_GLIDING          = 1 << 1;
+const ubyte FRAME_HAS_CONTROL_INFO = 1 << 2;
+
+// flags, time delta, frame time, real frame time, time compression and state hash
+const int FRAME_SIZE = 1 + 5 * 4;
+// the button info and the number of keys
+const int FRAME_BUTTONS_SIZE = NUM_BUTTON_FIELDS * 4 + 2;
+// 7 floats and 7 ints of the control info
+const int FRAME_CONTROL_INFO_SIZE = 14 * 4;
+
+enum class replay_mode { None, Recording, Playing };
+
+// The part of an object which is compared between the recording and the playback
+struct object_state {
+	int signature;
+	int type;
+	vec3d pos;
+	matrix orient;
+	vec3d vel;
+	vec3d rotvel;
+	float hull_strength;
+};
+
+replay_mode Replay_mode = replay_mode::None;
+bool Replay_done = false; // only the first mission is recorded or played back
+
+CFILE* Record_file = nullptr;
+
+bool Replay_loaded = false;
+bool Replay_valid = false;
+SCP_string Replay_mission;
+uint Replay_seed = 0;
+uint64_t Replay_start_time = 0;
+SCP_vector<input_replay_frame> Replay_frames;
+
+input_replay_frame Current_frame; // the frame being recorded
+size_t Frame_num = 0;
+size_t Key_index = 0;
+uint64_t Last_time = 0;
+int Divergent_frame = -1;
+
+uint hash_object_states()
+{
+	static SCP_vector<object_state> states;
+	states.clear();
+
+	for (auto objp = GET_FIRST(&obj_used_list); objp != END_OF_LIST(&obj_used_list); objp = GET_NEXT(objp)) {
+		object_state state;
+
+		state.signature     = objp->signature;
+		state.type          = objp->type;
+		state.pos           = objp->pos;
+		state.orient        = objp->orient;
+		state.vel           = objp->phys_info.vel;
+		state.rotvel        = objp->phys_info.rotvel;
+		state.hull_strength = objp->hull_strength;
+
+		states.push_back(state);
+	}
+
+	uint values[2];
+	values[0] = hash_fnv1a(states.data(), states.size() * sizeof(object_state));
+	values[1] = static_cast<uint>(Missiontime);
+
+	return hash_fnv1a(values, sizeof(values));
+}
+
+// The mission file names may or may not have an extension
+bool same_mission(const char* left, const char* right)
+{
+	SCP_string left_name(left);
+	SCP_string right_name(right);
+	drop_extension(left_name);
+	drop_extension(right_name);
+
+	return !stricmp(left_name.c_str(), right_name.c_str());
+}
+
+bool load_replay()
+{
+	if (Replay_loaded) {
+		return Replay_valid;
+	}
+	Replay_loaded = true;
+
+	auto fp = cfopen(Cmdline_replay_input, "rb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	if (fp == nullptr) {
+		mprintf(("Input replay: could not open %s!\n", Cmdline_replay_input));
+		return false;
+	}
+
+	if (cfread_uint(fp) != INPUT_REPLAY_MAGIC || cfread_int(fp) != INPUT_REPLAY_VERSION) {
+		mprintf(("Input replay: %s is not a recording of this version!\n", Cmdline_replay_input));
+		cfclose(fp);
+		return false;
+	}
+
+	Replay_mission = cfread_string_len(fp);
+	Replay_seed = cfread_uint(fp);
+
+	auto start_low = static_cast<uint64_t>(cfread_uint(fp));
+	auto start_high = static_cast<uint64_t>(cfread_uint(fp));
+	Replay_start_time = (start_high << 32) | start_low;
+
+	Replay_frames.clear();
+	while (!cfeof(fp)) {
+		input_replay_frame frame;
+
+		if (!input_replay_read_frame(&frame, fp)) {
+			mprintf(("Input replay: %s was cut short, only the first " SIZE_T_ARG " frames are played back\n", Cmdline_replay_input, Replay_frames.size()));
+			break;
+		}
+
+		Replay_frames.push_back(std::move(frame));
+	}
+
+	cfclose(fp);
+
+	Replay_valid = true;
+	return true;
+}
+
+void start_recording(const char* mission_filename)
+{
+	Record_file = cfopen(Cmdline_record_input, "wb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	if (Record_file == nullptr) {
+		mprintf(("Input replay: could not open %s for recording!\n", Cmdline_record_input));
+		return;
+	}
+
+	Replay_seed = static_cast<uint>(time(nullptr));
+	Last_time = timestamp_get_microseconds();
+
+	cfwrite_uint(INPUT_REPLAY_MAGIC, Record_file);
+	cfwrite_int(INPUT_REPLAY_VERSION, Record_file);
+	cfwrite_string_len(mission_filename, Record_file);
+	cfwrite_uint(Replay_seed, Record_file);
+	cfwrite_uint(static_cast<uint>(Last_time & 0xffffffff), Record_file);
+	cfwrite_uint(static_cast<uint>(Last_time >> 32), Record_file);
+
+	Replay_mode = replay_mode::Recording;
+	mprintf(("Input replay: recording mission %s to %s\n", mission_filename, Cmdline_record_input));
+}
+
+void start_playback(const char* mission_filename)
+{
+	if (!load_replay()) {
+		return;
+	}
+
+	if (!same_mission(Replay_mission.c_str(), mission_filename)) {
+		mprintf(("Input replay: %s was recorded in mission %s, not %s!\n", Cmdline_replay_input, Replay_mission.c_str(), mission_filename));
+		return;
+	}
+
+	Last_time = Replay_start_time;
+	Divergent_frame = -1;
+
+	Replay_mode = replay_mode::Playing;
+	mprintf(("Input replay: playing back " SIZE_T_ARG " frames from %s\n", Replay_frames.size(), Cmdline_replay_input));
+}
+
+void stop_replay()
+{
+	if (Replay_mode == replay_mode::Recording) {
+		cfclose(Record_file);
+		Record_file = nullptr;
+
+		mprintf(("Input replay: recorded " SIZE_T_ARG " frames\n", Frame_num));
+	} else if (Replay_mode == replay_mode::Playing) {
+		if (Divergent_frame >= 0) {
+			mprintf(("Input replay: played back " SIZE_T_ARG " frames, the first divergence was in frame %d\n", Frame_num, Divergent_frame));
+		} else {
+			mprintf(("Input replay: played back " SIZE_T_ARG " frames without divergence\n", Frame_num));
+		}
+	}
+
+	// The timestamps of the playback are based on the clock of the recording. If the mission goes on after the recording
+	// ended, it has to continue from there or everything that was set during the playback would fire at the wrong time.
+	timestamp_unfreeze(Replay_mode == replay_mode::Playing);
+
+	Replay_mode = replay_mode::None;
+	Replay_done = true;
+}
+
+} // namespace
+
+bool input_replay_recording()
+{
+	return Replay_mode == replay_mode::Recording;
+}
+
+bool input_replay_playing()
+{
+	return Replay_mode == replay_mode::Playing;
+}
+
+void input_replay_level_init(const char* mission_filename)
+{
+	if (Replay_done || (Cmdline_record_input == nullptr && Cmdline_replay_input == nullptr)) {
+		return;
+	}
+
+	if (Game_mode & GM_MULTIPLAYER) {
+		mprintf(("Input replay: multiplayer missions can't be recorded or played back.\n"));
+		Replay_done = true;
+		return;
+	}
+
+	Frame_num = 0;
+
+	if (Cmdline_replay_input != nullptr) {
+		start_playback(mission_filename);
+	} else {
+		start_recording(mission_filename);
+	}
+
+	if (Replay_mode == replay_mode::None) {
+		Replay_done = true;
+		return;
+	}
+
+	Random::seed(Replay_seed);
+	init_semirand();
+
+	// The level load sees the same time as well
+	timestamp_freeze(Last_time);
+}
+
+void input_replay_level_close()
+{
+	if (Replay_mode != replay_mode::None) {
+		stop_replay();
+	}
+}
+
+bool input_replay_frame_start()
+{
+	if (Replay_mode == replay_mode::Recording) {
+		timestamp_unfreeze();
+		auto now = std::max(timestamp_get_microseconds(), Last_time);
+		timestamp_freeze(now);
+
+		Current_frame = input_replay_frame();
+		Current_frame.time_delta = static_cast<uint>(now - Last_time);
+		Current_frame.frametime = Frametime;
+		Current_frame.real_frametime = flRealframetime;
+		Current_frame.time_compression = Game_time_compression;
+
+		Last_time = now;
+		return true;
+	}
+
+	if (Replay_mode == replay_mode::Playing) {
+		if (Frame_num >= Replay_frames.size()) {
+			mprintf(("Input replay: reached the end of the recording.\n"));
+			stop_replay();
+			return false;
+		}
+
+		auto& frame = Replay_frames[Frame_num];
+
+		Last_time += frame.time_delta;
+		timestamp_freeze(Last_time);
+
+		Frametime = frame.frametime;
+		flFrametime = f2fl(Frametime);
+		flRealframetime = frame.real_frametime;
+
+		Game_time_compression = frame.time_compression;
+		timestamp_update_time_compression();
+
+		Key_index = 0;
+		return true;
+	}
+
+	return false;
+}
+
+void input_replay_frame_end()
+{
+	if (Replay_mode == replay_mode::Recording) {
+		Current_frame.state_hash = hash_object_states();
+		input_replay_write_frame(Current_frame, Record_file);
+
+		++Frame_num;
+		timestamp_unfreeze();
+	} else if (Replay_mode == replay_mode::Playing) {
+		auto hash = hash_object_states();
+
+		if (Divergent_frame < 0 && hash != Replay_frames[Frame_num].state_hash) {
+			Divergent_frame = static_cast<int>(Frame_num);
+			mprintf(("Input replay: the object states diverged from the recording in frame %d (mission time %.3f)!\n", Divergent_frame, f2fl(Missiontime)));
+		}
+
+		++Frame_num;
+	}
+}
+
+bool input_replay_frame_controls_read()
+{
+	return Replay_mode == replay_mode::Playing && Replay_frames[Frame_num].controls_read;
+}
+
+void input_replay_record_key(int k)
+{
+	if (Replay_mode == replay_mode::Recording && k != 0) {
+		Current_frame.keys.push_back(k);
+	}
+}
+
+int input_replay_next_key()
+{
+	Assertion(Replay_mode == replay_mode::Playing, "Keys can only be read from a recording during playback!");
+
+	auto& keys = Replay_frames[Frame_num].keys;
+	if (Key_index >= keys.size()) {
+		return 0;
+	}
+
+	return keys[Key_index++];
+}
+
+void input_replay_buttons(button_info* bi)
+{
+	if (Replay_mode == replay_mode::Recording) {
+		Current_frame.bi = *bi;
+		Current_frame.controls_read = true;
+	} else if (Replay_mode == replay_mode::Playing) {
+		*bi = Replay_frames[Frame_num].bi;
+	}
+}
+
+void input_replay_controls(control_info* ci)
+{
+	if (Replay_mode == replay_mode::Recording) {
+		Current_frame.ci = *ci;
+		Current_frame.gliding = (Player_obj->phys_info.flags & PF_GLIDING) != 0;
+		Current_frame.has_control_info = true;
+	} else if (Replay_mode == replay_mode::Playing) {
+		auto& frame = Replay_frames[Frame_num];
+
+		*ci = frame.ci;
+
+		if (((Player_obj->phys_info.flags & PF_GLIDING) != 0) != frame.gliding) {
+			object_set_gliding(Player_obj, frame.gliding);
+		}
+	}
+}
+
+int input_replay_get_divergent_frame()
+{
+	return Divergent_frame;
+}
+
+int input_replay_get_num_frames_played()
+{
+	return static_cast<int>(Frame_num);
+}
+
+input_replay_frame::input_replay_frame()
+{
+	memset(&ci, 0, sizeof(ci));
+	memset(&bi, 0, sizeof(bi));
+}
+
+void input_replay_write_frame(const input_replay_frame& frame, CFILE* fp)
+{
+	ubyte flags = 0;
+	if (frame.controls_read) {
+		flags |= FRAME_CONTROLS_READ;
+	}
+	if (frame.gliding) {
+		flags |= FRAME_GLIDING;
+	}
+	// the control info is only stored along with the rest of the input
+	if (frame.controls_read && frame.has_control_info) {
+		flags |= FRAME_HAS_CONTROL_INFO;
+	}
+
+	cfwrite_ubyte(flags, fp);
+	cfwrite_uint(frame.time_delta, fp);
+	cfwrite_int(frame.frametime, fp);
+	cfwrite_float(frame.real_frametime, fp);
+	cfwrite_int(frame.time_compression, fp);
+	cfwrite_uint(frame.state_hash, fp);
+
+	if (!(flags & FRAME_CONTROLS_READ)) {
+		return;
+	}
+
+	for (auto status : frame.bi.status) {
+		cfwrite_int(status, fp);
+	}
+
+	cfwrite_ushort(static_cast<ushort>(frame.keys.size()), fp);
+	for (auto key : frame.keys) {
+		cfwrite_int(key, fp);
+	}
+
+	if (!(flags & FRAME_HAS_CONTROL_INFO)) {
+		return;
+	}
+
+	cfwrite_float(frame.ci.pitch, fp);
+	cfwrite_float(frame.ci.vertical, fp);
+	cfwrite_float(frame.ci.heading, fp);
+	cfwrite_float(frame.ci.sideways, fp);
+	cfwrite_float(frame.ci.bank, fp);
+	cfwrite_float(frame.ci.forward, fp);
+	cfwrite_float(frame.ci.forward_cruise_percent, fp);
+	cfwrite_int(frame.ci.fire_primary_count, fp);
+	cfwrite_int(frame.ci.fire_secondary_count, fp);
+	cfwrite_int(frame.ci.fire_countermeasure_count, fp);
+	cfwrite_int(frame.ci.fire_debug_count, fp);
+	cfwrite_int(frame.ci.afterburner_start, fp);
+	cfwrite_int(frame.ci.afterburner_stop, fp);
+	cfwrite_int(frame.ci.control_flags, fp);
+}
+
+// A recording that was cut short, e.g. by a crash, ends in the middle of a frame so this checks that there is enough
+// data left before every part of the frame
+bool input_replay_read_frame(input_replay_frame* frame, CFILE* fp)
+{
+	auto remaining = [fp]() { return cfilelength(fp) - cftell(fp); };
+
+	if (remaining() < FRAME_SIZE) {
+		return false;
+	}
+
+	auto flags = cfread_ubyte(fp);
+
+	frame->controls_read    = (flags & FRAME_CONTROLS_READ) != 0;
+	frame->gliding          = (flags & FRAME_GLIDING) != 0;
+	frame->has_control_info = (flags & FRAME_HAS_CONTROL_INFO) != 0;
+	frame->time_delta       = cfread_uint(fp);
+	frame->frametime        = cfread_int(fp);
+	frame->real_frametime   = cfread_float(fp);
+	frame->time_compression = cfread_int(fp);
+	frame->state_hash       = cfread_uint(fp);
+
+	if (!frame->controls_read) {
+		return true;
+	}
+
+	if (remaining() < FRAME_BUTTONS_SIZE) {
+		return false;
+	}
+
+	for (auto& status : frame->bi.status) {
+		status = cfread_int(fp);
+	}
+
+	frame->keys.resize(cfread_ushort(fp));
+	if (remaining() < static_cast<int>(frame->keys.size()) * 4) {
+		return false;
+	}
+
+	for (auto& key : frame->keys) {
+		key = cfread_int(fp);
+	}
+
+	if (!frame->has_control_info) {
+		return true;
+	}
+
+	if (remaining() < FRAME_CONTROL_INFO_SIZE) {
+		return false;
+	}
+
+	frame->ci.pitch                     = cfread_float(fp);
+	frame->ci.vertical                  = cfread_float(fp);
+	frame->ci.heading                   = cfread_float(fp);
+	frame->ci.sideways                  = cfread_float(fp);
+	frame->ci.bank                      = cfread_float(fp);
+	frame->ci.forward                   = cfread_float(fp);
+	frame->ci.forward_cruise_percent    = cfread_float(fp);
+	frame->ci.fire_primary_count        = cfread_int(fp);
+	frame->ci.fire_secondary_count      = cfread_int(fp);
+	frame->ci.fire_countermeasure_count = cfread_int(fp);
+	frame->ci.fire_debug_count          = cfread_int(fp);
+	frame->ci.afterburner_start         = cfread_int(fp);
+	frame->ci.afterburner_stop          = cfread_int(fp);
+	frame->ci.control_flags             = cfread_int(fp);
+
+	return true;
+}
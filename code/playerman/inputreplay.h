@@ -0,0 +1,133 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+#include "io/keycontrol.h"
+#include "physics/physics.h"
+
+struct CFILE;
+
+/**
+ * @file
+ *
+ * Records the input of the player during a mission and plays it back so that a mission run can be repeated exactly,
+ * e.g. to profile it. Enabled with -record_input or -replay_input.
+ *
+ * A recording stores the random seed and, for every frame, the frame time, the timestamp time, the key presses, the
+ * button and control info of the player and a hash of the object states. Every frame sees a single frozen point in
+ * time so that everything that depends on timestamps happens in the same frame again. During playback the object
+ * states are hashed again and the first frame which does not match is reported.
+ */
+
+/**
+ * @brief Checks if the input of the current mission is being recorded
+ */
+bool input_replay_recording();
+
+/**
+ * @brief Checks if the input of the current mission comes from a recording
+ */
+bool input_replay_playing();
+
+/**
+ * @brief Starts recording or playing back the input for a mission
+ *
+ * Must be called before the mission start is set for the timestamps since it seeds the random number generator and
+ * freezes the timestamps.
+ *
+ * @param[in] mission_filename The mission which is about to be loaded
+ */
+void input_replay_level_init(const char* mission_filename);
+
+/**
+ * @brief Finishes the recording or playback, only the first mission is recorded or played back
+ */
+void input_replay_level_close();
+
+/**
+ * @brief Begins a frame of the mission
+ *
+ * Must be called after the frame time was set and before the mission time is updated. During playback this sets the
+ * frame time and the timestamps from the recording.
+ *
+ * @returns false if there was no frame to play back
+ */
+bool input_replay_frame_start();
+
+/**
+ * @brief Ends a frame of the mission after it was simulated
+ */
+void input_replay_frame_end();
+
+/**
+ * @brief Checks if the player input was read in the current frame of the playback
+ *
+ * This is independent of the control mode of the player; during a warpout the keys are still read but the controls are
+ * not.
+ */
+bool input_replay_frame_controls_read();
+
+/**
+ * @brief Records a key which was pressed in this frame
+ */
+void input_replay_record_key(int k);
+
+/**
+ * @brief Gets the next key which was pressed in this frame of the playback
+ * @returns The key, or 0 if there are no more keys in this frame
+ */
+int input_replay_next_key();
+
+/**
+ * @brief Records the buttons of the player in this frame or replaces them with the recorded ones
+ */
+void input_replay_buttons(button_info* bi);
+
+/**
+ * @brief Records the controls of the player in this frame or replaces them with the recorded ones
+ */
+void input_replay_controls(control_info* ci);
+
+/**
+ * @brief Gets the first frame in which the object states of the playback did not match the recording
+ * @returns The frame number, or -1 if there was no mismatch
+ */
+int input_replay_get_divergent_frame();
+
+/**
+ * @brief Gets the number of frames which were played back
+ */
+int input_replay_get_num_frames_played();
+
+/**
+ * @brief A single frame of a recording
+ */
+struct input_replay_frame {
+	bool controls_read = false;    // the keys and buttons were read in this frame
+	bool has_control_info = false; // the controls were read as well, only done in the normal control mode
+	bool gliding = false;          // set directly by the glide controls instead of going through the control info
+
+	uint time_delta = 0; // timestamp time since the last frame, in microseconds
+	fix frametime = 0;
+	float real_frametime = 0.0f;
+	fix time_compression = F1_0;
+
+	uint state_hash = 0;
+
+	control_info ci;
+	button_info bi;
+	SCP_vector<int> keys;
+
+	input_replay_frame();
+};
+
+/**
+ * @brief Writes a frame to a recording
+ */
+void input_replay_write_frame(const input_replay_frame& frame, CFILE* fp);
+
+/**
+ * @brief Reads a frame from a recording
+ *
+ * @returns false if the recording ends before the frame does, e.g. because it was cut short by a crash
+ */
+bool input_replay_read_frame(input_replay_frame* frame, CFILE* fp);
@@ -33,6 +33,7 @@
 #include "object/objectdock.h"
 #include "observer/observer.h"
 #include "parse/parselo.h"
+#include "playerman/inputreplay.h"
 #include "playerman/player.h"
 #include "ship/ship.h"
 #include "ship/shipfx.h"
@@ -972,6 +973,9 @@ void read_player_controls(object *objp, float frametime)
 		case PCM_NORMAL:
 			read_keyboard_controls(&(Player->ci), frametime, &objp->phys_info );
 
+			// when replaying, this replaces the controls with the recorded ones
+			input_replay_controls(&(Player->ci));
+
 			// this is similar to ai_control_info_check
 			if (Player_obj->type == OBJ_SHIP) {
 				auto sip = &Ship_info[Ships[Player_obj->instance].ship_info_index];
@@ -195,10 +195,13 @@ int png_read_header(const char *real_filename, CFILE *img_cfp, int *w, int *h, i
  * @param [in]  bpp
  * @param [in]  dest_size
  * @param [in]  cf_type
+ * @param [in]  img_cfp        already open CFILE handle, if available. The caller keeps ownership of it.
  *
  * @retval true if succesful, false otherwise
+ *
+ * @note This function is safe to call from a worker thread as long as an already opened img_cfp is passed in
  */
-int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int  /*dest_size*/, int cf_type)
+int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int  /*dest_size*/, int cf_type, CFILE *img_cfp)
 {
 	char filename[MAX_FILENAME_LEN];
 	png_infop info_ptr;
@@ -210,12 +213,16 @@ int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int
 	status.reading_header = false;
 	status.filename = real_filename;
 
-	strcpy_s( filename, real_filename );
-	char *p = strchr( filename, '.' );
-	if ( p ) *p = 0;
-	strcat_s( filename, ".png" );
+	if (img_cfp == nullptr) {
+		strcpy_s( filename, real_filename );
+		char *p = strchr( filename, '.' );
+		if ( p ) *p = 0;
+		strcat_s( filename, ".png" );
 
-	status.cfp = cfopen(filename, "rb", CFILE_NORMAL, cf_type);
+		status.cfp = cfopen(filename, "rb", CFILE_NORMAL, cf_type);
+	} else {
+		status.cfp = img_cfp;
+	}
 
 	if (status.cfp == NULL)
 		return PNG_ERROR_READING;
@@ -231,7 +238,8 @@ int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int
 	if (png_ptr == NULL)
 	{
 		mprintf(("png_read_bitmap: png_ptr went wrong\n"));
-		cfclose(status.cfp);
+		if (img_cfp == nullptr)
+			cfclose(status.cfp);
 		return PNG_ERROR_READING;
 	}
 
@@ -240,7 +248,8 @@ int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int
 	if (info_ptr == NULL)
 	{
 		mprintf(("png_read_bitmap: info_ptr went wrong\n"));
-		cfclose(status.cfp);
+		if (img_cfp == nullptr)
+			cfclose(status.cfp);
 		png_destroy_read_struct(&png_ptr, NULL, NULL);
 		return PNG_ERROR_READING;
 	}
@@ -250,7 +259,8 @@ int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int
 		mprintf(("png_read_bitmap: something went wrong\n"));
 		/* Free all of the memory associated with the png_ptr and info_ptr */
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		cfclose(status.cfp);
+		if (img_cfp == nullptr)
+			cfclose(status.cfp);
 		/* If we get here, we had a problem reading the file */
 		return PNG_ERROR_READING;
 	}
@@ -272,7 +282,8 @@ int png_read_bitmap(const char *real_filename, ubyte *image_data, int *bpp, int
 	}
 
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-	cfclose(status.cfp);
+	if (img_cfp == nullptr)
+		cfclose(status.cfp);
 
 	return PNG_ERROR_NONE;
 }
@@ -66,6 +66,7 @@
 #include "object/objectsnd.h"
 #include "object/waypoint.h"
 #include "parse/parselo.h"
+#include "parse/sexp.h"
 #include "scripting/hook_api.h"
 #include "scripting/scripting.h"
 #include "particle/particle.h"
@@ -187,6 +188,59 @@ const ship_registry_entry *ship_registry_get(const char *name)
 	return nullptr;
 }
 
+// Ships which have an object, by name.  Names are not guaranteed to be unique so each entry holds all ships with that
+// name in ascending order; this way ship_name_lookup() finds the same ship a search through the Ships array would.
+static SCP_unordered_map<SCP_string, SCP_vector<int>, SCP_string_lcase_hash, SCP_string_lcase_equal_to> Ship_name_index;
+
+// Wings by name, in the same way as Ship_name_index
+static SCP_unordered_map<SCP_string, SCP_vector<int>, SCP_string_lcase_hash, SCP_string_lcase_equal_to> Wing_name_index;
+
+static void ship_name_index_add(int shipnum)
+{
+	auto& ships = Ship_name_index[Ships[shipnum].ship_name];
+	ships.insert(std::lower_bound(ships.begin(), ships.end(), shipnum), shipnum);
+}
+
+static void ship_name_index_remove(int shipnum)
+{
+	auto it = Ship_name_index.find(Ships[shipnum].ship_name);
+	if (it == Ship_name_index.end())
+		return;
+
+	auto& ships = it->second;
+	ships.erase(std::remove(ships.begin(), ships.end(), shipnum), ships.end());
+	if (ships.empty())
+		Ship_name_index.erase(it);
+}
+
+/**
+ * Returns the key under which a subsystem name is stored in ship::subsys_name_index.  Two names have the same key
+ * exactly if subsystem_stricmp() considers them equal, except for the empty string which must never be looked up.
+ */
+static SCP_string ship_subsys_name_key(const char *name)
+{
+	SCP_string key = name;
+	SCP_tolower(key);
+
+	if (!key.empty() && key.back() == 's')
+		key.pop_back();
+
+	return key;
+}
+
+static void ship_subsys_name_index_build(ship *shipp)
+{
+	shipp->subsys_name_index.clear();
+
+	for (auto ss = GET_FIRST(&shipp->subsys_list); ss != END_OF_LIST(&shipp->subsys_list); ss = GET_NEXT(ss)) {
+		if (*ss->system_info->subobj_name == '\0')
+			continue;
+
+		// keep the first subsystem with this name, just like a search through the list would
+		shipp->subsys_name_index.emplace(ship_subsys_name_key(ss->system_info->subobj_name), ss);
+	}
+}
+
 
 int	Num_engine_wash_types;
 int	Num_ship_subobj_types;
@@ -5888,6 +5942,9 @@ void ship_level_init()
 	Ship_registry.clear();
 	Ship_registry_map.clear();
 
+	Ship_name_index.clear();
+	wing_name_index_rebuild();
+
 
 	// Empty the subsys list
 	ship_clear_subsystems();
@@ -6231,6 +6288,7 @@ void ship::clear()
 	// since these aren't cleared by clear()
 	subsys_list.next = NULL;
 	subsys_list.prev = NULL;
+	subsys_name_index.clear();
 
 	memset(&subsys_info, 0, SUBSYSTEM_MAX * sizeof(ship_subsys_info));
 
@@ -7224,6 +7282,8 @@ static int subsys_set(int objnum, int ignore_subsys_info)
 		ship_recalc_subsys_strength( shipp );
 	}
 
+	ship_subsys_name_index_build( shipp );
+
 	return 1;
 }
 
@@ -7642,6 +7702,8 @@ static void ship_subsystems_delete(ship *shipp)
 			systemp = temp;												// use the temp variable to move right along
 		}
 	}
+
+	shipp->subsys_name_index.clear();
 }
 
 void ship_delete( object * obj )
@@ -7664,6 +7726,7 @@ void ship_delete( object * obj )
 	// free up the list of subsystems of this ship.  walk through list and move remaining subsystems
 	// on ship back to the free list for other ships to use.
 	ship_subsystems_delete(&Ships[num]);
+	ship_name_index_remove(num);
 	shipp->objnum = -1;
 
 	animation::ModelAnimationSet::stopAnimations(model_get_instance(shipp->model_instance_num));
@@ -7749,6 +7812,7 @@ void ship_wing_cleanup( int shipnum, wing *wingp )
 		{
 			// mark the wing as gone
 			wingp->flags.set(Ship::Wing_Flags::Gone);
+			sexp_state_changed(SEXP_DEP_SHIP_STATUS);
 			wingp->time_gone = Missiontime;
 
 			// if all ships were destroyed, log it as destroyed
@@ -7909,6 +7973,7 @@ void ship_cleanup(int shipnum, int cleanup_mode)
 	entry->status = ShipStatus::EXITED;
 	entry->objp = nullptr;
 	entry->shipp = nullptr;
+	sexp_state_changed(SEXP_DEP_SHIP_STATUS);
 	entry->cleanup_mode = cleanup_mode;
 
 	// add the information to the exited ship list
@@ -10070,6 +10135,9 @@ int ship_create(matrix* orient, vec3d* pos, int ship_type, const char* ship_name
 		entry->objp = &Objects[objnum];
 		entry->shipp = shipp;
 	}
+
+	ship_name_index_add(n);
+	sexp_state_changed(SEXP_DEP_SHIP_STATUS);
 	
 	// Start up stracking for this ship in multi.
 	if (Game_mode & (GM_MULTIPLAYER)) {
@@ -13252,29 +13320,50 @@ void wing_bash_ship_name(char *ship_name, const char *wing_name, int index, bool
  */
 int wing_name_lookup(const char *name, int ignore_count)
 {
-	int i, wing_limit;
-
 	Assertion(name != nullptr, "NULL name passed to wing_name_lookup");
 
-	if ( Fred_running )
-		wing_limit = MAX_WINGS;
-	else
-		wing_limit = Num_wings;
+	// FRED edits the wings directly, so it can't use the index
+	if ( !Fred_running ) {
+		auto it = Wing_name_index.find(name);
+		if (it == Wing_name_index.end())
+			return -1;
 
-	if (Fred_running || ignore_count ) {  // current_count not used for Fred..
-		for (i=0; i<wing_limit; i++)
-			if (Wings[i].wave_count && !stricmp(Wings[i].name, name))
-				return i;
+		for (auto wingnum : it->second) {
+			if (ignore_count ? Wings[wingnum].wave_count : Wings[wingnum].current_count)
+				return wingnum;
+		}
 
-	} else {
-		for (i=0; i<wing_limit; i++)
-			if (Wings[i].current_count && !stricmp(Wings[i].name, name))
-				return i;
+		return -1;
 	}
 
+	// current_count is not used for Fred
+	for (int i = 0; i < MAX_WINGS; i++)
+		if (Wings[i].wave_count && !stricmp(Wings[i].name, name))
+			return i;
+
 	return -1;
 }
 
+void wing_set_name(int wingnum, const char *name)
+{
+	Assertion(wingnum >= 0 && wingnum < MAX_WINGS, "Invalid wing index %d passed to wing_set_name", wingnum);
+	Assertion(name != nullptr, "NULL name passed to wing_set_name");
+
+	auto len = sizeof(Wings[wingnum].name);
+	strncpy(Wings[wingnum].name, name, len);
+	Wings[wingnum].name[len - 1] = 0;
+
+	wing_name_index_rebuild();
+}
+
+void wing_name_index_rebuild()
+{
+	Wing_name_index.clear();
+
+	for (int i = 0; i < Num_wings; i++)
+		Wing_name_index[Wings[i].name].push_back(i);
+}
+
 bool wing_has_yet_to_arrive(const wing *wingp)
 {
 	return (wingp != nullptr) && (wingp->num_waves >= 0) && (wingp->total_arrived_count == 0);
@@ -13288,6 +13377,11 @@ int wing_lookup(const char *name)
 {
 	Assertion(name != nullptr, "NULL name passed to wing_lookup");
 
+	if (!Fred_running) {
+		auto it = Wing_name_index.find(name);
+		return (it == Wing_name_index.end()) ? -1 : it->second.front();
+	}
+
 	for(int idx=0;idx<Num_wings;idx++)
 		if(stricmp(Wings[idx].name,name)==0)
 		   return idx;
@@ -13466,6 +13560,21 @@ int ship_name_lookup(const char *name, int inc_players)
 {
 	Assertion(name != nullptr, "NULL name passed to ship_name_lookup");
 
+	// FRED renames ships directly, so it can't use the index
+	if (!Fred_running) {
+		auto it = Ship_name_index.find(name);
+		if (it == Ship_name_index.end())
+			return -1;
+
+		for (auto i : it->second) {
+			Assertion(Ships[i].objnum >= 0, "Ship %s is in the name index without an object!", Ships[i].ship_name);
+			if (Objects[Ships[i].objnum].type == OBJ_SHIP || (Objects[Ships[i].objnum].type == OBJ_START && inc_players))
+				return i;
+		}
+
+		return -1;
+	}
+
 	for (int i=0; i<MAX_SHIPS; i++){
 		if (Ships[i].objnum >= 0){
 			if (Objects[Ships[i].objnum].type == OBJ_SHIP || (Objects[Ships[i].objnum].type == OBJ_START && inc_players)){
@@ -13480,6 +13589,26 @@ int ship_name_lookup(const char *name, int inc_players)
 	return -1;
 }
 
+void ship_set_name(int shipnum, const char *name)
+{
+	Assertion(shipnum >= 0 && shipnum < MAX_SHIPS, "Invalid ship index %d passed to ship_set_name", shipnum);
+	Assertion(name != nullptr, "NULL name passed to ship_set_name");
+
+	auto shipp = &Ships[shipnum];
+
+	// only ships with an object are in the index
+	bool indexed = (shipp->objnum >= 0);
+	if (indexed)
+		ship_name_index_remove(shipnum);
+
+	auto len = sizeof(shipp->ship_name);
+	strncpy(shipp->ship_name, name, len);
+	shipp->ship_name[len - 1] = 0;
+
+	if (indexed)
+		ship_name_index_add(shipnum);
+}
+
 int ship_type_name_lookup_sub(const char *name)
 {
 	Assertion(name != nullptr, "NULL name passed to ship_type_name_lookup");
@@ -17644,6 +17773,12 @@ ship_subsys *ship_get_subsys(const ship *shipp, const char *subsys_name)
 		return NULL;
 	}
 
+	// empty names are not in the index since their key would collide with "s"
+	if (*subsys_name != '\0') {
+		auto it = shipp->subsys_name_index.find(ship_subsys_name_key(subsys_name));
+		return (it == shipp->subsys_name_index.end()) ? nullptr : it->second;
+	}
+
 	ship_subsys *ss = GET_FIRST(&shipp->subsys_list);
 	while (ss != END_OF_LIST(&shipp->subsys_list)) {
 		// check subsystem name
@@ -19559,6 +19694,7 @@ void ship_render_weapon_models(model_render_params *ship_render_info, model_draw
 					angles angs = vmd_zero_angles;
 					angs.b = shipp->primary_rotate_ang[i];
 					vm_angles_2_matrix(&pmi->submodel[mn].canonical_orient, &angs);
+					pmi->submodel[mn].orient_generation++;
 				}
 			}
 		}
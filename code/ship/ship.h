@@ -609,6 +609,7 @@ public:
 	// types of subsystems.  (i.e. the list might contain 3 engines.  There will be one subsys_info entry
 	// describing the state of all engines combined) -- MWA 4/1/97
 	ship_subsys	subsys_list;									//	linked list of subsystems for this ship.
+	SCP_unordered_map<SCP_string, ship_subsys*> subsys_name_index;	// subsystems of subsys_list by their name, see ship_get_subsys()
 	ship_subsys	*last_targeted_subobject[MAX_PLAYERS];	// Last subobject that has been targeted.  NULL if none;(player specific)
 	ship_subsys_info	subsys_info[SUBSYSTEM_MAX];		// info on particular generic types of subsystems	
 
@@ -1646,6 +1647,7 @@ extern int get_subsystem_pos(vec3d *pos, object *objp, ship_subsys *subsysp);
 
 extern int ship_info_lookup(const char *name);
 extern int ship_name_lookup(const char *name, int inc_players = 0);	// returns the index into Ship array of name
+extern void ship_set_name(int shipnum, const char *name);	// renames a ship and keeps the name lookup up to date
 extern int ship_type_name_lookup(const char *name);
 
 inline int ship_info_size()
@@ -1664,6 +1666,12 @@ extern int wing_has_conflicting_teams(int wing_index);
 // present.
 extern int wing_name_lookup(const char *name, int ignore_count = 0);
 
+// renames a wing and keeps the name lookup up to date
+extern void wing_set_name(int wingnum, const char *name);
+
+// has to be called whenever wings are added to or removed from Wings
+extern void wing_name_index_rebuild();
+
 extern bool wing_has_yet_to_arrive(const wing *wingp);
 
 // for generating a ship name for arbitrary waves/indexes of that wing... correctly handles the # character
@@ -38,6 +38,7 @@
 #include "object/objectshield.h"
 #include "object/objectsnd.h"
 #include "parse/parselo.h"
+#include "parse/sexp.h"
 #include "scripting/hook_api.h"
 #include "scripting/scripting.h"
 #include "scripting/api/objs/subsystem.h"
@@ -1940,6 +1941,7 @@ void ship_hit_kill(object *ship_objp, object *other_obj, vec3d *hitpos, float pe
 	// Goober5000 - since we added a mission log entry above, immediately set the status.  For destruction, ship_cleanup isn't called until a little bit later
 	auto entry = &Ship_registry[Ship_registry_map[sp->ship_name]];
 	entry->status = ShipStatus::EXITED;
+	sexp_state_changed(SEXP_DEP_SHIP_STATUS);
 
 	ship_generic_kill_stuff( ship_objp, percent_killed );
 
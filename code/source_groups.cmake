@@ -104,6 +104,8 @@ add_file_folder("Autopilot"
 
 # Bmpman files
 add_file_folder("Bmpman"
+	bmpman/bm_cache.cpp
+	bmpman/bm_cache.h
 	bmpman/bm_internal.h
 	bmpman/bmpman.cpp
 	bmpman/bmpman.h
@@ -126,6 +128,8 @@ add_file_folder("CFile"
 	cfile/cfilesystem.h
 	cfile/cfilecompression.cpp
 	cfile/cfilecompression.h
+	cfile/cfilecache.cpp
+	cfile/cfilecache.h
 )
 
 # Cmdline files
@@ -814,6 +818,8 @@ add_file_folder("Mission"
 	mission/missiontraining.cpp
 	mission/missiontraining.h
 	mission/mission_flags.h
+	mission/mission_index.cpp
+	mission/mission_index.h
 )
 
 # MissionUI files
@@ -851,6 +857,8 @@ add_file_folder("mod_table"
 # Model files
 add_file_folder("Model"
 	model/model.h
+	model/model_cache.cpp
+	model/model_cache.h
 	model/modelanimation.cpp
 	model/modelanimation.h
 	model/modelanimation_moveables.cpp
@@ -1032,6 +1040,8 @@ add_file_folder("Parse"
 	parse/sexp.h
 	parse/sexp_container.cpp
 	parse/sexp_container.h
+	parse/table_cache.cpp
+	parse/table_cache.h
 )
 
 add_file_folder("Parse\\\\SEXP"
@@ -1041,6 +1051,10 @@ add_file_folder("Parse\\\\SEXP"
 	parse/sexp/EngineSEXP.h
 	parse/sexp/LuaSEXP.cpp
 	parse/sexp/LuaSEXP.h
+	parse/sexp/sexp_bytecode.cpp
+	parse/sexp/sexp_bytecode.h
+	parse/sexp/sexp_profiler.cpp
+	parse/sexp/sexp_profiler.h
 	parse/sexp/sexp_lookup.cpp
 	parse/sexp/sexp_lookup.h
 	parse/sexp/SEXPParameterExtractor.cpp
@@ -1114,6 +1128,8 @@ add_file_folder("PilotFile"
 
 # Playerman files
 add_file_folder("Playerman"
+	playerman/inputreplay.cpp
+	playerman/inputreplay.h
 	playerman/managepilot.cpp
 	playerman/managepilot.h
 	playerman/player.h
@@ -1503,6 +1519,8 @@ add_file_folder("TgaUtils"
 add_file_folder("Tracing"
 	tracing/categories.cpp
 	tracing/categories.h
+	tracing/CategoryTimer.cpp
+	tracing/CategoryTimer.h
 	tracing/FrameProfiler.h
 	tracing/FrameProfiler.cpp
 	tracing/MainFrameTimer.h
@@ -1553,6 +1571,8 @@ add_file_folder("Utils"
 	utils/string_utils.cpp
 	utils/string_utils.h
 	utils/strings.h
+	utils/ThreadPool.cpp
+	utils/ThreadPool.h
 	utils/tuples.h
 	utils/unicode.cpp
 	utils/unicode.h
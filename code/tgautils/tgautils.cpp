@@ -490,10 +490,13 @@ int targa_uncompress( ubyte *dst, ubyte *src, int bitmap_width, int bytes_per_pi
 // 
 // filename - name of the targa file to load
 // image_data - allocated storage for the bitmap
+// img_cfp - already open CFILE handle, if available. The caller keeps ownership of it.
 //
 // returns - true if succesful, false otherwise
 //
-int targa_read_bitmap(const char *real_filename, ubyte *image_data, ubyte *palette, int dest_size, int cf_type)
+// This is safe to call from a worker thread as long as an already opened img_cfp is passed in.
+//
+int targa_read_bitmap(const char *real_filename, ubyte *image_data, ubyte *palette, int dest_size, int cf_type, CFILE *img_cfp)
 {
 	Assert(real_filename);
 	targa_header header;
@@ -503,16 +506,20 @@ int targa_read_bitmap(const char *real_filename, ubyte *image_data, ubyte *palet
 	ubyte r, g, b;
 	int xfile_offset = 0;
 		
-	// open the file
-	strcpy_s( filename, real_filename );
-	char *p = strchr( filename, '.' );
-	if ( p ) *p = 0;
-	strcat_s( filename, ".tga" );
+	if (img_cfp == NULL) {
+		// open the file
+		strcpy_s( filename, real_filename );
+		char *p = strchr( filename, '.' );
+		if ( p ) *p = 0;
+		strcat_s( filename, ".tga" );
 
-	targa_file = cfopen( filename , "rb", CFILE_NORMAL, cf_type );
-	if ( !targa_file ){
-		return TARGA_ERROR_READING;
-	}		
+		targa_file = cfopen( filename , "rb", CFILE_NORMAL, cf_type );
+		if ( !targa_file ){
+			return TARGA_ERROR_READING;
+		}
+	} else {
+		targa_file = img_cfp;
+	}
 
 	// read the footer info first
 	cfseek( targa_file, cfilelength(targa_file) - TARGA_FOOTER_SIZE, CF_SEEK_SET );
@@ -577,21 +584,24 @@ int targa_read_bitmap(const char *real_filename, ubyte *image_data, ubyte *palet
 	Assert( (bytes_per_pixel == 2) || (bytes_per_pixel == 3) || (bytes_per_pixel == 4) );
 
 	if ( (bytes_per_pixel < 2) || (bytes_per_pixel > 4) ) {
-		cfclose(targa_file);
+		if (img_cfp == NULL)
+			cfclose(targa_file);
 		Int3();
 
 		return TARGA_ERROR_READING;
 	}
 
 	if((header.image_type!=1)&&(header.image_type!=2)&&(header.image_type!=9)&&(header.image_type!=10)) {
-		cfclose(targa_file);
+		if (img_cfp == NULL)
+			cfclose(targa_file);
 		return TARGA_ERROR_READING;
 	}
 
 	// skip the Image ID field -- should not be needed
 	if(header.id_length>0) {
 		if ( cfseek(targa_file, header.id_length, CF_SEEK_CUR) ) {
-			cfclose(targa_file);
+			if (img_cfp == NULL)
+				cfclose(targa_file);
 			return TARGA_ERROR_READING;
 		}
 	}
@@ -679,7 +689,8 @@ int targa_read_bitmap(const char *real_filename, ubyte *image_data, ubyte *palet
 	}
 
 	vm_free(fileptr);
-	cfclose(targa_file);
+	if (img_cfp == NULL)
+		cfclose(targa_file);
 	targa_file = NULL;
 
 	return TARGA_ERROR_NONE;
@@ -0,0 +1,45 @@
+
+#include "CategoryTimer.h"
+
+namespace tracing {
+
+void CategoryTimer::processEvent(const trace_event* event) {
+	if (event->type != EventType::Complete || event->pid == GPU_PID) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(_timingsMutex);
+
+	auto& timing = _timings[event->category];
+	timing.category = event->category;
+	timing.count++;
+	timing.total_duration += event->duration;
+	timing.max_duration = std::max(timing.max_duration, event->duration);
+}
+
+void CategoryTimer::reset() {
+	std::lock_guard<std::mutex> guard(_timingsMutex);
+
+	_timings.clear();
+}
+
+SCP_vector<category_timing> CategoryTimer::getTimings() {
+	SCP_vector<category_timing> timings;
+
+	{
+		std::lock_guard<std::mutex> guard(_timingsMutex);
+
+		timings.reserve(_timings.size());
+		for (auto& entry : _timings) {
+			timings.push_back(entry.second);
+		}
+	}
+
+	std::sort(timings.begin(), timings.end(), [](const category_timing& left, const category_timing& right) {
+		return strcmp(left.category->getName(), right.category->getName()) < 0;
+	});
+
+	return timings;
+}
+
+}
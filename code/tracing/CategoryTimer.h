@@ -0,0 +1,32 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+#include "tracing/tracing.h"
+
+#include <mutex>
+
+/** @file
+ *  @ingroup tracing
+ */
+
+namespace tracing {
+
+/**
+ * @brief Sums up the durations of the complete events of each category
+ *
+ * Unlike the frame profiler this does not keep the hierarchy of the events so it is cheap enough to run over
+ * thousands of frames. Events may be submitted from any thread.
+ */
+class CategoryTimer {
+	std::mutex _timingsMutex;
+	SCP_unordered_map<const Category*, category_timing> _timings;
+
+ public:
+	void processEvent(const trace_event* event);
+
+	void reset();
+
+	SCP_vector<category_timing> getTimings();
+};
+
+}
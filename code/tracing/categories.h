@@ -150,6 +150,7 @@ extern Category LoadSound;
 extern Category LevelPageIn;
 extern Category PageInStop;
 extern Category PageInSingleBitmap;
+extern Category PageInDecodeWait;
 extern Category ShipPageIn;
 extern Category WeaponPageIn;
 
@@ -7,6 +7,7 @@
 #include "TraceEventWriter.h"
 #include "MainFrameTimer.h"
 #include "FrameProfiler.h"
+#include "CategoryTimer.h"
 
 #include <cinttypes>
 #include <fstream>
@@ -55,6 +56,7 @@ using namespace tracing;
 std::unique_ptr<ThreadedTraceEventWriter> traceEventWriter;
 std::unique_ptr<ThreadedMainFrameTimer> mainFrameTimer;
 std::unique_ptr<FrameProfiler> frameProfiler;
+std::unique_ptr<CategoryTimer> categoryTimer;
 
 SCP_vector<int> query_objects;
 // The GPU timestamp queries use an internal free list to reduce the number of graphics API calls
@@ -127,6 +129,10 @@ void submit_event(trace_event* evt) {
 	if (frameProfiler) {
 		frameProfiler->processEvent(evt);
 	}
+
+	if (categoryTimer) {
+		categoryTimer->processEvent(evt);
+	}
 }
 
 void process_gpu_events() {
@@ -229,6 +235,10 @@ void init() {
 		frameProfiler.reset(new FrameProfiler());
 		do_trace_events = true;
 	}
+	if (Cmdline_headless_benchmark != nullptr) {
+		categoryTimer.reset(new CategoryTimer());
+		do_trace_events = true;
+	}
 
 	do_gpu_queries = gr_is_capable(CAPABILITY_TIMESTAMP_QUERY);
 
@@ -260,6 +270,18 @@ SCP_string get_frame_profile_output() {
 	return frameProfiler->getContent();
 }
 
+void category_timings_reset() {
+	Assertion(categoryTimer, "Category timing must be enabled for this function!");
+
+	categoryTimer->reset();
+}
+
+SCP_vector<category_timing> get_category_timings() {
+	Assertion(categoryTimer, "Category timing must be enabled for this function!");
+
+	return categoryTimer->getTimings();
+}
+
 void shutdown() {
 	while (!gpu_events.empty()) {
 		process_events();
@@ -275,6 +297,7 @@ void shutdown() {
 
 	mainFrameTimer = nullptr;
 	traceEventWriter = nullptr;
+	categoryTimer = nullptr;
 
 	initialized = false;
 }
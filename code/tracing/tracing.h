@@ -56,6 +56,17 @@ struct trace_event {
 	float value = -1.f;
 };
 
+/**
+ * @brief The accumulated time of all complete events of one category
+ */
+struct category_timing {
+	const Category* category = nullptr;
+
+	std::uint64_t count = 0;
+	std::uint64_t total_duration = 0; // in nanoseconds, including the time of nested categories
+	std::uint64_t max_duration = 0;
+};
+
 /**
  * @brief Initializes the tracing subsystem
  */
@@ -74,6 +85,17 @@ void frame_profile_process_frame();
  */
 SCP_string get_frame_profile_output();
 
+/**
+ * @brief Discards the category timings collected so far
+ */
+void category_timings_reset();
+
+/**
+ * @brief Gets the time spent in each category since the last reset
+ * @return The timings of every category that had an event, sorted by name
+ */
+SCP_vector<category_timing> get_category_timings();
+
 /**
  * @brief Deinitializes the tracing subsystem
  */
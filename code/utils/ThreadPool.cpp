@@ -0,0 +1,60 @@
+#include "ThreadPool.h"
+
+namespace util {
+
+ThreadPool::ThreadPool(int num_threads)
+{
+	if (num_threads < 1) {
+		num_threads = defaultThreadCount();
+	}
+
+	m_workers.reserve(static_cast<size_t>(num_threads));
+	for (int i = 0; i < num_threads; ++i) {
+		m_workers.emplace_back(&ThreadPool::workerThread, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_queueMutex);
+		m_stopping = true;
+	}
+	m_queueCondition.notify_all();
+
+	for (auto& worker : m_workers) {
+		worker.join();
+	}
+}
+
+int ThreadPool::defaultThreadCount()
+{
+	auto cores = static_cast<int>(std::thread::hardware_concurrency());
+
+	// hardware_concurrency() may return 0 if the value is not known
+	return std::max(1, cores - 1);
+}
+
+void ThreadPool::workerThread()
+{
+	for (;;) {
+		std::function<void()> work;
+
+		{
+			std::unique_lock<std::mutex> lock(m_queueMutex);
+			m_queueCondition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+
+			// Remaining work is still executed when stopping so that no future is left without a value
+			if (m_queue.empty()) {
+				return;
+			}
+
+			work = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		work();
+	}
+}
+
+} // namespace util
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "globalincs/pstypes.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace util {
+
+/**
+ * @brief A simple fixed size pool of worker threads
+ *
+ * Work is submitted as a callable and executed by the first idle worker. The result (or any exception thrown by the
+ * work item) is available through the returned future. Work items are started in the order they were submitted.
+ *
+ * @warning Most of the engine is not thread safe! Only submit work that does not touch global engine state or that
+ * only accesses state which is not modified by the main thread while the work item is running.
+ */
+class ThreadPool {
+  public:
+	/**
+	 * @brief Creates a new pool and starts the worker threads
+	 * @param num_threads The number of worker threads. Values less than 1 use defaultThreadCount().
+	 */
+	explicit ThreadPool(int num_threads = 0);
+
+	/**
+	 * @brief Waits for all submitted work to finish and stops the worker threads
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Adds a work item to the pool
+	 * @param func The function to execute on a worker thread
+	 * @return A future which will contain the return value of the function
+	 */
+	template <typename F>
+	std::future<typename std::result_of<F()>::type> submit(F func)
+	{
+		using result_type = typename std::result_of<F()>::type;
+
+		auto task = std::make_shared<std::packaged_task<result_type()>>(std::move(func));
+		auto future = task->get_future();
+
+		{
+			std::lock_guard<std::mutex> guard(m_queueMutex);
+			m_queue.emplace_back([task]() { (*task)(); });
+		}
+		m_queueCondition.notify_one();
+
+		return future;
+	}
+
+	/**
+	 * @brief Gets the number of worker threads in this pool
+	 */
+	size_t size() const { return m_workers.size(); }
+
+	/**
+	 * @brief The number of workers that should be used if the user did not specify anything
+	 *
+	 * This leaves one core free for the main thread.
+	 */
+	static int defaultThreadCount();
+
+  private:
+	void workerThread();
+
+	SCP_vector<std::thread> m_workers;
+
+	std::mutex m_queueMutex;
+	std::condition_variable m_queueCondition;
+	std::deque<std::function<void()>> m_queue;
+	bool m_stopping = false;
+};
+
+} // namespace util
@@ -85,6 +85,7 @@
 #include "lab/wmcgui.h" //So that GUI_System can be initialized
 #include "libs/discord/discord.h"
 #include "libs/ffmpeg/FFmpeg.h"
+#include "libs/jansson.h"
 #include "lighting/lighting.h"
 #include "lighting/lighting_profiles.h"
 #include "localization/localize.h"
@@ -102,6 +103,7 @@
 #include "mission/missioncampaign.h"
 #include "mission/missiongoals.h"
 #include "mission/missionhotkey.h"
+#include "mission/mission_index.h"
 #include "mission/missionload.h"
 #include "mission/missionlog.h"
 #include "mission/missionmessage.h"
@@ -149,9 +151,12 @@
 #include "parse/parselo.h"
 #include "parse/sexp.h"
 #include "parse/sexp/sexp_lookup.h"
+#include "parse/sexp/sexp_profiler.h"
+#include "parse/table_cache.h"
 #include "particle/ParticleManager.h"
 #include "particle/particle.h"
 #include "pilotfile/pilotfile.h"
+#include "playerman/inputreplay.h"
 #include "playerman/managepilot.h"
 #include "playerman/player.h"
 #include "popup/popup.h"
@@ -904,6 +909,7 @@ void game_level_close()
 		Weapon_energy_cheat = false;
 
 		game_time_level_close();
+		input_replay_level_close();
 
 		if (Game_mode & GM_STANDALONE_SERVER) {
 			model_free_all();			// Free all existing models if standalone server
@@ -963,6 +969,10 @@ void game_level_init()
 	// reset the geometry map and distortion map batcher, this should to be done pretty soon in this mission load process (though it's not required)
 	batch_reset();
 
+	// This may reseed the random number generator and freeze the time so it has to happen before the timestamps
+	// are initialized
+	input_replay_level_init(Game_current_mission_filename);
+
 	// Initialize the game subsystems
 	game_time_level_init();
 
@@ -1697,6 +1707,14 @@ void game_init()
 
 	mod_table_init();		// load in all the mod dependent settings
 
+	if (table_cache_enabled()) {
+		table_cache_purge_old();
+	}
+
+	if (mission_index_enabled()) {
+		mission_index_purge_old();
+	}
+
 	// This needs to be delayed until we know if the new options are actually going to be used
 	if (Using_in_game_options) {
 		options::OptionsManager::instance()->loadInitialValues();
@@ -1767,8 +1785,8 @@ void game_init()
 /////////////////////////////
 
 	std::unique_ptr<SDLGraphicsOperations> sdlGraphicsOperations;
-	if (!Is_standalone) {
-		// Standalone mode doesn't require graphics operations
+	if (!Is_standalone && Cmdline_headless_benchmark == nullptr) {
+		// Standalone mode and the headless benchmark don't require graphics operations
 		sdlGraphicsOperations.reset(new SDLGraphicsOperations());
 	}
 	if (!gr_init(std::move(sdlGraphicsOperations))) {
@@ -1971,6 +1989,11 @@ void game_init()
 		output_sexps("sexps.html");
 	}
 
+	// only set once, so that the sexp_profile console command can turn it off for the following missions
+	if (Cmdline_profile_sexp) {
+		sexp::Profiler_enabled = true;
+	}
+
 	Viewer_mode = 0;
 
 	// Do this before the initial scripting hook runs in case that hook does something with the UI
@@ -4357,6 +4380,9 @@ void game_do_frame(bool set_frametime)
 		game_set_frametime(GS_STATE_GAME_PLAY);
 	}
 
+	// when replaying, this replaces the frame time with the recorded one
+	input_replay_frame_start();
+
 	game_update_missiontime();
 
 	if (Game_mode & GM_STANDALONE_SERVER) {
@@ -4374,6 +4400,8 @@ void game_do_frame(bool set_frametime)
 	last_single_step = game_single_step;
 
 	game_frame();
+
+	input_replay_frame_end();
 }
 
 void multi_maybe_do_frame()
@@ -6520,6 +6548,185 @@ DCF(pofspew, "Spews POF info without shutting down the game")
 	game_spew_pof_info();
 }
 
+#define HEADLESS_BENCHMARK_FPS		60
+#define HEADLESS_BENCHMARK_SEED		1234567
+
+static double headless_benchmark_ms(std::uint64_t nanoseconds)
+{
+	return static_cast<double>(nanoseconds) / 1000000.0;
+}
+
+// Gets the frame time which is larger than the given fraction of all frames (nearest rank)
+static std::uint64_t headless_benchmark_percentile(const SCP_vector<std::uint64_t>& sorted_times, double fraction)
+{
+	auto rank = static_cast<size_t>(std::ceil(fraction * sorted_times.size()));
+
+	return sorted_times[std::max(rank, static_cast<size_t>(1)) - 1];
+}
+
+static void game_headless_benchmark_write_report(const SCP_vector<std::uint64_t>& frame_times, std::uint64_t total_time)
+{
+	auto sorted_times = frame_times;
+	std::sort(sorted_times.begin(), sorted_times.end());
+
+	std::unique_ptr<json_t> frame_time(json_pack("{s:f, s:f, s:f, s:f, s:f, s:f}",
+		"mean_ms", headless_benchmark_ms(total_time) / frame_times.size(),
+		"min_ms", headless_benchmark_ms(sorted_times.front()),
+		"p50_ms", headless_benchmark_ms(headless_benchmark_percentile(sorted_times, 0.5)),
+		"p90_ms", headless_benchmark_ms(headless_benchmark_percentile(sorted_times, 0.9)),
+		"p99_ms", headless_benchmark_ms(headless_benchmark_percentile(sorted_times, 0.99)),
+		"max_ms", headless_benchmark_ms(sorted_times.back())));
+
+	std::unique_ptr<json_t> subsystems(json_array());
+	for (auto& timing : tracing::get_category_timings()) {
+		json_array_append_new(subsystems.get(), json_pack("{s:s, s:I, s:f, s:f, s:f}",
+			"name", timing.category->getName(),
+			"calls", static_cast<json_int_t>(timing.count),
+			"total_ms", headless_benchmark_ms(timing.total_duration),
+			"per_frame_ms", headless_benchmark_ms(timing.total_duration) / frame_times.size(),
+			"max_ms", headless_benchmark_ms(timing.max_duration)));
+	}
+
+	std::unique_ptr<json_t> report(json_pack("{s:s, s:s, s:i, s:i, s:f, s:i, s:f, s:O, s:O}",
+		"version", gameversion::get_version_string().c_str(),
+		"mission", Game_current_mission_filename,
+		"frames", static_cast<int>(frame_times.size()),
+		"frames_requested", Cmdline_benchmark_frames,
+		"timestep", 1.0 / HEADLESS_BENCHMARK_FPS,
+		"seed", HEADLESS_BENCHMARK_SEED,
+		"total_ms", headless_benchmark_ms(total_time),
+		"frame_time", frame_time.get(),
+		"subsystems", subsystems.get()));
+
+	if (Cmdline_replay_input != nullptr) {
+		json_object_set_new(report.get(), "replay", json_pack("{s:s, s:i, s:i}",
+			"file", Cmdline_replay_input,
+			"frames", input_replay_get_num_frames_played(),
+			"first_divergent_frame", input_replay_get_divergent_frame()));
+	}
+
+	if (json_dump_file(report.get(), Cmdline_benchmark_output, JSON_INDENT(4)) != 0) {
+		mprintf(("Headless benchmark: failed to write the report to %s!\n", Cmdline_benchmark_output));
+		return;
+	}
+
+	mprintf(("Headless benchmark: %d frames, mean %.3f ms, p99 %.3f ms, report written to %s\n", static_cast<int>(frame_times.size()),
+		headless_benchmark_ms(total_time) / frame_times.size(), headless_benchmark_ms(headless_benchmark_percentile(sorted_times, 0.99)),
+		Cmdline_benchmark_output));
+}
+
+/**
+ * Simulates the mission given by -headless_benchmark without rendering and writes the timings to a JSON report.
+ *
+ * The game time advances by a fixed step every frame and the random number generators use a fixed seed so every run
+ * simulates the same thing, no matter how long the frames take on the machine. With -replay_input the frame times and
+ * the player input come from the recording instead and the benchmark runs until the recording ends.
+ *
+ * @returns true if the mission could be loaded
+ */
+static bool game_headless_benchmark()
+{
+	strcpy_s(Game_current_mission_filename, Cmdline_headless_benchmark);
+	Game_mode = GM_NORMAL;
+
+	Random::seed(HEADLESS_BENCHMARK_SEED);
+	init_semirand();
+
+	get_mission_info(Game_current_mission_filename, &The_mission, false);
+
+	// this also stops the time so the timestamps only advance when we step them below
+	game_level_init();
+
+	bool load_success = mission_load(Game_current_mission_filename);
+	stop_parse();
+
+	if (!load_success) {
+		mprintf(("Headless benchmark: failed to load mission %s!\n", Game_current_mission_filename));
+		game_level_close();
+		return false;
+	}
+
+	// game_level_init() already logged why the recording can't be used
+	bool replaying = Cmdline_replay_input != nullptr;
+	if (replaying && !input_replay_playing()) {
+		mprintf(("Headless benchmark: can't play back %s in mission %s!\n", Cmdline_replay_input, Game_current_mission_filename));
+		game_level_close();
+		return false;
+	}
+
+	game_post_level_init();
+	Game_mode |= GM_IN_MISSION;
+
+	// Loading the level is not part of the measurement
+	tracing::category_timings_reset();
+
+	SCP_vector<std::uint64_t> frame_times;
+	frame_times.reserve(Cmdline_benchmark_frames);
+	std::uint64_t total_time = 0;
+
+	Frametime = F1_0 / HEADLESS_BENCHMARK_FPS;
+	flFrametime = f2fl(Frametime);
+	flRealframetime = flFrametime;
+
+	for (int frame = 0; replaying || frame < Cmdline_benchmark_frames; ++frame) {
+		if (replaying) {
+			// the recording sets the frame time and the timestamps
+			if (!input_replay_frame_start()) {
+				break;
+			}
+		} else {
+			// step in whole microseconds without accumulating the rounding error
+			auto step = (static_cast<std::uint64_t>(frame + 1) * 1000000 / HEADLESS_BENCHMARK_FPS)
+				- (static_cast<std::uint64_t>(frame) * 1000000 / HEADLESS_BENCHMARK_FPS);
+			timestamp_step_paused(step);
+		}
+
+		FrametimeOverall += Frametime;
+		game_update_missiontime();
+
+		if (Pre_player_entry && Missiontime > Entry_delay_time) {
+			Pre_player_entry = 0;
+		}
+
+		auto start = timer_get_nanoseconds();
+		{
+			TRACE_SCOPE(tracing::MainFrame);
+
+			shield_frame_init();
+
+			if (input_replay_frame_controls_read()) {
+				game_process_keys();
+				read_player_controls(Player_obj, flFrametime);
+			}
+
+			game_whack_reset();
+			light_reset();
+
+			game_simulation_frame();
+		}
+		auto duration = timer_get_nanoseconds() - start;
+
+		// hashing the object states is not part of the measurement
+		input_replay_frame_end();
+
+		frame_times.push_back(duration);
+		total_time += duration;
+		++Framecount;
+
+		// nothing handles the death of the player here so the rest would not be representative
+		if (Player_ship->flags[Ship::Ship_Flags::Dying]) {
+			mprintf(("Headless benchmark: the player died after %d frames, stopping.\n", frame + 1));
+			break;
+		}
+	}
+
+	game_headless_benchmark_write_report(frame_times, total_time);
+
+	freespace_stop_mission();
+
+	return true;
+}
+
 /**
 * Does some preliminary checks and then enters main event loop.
 *
@@ -6592,6 +6799,13 @@ int game_main(int argc, char *argv[])
 		return 0;
 	}
 
+	// maybe run the headless benchmark, and exit
+	if (Cmdline_headless_benchmark != nullptr) {
+		auto success = game_headless_benchmark();
+		game_shutdown();
+		return success ? 0 : 1;
+	}
+
 	if (!Is_standalone) {
 		movie::play("intro.mve");
 	}
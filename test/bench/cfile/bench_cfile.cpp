@@ -0,0 +1,47 @@
+#include <cfile/cfile.h>
+#include <cfile/cfilesystem.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+class CFileBench : public test::FSTestFixture {
+  public:
+	CFileBench() : test::FSTestFixture(INIT_CFILE) { pushModDir("cfile"); }
+};
+
+// Uses the data of the unit test with the same name, which has files in directories and in a VP
+TEST_F(CFileBench, list_files_in_vps_and_dirs) {
+	// A file in a directory, a file in the VP and a built-in file
+	const char* const existing_files[] = { "dir.tbl", "test.tbl", "objecttypes.tbl" };
+
+	bench::run([&]() {
+		int found = 0;
+		for (auto filename : existing_files) {
+			found += cf_exists_full(filename, CF_TYPE_TABLES);
+		}
+		bench::do_not_optimize(found);
+	}, sizeof(existing_files) / sizeof(existing_files[0]), "exists");
+
+	// Lookups of files which don't exist have to check every location
+	bench::run([&]() { bench::do_not_optimize(cf_exists_full("missing.tbl", CF_TYPE_TABLES)); }, 1, "missing");
+
+	bench::run([&]() {
+		auto res = cf_find_file_location("dir2.tbl", CF_TYPE_ANY);
+		bench::do_not_optimize(res.found);
+	}, 1, "find_location_any");
+
+	bench::run([&]() {
+		for (auto filename : existing_files) {
+			auto cfp = cfopen(filename, "rb", CFILE_NORMAL, CF_TYPE_TABLES);
+			if (cfp != nullptr) {
+				cfclose(cfp);
+			}
+		}
+	}, sizeof(existing_files) / sizeof(existing_files[0]), "open_close");
+
+	bench::run([&]() {
+		SCP_vector<SCP_string> table_files;
+		cf_get_file_list(table_files, CF_TYPE_TABLES, "*", CF_SORT_NAME);
+		bench::do_not_optimize(table_files);
+	}, 1, "file_list");
+}
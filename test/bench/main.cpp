@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <windows_stub/config.h>
+
+#include "gtest/gtest.h"
+
+#include "util/Benchmark.h"
+
+#ifdef main
+#undef main
+#endif
+
+namespace {
+
+void print_usage()
+{
+	printf("Usage: fs2open_bench [gtest options] [--json <file>] [--min_time <seconds>]\n");
+	printf("  --json <file>         Where to write the results (default: fs2open_bench.json)\n");
+	printf("  --min_time <seconds>  How long each repetition of a benchmark runs at least (default: 0.05)\n");
+	printf("Use --gtest_filter to only run some of the benchmarks.\n");
+}
+
+}
+
+GTEST_API_ int main(int argc, char **argv) {
+	// This removes all gtest options from argv
+	testing::InitGoogleTest(&argc, argv);
+
+	const char* json_file = "fs2open_bench.json";
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+			json_file = argv[++i];
+		} else if (!strcmp(argv[i], "--min_time") && i + 1 < argc) {
+			bench::set_min_time(atof(argv[++i]));
+		} else {
+			print_usage();
+			return 1;
+		}
+	}
+
+	// Open the output before changing the directory so that relative paths work as expected
+	FILE* fp = fopen(json_file, "w");
+	if (fp == nullptr) {
+		fprintf(stderr, "Could not open %s for writing!\n", json_file);
+		return 1;
+	}
+
+	// Always change to the test data directory
+	_chdir(TEST_DATA_PATH);
+
+	int ret = RUN_ALL_TESTS();
+
+	if (!bench::write_json(fp)) {
+		fprintf(stderr, "Failed to write the results to %s!\n", json_file);
+		ret = 1;
+	}
+	fclose(fp);
+
+	return ret;
+}
@@ -0,0 +1,124 @@
+#include <math/fvi.h>
+#include <math/vecmat.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+namespace {
+const size_t NUM_RAYS = 1024;
+}
+
+class FviBench : public test::FSTestFixture {
+  public:
+	FviBench() : test::FSTestFixture(INIT_NONE) { pushModDir("fvi"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		// Rays which start around the origin and end somewhere in a box around it, so some of them hit and some don't
+		starts = bench::random_vectors(NUM_RAYS, 100.0f, 1);
+		ends = bench::random_vectors(NUM_RAYS, 1000.0f, 2);
+
+		dirs.resize(NUM_RAYS);
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			vm_vec_sub(&dirs[i], &ends[i], &starts[i]);
+		}
+
+		// A triangle in front of the rays
+		tri[0] = vec3d{ {{-300.0f, -300.0f, 400.0f}} };
+		tri[1] = vec3d{ {{300.0f, -300.0f, 400.0f}} };
+		tri[2] = vec3d{ {{0.0f, 300.0f, 400.0f}} };
+		tri_norm = vec3d{ {{0.0f, 0.0f, -1.0f}} };
+		tri_verts[0] = &tri[0];
+		tri_verts[1] = &tri[1];
+		tri_verts[2] = &tri[2];
+	}
+
+	SCP_vector<vec3d> starts;
+	SCP_vector<vec3d> ends;
+	SCP_vector<vec3d> dirs;
+
+	vec3d tri[3];
+	vec3d tri_norm;
+	const vec3d* tri_verts[3];
+
+	const vec3d sphere_pos = { {{200.0f, 100.0f, 300.0f}} };
+	const float sphere_rad = 250.0f;
+};
+
+TEST_F(FviBench, segment_sphere) {
+	bench::run([&]() {
+		int hits = 0;
+		vec3d hit;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			hits += fvi_segment_sphere(&hit, &starts[i], &ends[i], &sphere_pos, sphere_rad);
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
+
+TEST_F(FviBench, ray_sphere) {
+	bench::run([&]() {
+		int hits = 0;
+		vec3d hit;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			hits += fvi_ray_sphere(&hit, &starts[i], &ends[i], &sphere_pos, sphere_rad);
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
+
+TEST_F(FviBench, ray_boundingbox) {
+	const vec3d box_min = { {{-200.0f, -200.0f, 200.0f}} };
+	const vec3d box_max = { {{200.0f, 200.0f, 600.0f}} };
+
+	bench::run([&]() {
+		int hits = 0;
+		vec3d hit;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			hits += fvi_ray_boundingbox(&box_min, &box_max, &starts[i], &dirs[i], &hit);
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
+
+// What model collision does for every polygon: intersect the plane, then check if the hit is inside the polygon
+TEST_F(FviBench, ray_plane_point_face) {
+	bench::run([&]() {
+		int hits = 0;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			vec3d hit;
+			float dist = fvi_ray_plane(&hit, &tri[0], &tri_norm, &starts[i], &dirs[i], 0.0f);
+			if (dist >= 0.0f && dist <= 1.0f) {
+				hits += fvi_point_face(&hit, 3, tri_verts, &tri_norm, nullptr, nullptr, nullptr);
+			}
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
+
+TEST_F(FviBench, polyedge_sphereline) {
+	bench::run([&]() {
+		int hits = 0;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			vec3d hit;
+			float hit_time;
+			hits += fvi_polyedge_sphereline(&hit, &starts[i], &dirs[i], 20.0f, 3, tri_verts, &hit_time);
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
+
+TEST_F(FviBench, sphere_plane) {
+	bench::run([&]() {
+		int hits = 0;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			vec3d hit;
+			float hit_time, delta_time;
+			hits += fvi_sphere_plane(&hit, &starts[i], &dirs[i], 20.0f, &tri_norm, &tri[0], &hit_time, &delta_time);
+		}
+		bench::do_not_optimize(hits);
+	}, NUM_RAYS);
+}
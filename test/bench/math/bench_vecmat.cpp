@@ -0,0 +1,140 @@
+#include <math/vecmat.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+namespace {
+const size_t NUM_VECTORS = 1024;
+}
+
+class VecmatBench : public test::FSTestFixture {
+  public:
+	VecmatBench() : test::FSTestFixture(INIT_NONE) { pushModDir("vecmat"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		src = bench::random_vectors(NUM_VECTORS, 1000.0f);
+		dest.resize(NUM_VECTORS);
+		values.resize(NUM_VECTORS);
+
+		auto axes = bench::random_vectors(2, 1.0f, 2);
+		vm_vector_2_matrix_norm(&orient, &axes[0], &axes[1]);
+		pos = bench::random_vectors(1, 1000.0f, 3)[0];
+	}
+
+	SCP_vector<vec3d> src;
+	SCP_vector<vec3d> dest;
+	SCP_vector<float> values;
+	matrix orient;
+	vec3d pos;
+};
+
+TEST_F(VecmatBench, rotate) {
+	bench::run([&]() {
+		for (size_t i = 0; i < NUM_VECTORS; ++i) {
+			vm_vec_rotate(&dest[i], &src[i], &orient);
+		}
+		bench::do_not_optimize(dest);
+	}, NUM_VECTORS, "single");
+
+	bench::run([&]() {
+		vm_vec_rotate_batch(dest.data(), src.data(), NUM_VECTORS, &orient);
+		bench::do_not_optimize(dest);
+	}, NUM_VECTORS, "batch");
+}
+
+TEST_F(VecmatBench, local_to_global) {
+	bench::run([&]() {
+		for (size_t i = 0; i < NUM_VECTORS; ++i) {
+			vec3d tmp;
+			vm_vec_unrotate(&tmp, &src[i], &orient);
+			vm_vec_add(&dest[i], &tmp, &pos);
+		}
+		bench::do_not_optimize(dest);
+	}, NUM_VECTORS, "single");
+
+	bench::run([&]() {
+		vm_vec_local_to_global_batch(dest.data(), src.data(), NUM_VECTORS, &orient, &pos);
+		bench::do_not_optimize(dest);
+	}, NUM_VECTORS, "batch");
+}
+
+TEST_F(VecmatBench, dist) {
+	bench::run([&]() {
+		for (size_t i = 0; i < NUM_VECTORS; ++i) {
+			values[i] = vm_vec_dist(&src[i], &pos);
+		}
+		bench::do_not_optimize(values);
+	}, NUM_VECTORS, "single");
+
+	bench::run([&]() {
+		vm_vec_dist_batch(values.data(), src.data(), NUM_VECTORS, &pos);
+		bench::do_not_optimize(values);
+	}, NUM_VECTORS, "batch");
+}
+
+TEST_F(VecmatBench, cull_spheres) {
+	// The sides of a frustum-like box around the origin
+	const vec3d norms[6] = { {{{1, 0, 0}}}, {{{-1, 0, 0}}}, {{{0, 1, 0}}}, {{{0, -1, 0}}}, {{{0, 0, 1}}}, {{{0, 0, -1}}} };
+	const vec3d points[6] = { {{{-500, 0, 0}}}, {{{500, 0, 0}}}, {{{0, -500, 0}}}, {{{0, 500, 0}}}, {{{0, 0, -500}}}, {{{0, 0, 500}}} };
+
+	SCP_vector<float> radii(NUM_VECTORS, 50.0f);
+	SCP_vector<ubyte> visible(NUM_VECTORS);
+
+	bench::run([&]() {
+		for (size_t i = 0; i < NUM_VECTORS; ++i) {
+			visible[i] = 1;
+			for (int p = 0; p < 6; ++p) {
+				if (vm_dist_to_plane(&src[i], &norms[p], &points[p]) < -radii[i]) {
+					visible[i] = 0;
+					break;
+				}
+			}
+		}
+		bench::do_not_optimize(visible);
+	}, NUM_VECTORS, "single");
+
+	bench::run([&]() {
+		bench::do_not_optimize(vm_cull_spheres_batch(visible.data(), src.data(), radii.data(), NUM_VECTORS, norms, points, 6));
+	}, NUM_VECTORS, "batch");
+}
+
+TEST_F(VecmatBench, matrix_x_matrix) {
+	auto vectors = bench::random_vectors(2 * NUM_VECTORS, 1.0f);
+	SCP_vector<matrix> matrices(NUM_VECTORS);
+	for (size_t i = 0; i < NUM_VECTORS; ++i) {
+		vm_vector_2_matrix_norm(&matrices[i], &vectors[2 * i], &vectors[2 * i + 1]);
+	}
+
+	bench::run([&]() {
+		matrix result = vmd_identity_matrix;
+		for (const auto& m : matrices) {
+			matrix tmp;
+			vm_matrix_x_matrix(&tmp, &result, &m);
+			result = tmp;
+		}
+		bench::do_not_optimize(result);
+	}, NUM_VECTORS);
+}
+
+TEST_F(VecmatBench, vector_2_matrix) {
+	bench::run([&]() {
+		matrix m;
+		for (size_t i = 0; i + 1 < NUM_VECTORS; i += 2) {
+			vm_vector_2_matrix(&m, &src[i], &src[i + 1], nullptr);
+			bench::do_not_optimize(m);
+		}
+	}, NUM_VECTORS / 2);
+}
+
+TEST_F(VecmatBench, normalize) {
+	bench::run([&]() {
+		for (size_t i = 0; i < NUM_VECTORS; ++i) {
+			values[i] = vm_vec_copy_normalize(&dest[i], &src[i]);
+		}
+		bench::do_not_optimize(dest);
+	}, NUM_VECTORS);
+}
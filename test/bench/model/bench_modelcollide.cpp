@@ -0,0 +1,82 @@
+#include <cfile/cfile.h>
+#include <model/model.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+namespace {
+const size_t NUM_RAYS = 256;
+
+// A sphere of 320 triangles in a BSP tree with up to 8 triangles per leaf and an 80 triangle shield around it, see
+// test_data/model_collide/test_pof/data/models
+const char* const BENCH_MODEL = "bench.pof";
+}
+
+class ModelCollideBench : public test::FSTestFixture {
+  public:
+	ModelCollideBench() : test::FSTestFixture(INIT_CFILE | INIT_GRAPHICS) { pushModDir("model_collide"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		// The model code can only be initialized once
+		static bool model_initialized = false;
+		if (!model_initialized) {
+			model_init();
+			model_initialized = true;
+		}
+	}
+	void TearDown() override
+	{
+		model_free_all();
+
+		test::FSTestFixture::TearDown();
+	}
+};
+
+TEST_F(ModelCollideBench, test_pof) {
+	ASSERT_TRUE(cf_exists_full(BENCH_MODEL, CF_TYPE_MODELS)) << BENCH_MODEL << " was not found in the test data";
+
+	int model_num = model_load(BENCH_MODEL, 0, nullptr);
+	ASSERT_GE(model_num, 0);
+
+	auto pm = model_get(model_num);
+
+	// Rays from outside the model through random points inside of its radius
+	auto starts = bench::random_vectors(NUM_RAYS, 1.0f, 1);
+	auto ends = bench::random_vectors(NUM_RAYS, pm->rad, 2);
+	for (auto& start : starts) {
+		vm_vec_normalize_safe(&start);
+		vm_vec_scale(&start, 2.0f * pm->rad);
+	}
+
+	matrix orient = vmd_identity_matrix;
+	vec3d pos = vmd_zero_vector;
+
+	auto collide_all = [&](int flags, float radius) {
+		int hits = 0;
+		for (size_t i = 0; i < NUM_RAYS; ++i) {
+			mc_info mc;
+			mc_info_init(&mc);
+
+			mc.model_num = model_num;
+			mc.orient = &orient;
+			mc.pos = &pos;
+			mc.p0 = &starts[i];
+			mc.p1 = &ends[i];
+			mc.flags = flags;
+			mc.radius = radius;
+
+			hits += model_collide(&mc);
+		}
+		bench::do_not_optimize(hits);
+	};
+
+	bench::run([&]() { collide_all(MC_CHECK_MODEL, 0.0f); }, NUM_RAYS, "ray");
+	bench::run([&]() { collide_all(MC_CHECK_MODEL | MC_CHECK_SPHERELINE, pm->rad * 0.05f); }, NUM_RAYS, "sphereline");
+
+	ASSERT_GT(pm->shield.ntris, 0);
+	bench::run([&]() { collide_all(MC_CHECK_SHIELD, 0.0f); }, NUM_RAYS, "shield");
+}
@@ -0,0 +1,78 @@
+#include <object/objcollide.h>
+#include <object/object.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+class ObjCollideBench : public test::FSTestFixture {
+  public:
+	ObjCollideBench() : test::FSTestFixture(INIT_NONE) { pushModDir("objcollide"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		obj_init();
+	}
+	void TearDown() override
+	{
+		// The objects don't have any instance data, so just forget about them instead of deleting them
+		obj_init();
+
+		test::FSTestFixture::TearDown();
+	}
+
+	// Creates a cloud of objects in a sphere. The objects are debris so that the narrow phase doesn't need any ship or
+	// weapon data, which means this measures the sorting and pair finding.
+	SCP_vector<int> create_cloud(size_t num_objects, float cloud_radius, float object_radius)
+	{
+		auto positions = bench::random_vectors(num_objects, cloud_radius);
+
+		flagset<Object::Object_Flags> flags;
+		flags.set(Object::Object_Flags::Collides);
+
+		matrix orient = vmd_identity_matrix;
+
+		SCP_vector<int> objects;
+		for (auto& pos : positions) {
+			int objnum = obj_create(OBJ_DEBRIS, -1, -1, &orient, &pos, object_radius, flags);
+			if (objnum < 0) {
+				break;
+			}
+			objects.push_back(objnum);
+		}
+
+		return objects;
+	}
+
+	void run_cloud(size_t num_objects, float cloud_radius, float object_radius, const char* name)
+	{
+		auto objects = create_cloud(num_objects, cloud_radius, object_radius);
+		ASSERT_EQ(objects.size(), num_objects);
+
+		// The list is sorted in place, so start every run from the same order
+		SCP_vector<int> collision_list;
+		bench::run([&]() {
+			collision_list = objects;
+			obj_sort_and_collide(&collision_list);
+		}, num_objects, name);
+	}
+};
+
+TEST_F(ObjCollideBench, sparse_cloud) {
+	run_cloud(250, 10000.0f, 50.0f, "250");
+	obj_init();
+	run_cloud(1000, 10000.0f, 50.0f, "1000");
+	obj_init();
+	run_cloud(3000, 10000.0f, 50.0f, "3000");
+}
+
+// A battle where many objects overlap on at least one axis
+TEST_F(ObjCollideBench, dense_cloud) {
+	run_cloud(250, 2000.0f, 100.0f, "250");
+	obj_init();
+	run_cloud(1000, 2000.0f, 100.0f, "1000");
+	obj_init();
+	run_cloud(3000, 2000.0f, 100.0f, "3000");
+}
@@ -0,0 +1,137 @@
+#include <cmdline/cmdline.h>
+#include <def_files/def_files.h>
+#include <parse/parselo.h>
+#include <parse/table_cache.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+namespace {
+const int NUM_ENTRIES = 500;
+
+// A table that looks like a typical weapons.tbl
+SCP_string make_table()
+{
+	SCP_string table = "; A generated table\n#Weapon Classes\n";
+
+	for (int i = 0; i < NUM_ENTRIES; ++i) {
+		char entry[1024];
+		sprintf(entry,
+			"\n$Name: Weapon %d\n"
+			"$Model File: weapon%d.pof\n"
+			"$Mass: %d.5\n"
+			"$Velocity: %d\n"
+			"$Damage: %d.25 ; the damage per hit\n"
+			"$Position: %d.0, 2.0, -%d.5\n"
+			"/* A comment\n   spanning two lines */\n"
+			"$Flags: ( \"in tech database\" \"player allowed\" )\n"
+			"$Icon: iconweapon%d\n",
+			i, i, i, 400 + i, i % 50, i, i, i);
+		table += entry;
+	}
+
+	table += "\n#End\n";
+	return table;
+}
+}
+
+class ParseloBench : public test::FSTestFixture {
+  public:
+	ParseloBench() : test::FSTestFixture(INIT_CFILE) { pushModDir("parselo"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		table = make_table();
+
+		file.filename = "bench.tbl";
+		file.data = table.c_str();
+		file.size = table.size();
+	}
+	void TearDown() override
+	{
+		stop_parse();
+		Cmdline_table_cache = false;
+
+		test::FSTestFixture::TearDown();
+	}
+
+	SCP_string table;
+	default_file file;
+};
+
+// Copying the raw text and stripping the comments
+TEST_F(ParseloBench, process_text) {
+	bench::run([&]() { read_file_text_from_default(file); }, table.size());
+}
+
+// What -table_cache saves: stripping the comments...
+TEST_F(ParseloBench, strip_comments) {
+	SCP_vector<char> raw(table.begin(), table.end());
+	raw.push_back('\0');
+	SCP_vector<char> processed(raw.size());
+
+	bench::run([&]() { process_raw_file_text(processed.data(), raw.data()); }, table.size());
+}
+
+// ...against reading the result from the cache. Parsing the text (see tokenize) still happens either way.
+TEST_F(ParseloBench, strip_comments_cached) {
+	SCP_vector<char> raw(table.begin(), table.end());
+	raw.push_back('\0');
+	SCP_vector<char> processed(raw.size());
+
+	Cmdline_table_cache = true;
+	process_raw_file_text(processed.data(), raw.data());
+	table_cache_write(table.c_str(), table.size(), processed.data());
+	ASSERT_TRUE(table_cache_read(table.c_str(), table.size(), processed.data(), processed.size()));
+
+	bench::run([&]() { table_cache_read(table.c_str(), table.size(), processed.data(), processed.size()); },
+		table.size());
+}
+
+TEST_F(ParseloBench, tokenize) {
+	read_file_text_from_default(file);
+
+	bench::run([&]() {
+		reset_parse();
+
+		required_string("#Weapon Classes");
+
+		while (optional_string("$Name:")) {
+			SCP_string name, model, icon;
+			float mass, damage;
+			int velocity;
+			vec3d position;
+			SCP_vector<SCP_string> flags;
+
+			stuff_string(name, F_NAME);
+
+			required_string("$Model File:");
+			stuff_string(model, F_NAME);
+
+			required_string("$Mass:");
+			stuff_float(&mass);
+
+			required_string("$Velocity:");
+			stuff_int(&velocity);
+
+			required_string("$Damage:");
+			stuff_float(&damage);
+
+			required_string("$Position:");
+			stuff_vec3d(&position);
+
+			required_string("$Flags:");
+			stuff_string_list(flags);
+
+			required_string("$Icon:");
+			stuff_string(icon, F_NAME);
+
+			bench::do_not_optimize(position);
+		}
+
+		required_string("#End");
+	}, NUM_ENTRIES);
+}
@@ -0,0 +1,83 @@
+#include <parse/parselo.h>
+#include <parse/sexp.h>
+#include <parse/sexp/sexp_bytecode.h>
+
+#include "util/Benchmark.h"
+#include "util/FSTestFixture.h"
+
+namespace {
+const int NUM_FORMULAS = 100;
+
+// Something like a typical event formula, with the numbers varied so not every formula has the same value
+SCP_string make_formula(int i)
+{
+	char formula[1024];
+	sprintf(formula,
+		"( when "
+		"( and "
+		"( > ( + %d 4 ) 5 ) "
+		"( < ( * 2 %d ) 700 ) "
+		"( or ( = %d 2 ) ( >= ( - 1000 %d ) 600 ) ) "
+		"( not ( = ( mod %d 7 ) 3 ) ) "
+		") "
+		"( do-nothing ) "
+		")",
+		i, i, i % 3, i * 10, i);
+
+	return formula;
+}
+}
+
+class SexpBench : public test::FSTestFixture {
+  public:
+	SexpBench() : test::FSTestFixture(INIT_CFILE) { pushModDir("sexp"); }
+
+  protected:
+	void SetUp() override
+	{
+		test::FSTestFixture::SetUp();
+
+		init_sexp();
+
+		for (int i = 0; i < NUM_FORMULAS; ++i) {
+			SCP_string text = make_formula(i);
+
+			SCP_vector<char> buffer(text.begin(), text.end());
+			buffer.push_back('\0');
+			Mp = buffer.data();
+
+			int node = get_sexp_main();
+			ASSERT_GE(node, 0);
+			formulas.push_back(node);
+		}
+	}
+	void TearDown() override
+	{
+		sexp_shutdown();
+
+		test::FSTestFixture::TearDown();
+	}
+
+	void eval_all()
+	{
+		int value = 0;
+		for (auto node : formulas) {
+			value += eval_sexp(node);
+		}
+		bench::do_not_optimize(value);
+	}
+
+	SCP_vector<int> formulas;
+};
+
+TEST_F(SexpBench, eval_tree) {
+	bench::run([&]() { eval_all(); }, NUM_FORMULAS);
+}
+
+TEST_F(SexpBench, eval_compiled) {
+	for (auto node : formulas) {
+		ASSERT_TRUE(sexp::compile_formula(node));
+	}
+
+	bench::run([&]() { eval_all(); }, NUM_FORMULAS);
+}
@@ -0,0 +1,35 @@
+set(source_files)
+
+add_file_folder(""
+    main.cpp
+    ../src/test_stubs.cpp
+)
+
+add_file_folder("CFile"
+    cfile/bench_cfile.cpp
+)
+
+add_file_folder("Math"
+    math/bench_fvi.cpp
+    math/bench_vecmat.cpp
+)
+
+add_file_folder("Model"
+    model/bench_modelcollide.cpp
+)
+
+add_file_folder("Object"
+    object/bench_objcollide.cpp
+)
+
+add_file_folder("Parse"
+    parse/bench_parselo.cpp
+    parse/bench_sexp.cpp
+)
+
+add_file_folder("Test Util"
+    ../src/util/FSTestFixture.cpp
+    ../src/util/FSTestFixture.h
+    util/Benchmark.cpp
+    util/Benchmark.h
+)
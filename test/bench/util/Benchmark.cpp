@@ -0,0 +1,162 @@
+#include "Benchmark.h"
+
+#include <globalincs/version.h>
+#include <libs/jansson.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <ctime>
+#include <random>
+
+namespace {
+
+const int NUM_REPETITIONS = 5;
+
+double Min_time = 0.05;
+
+SCP_vector<bench::result> Results;
+
+typedef std::chrono::steady_clock bench_clock;
+
+double time_calls(const std::function<void()>& func, size_t calls)
+{
+	auto start = bench_clock::now();
+	for (size_t i = 0; i < calls; ++i) {
+		func();
+	}
+	auto end = bench_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+SCP_string get_result_name(const char* suffix)
+{
+	auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+
+	SCP_string name;
+	if (test_info != nullptr) {
+		name = SCP_string(test_info->test_case_name()) + "." + test_info->name();
+	}
+
+	if (suffix != nullptr) {
+		if (!name.empty()) {
+			name += ".";
+		}
+		name += suffix;
+	}
+
+	return name;
+}
+
+}
+
+namespace bench {
+
+void set_min_time(double seconds)
+{
+	Min_time = seconds;
+}
+
+void run(const std::function<void()>& func, size_t items, const char* suffix)
+{
+	// Warm up the caches and anything that is initialized lazily
+	func();
+
+	// Find a batch size that takes long enough for the clock resolution to not matter
+	const double min_time_ns = Min_time * 1e9;
+	size_t batch = 1;
+	double batch_ns;
+	while ((batch_ns = time_calls(func, batch)) < min_time_ns) {
+		if (batch_ns <= 0.0) {
+			batch *= 10;
+		} else {
+			// Aim a bit higher than needed so this usually only needs one more round
+			batch = std::max(batch * 2, (size_t)(batch * 1.2 * min_time_ns / batch_ns));
+		}
+	}
+
+	result res;
+	res.name = get_result_name(suffix);
+	res.items = items;
+
+	double total_ns = 0.0;
+	double min_batch_ns = batch_ns;
+	for (int i = 0; i < NUM_REPETITIONS; ++i) {
+		batch_ns = time_calls(func, batch);
+
+		total_ns += batch_ns;
+		min_batch_ns = std::min(min_batch_ns, batch_ns);
+	}
+
+	res.calls = batch * NUM_REPETITIONS;
+	res.mean_ns = total_ns / res.calls;
+	res.min_ns = min_batch_ns / batch;
+
+	printf("[ BENCH    ] %s: %.1f ns per call, %.2f ns per item (min %.1f ns per call)\n", res.name.c_str(), res.mean_ns,
+		res.mean_ns / items, res.min_ns);
+
+	Results.push_back(res);
+}
+
+void use_pointer(const void* ptr)
+{
+	// Storing the pointer somewhere the compiler can't see through is enough
+	static const void* volatile sink;
+	sink = ptr;
+}
+
+SCP_vector<vec3d> random_vectors(size_t n, float scale, unsigned int seed)
+{
+	// The distributions of the standard library are implementation defined, the engine itself is not
+	std::mt19937 gen(seed);
+	auto next = [&]() { return (float)(gen() / 4294967296.0 * 2.0 - 1.0) * scale; };
+
+	SCP_vector<vec3d> out(n);
+	for (auto& v : out) {
+		v.xyz.x = next();
+		v.xyz.y = next();
+		v.xyz.z = next();
+	}
+	return out;
+}
+
+const SCP_vector<result>& results()
+{
+	return Results;
+}
+
+bool write_json(FILE* fp)
+{
+	std::unique_ptr<json_t> benchmarks(json_array());
+
+	for (const auto& res : Results) {
+		json_array_append_new(benchmarks.get(),
+			json_pack("{sssIsIsfsfsf}",
+				"name", res.name.c_str(),
+				"calls", (json_int_t)res.calls,
+				"items", (json_int_t)res.items,
+				"ns_per_call", res.mean_ns,
+				"min_ns_per_call", res.min_ns,
+				"ns_per_item", res.mean_ns / res.items));
+	}
+
+	char timestamp[64];
+	auto now = time(nullptr);
+	strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+	std::unique_ptr<json_t> root(json_pack("{sssssssfsO}",
+		"version", gameversion::get_version_string().c_str(),
+#ifdef NDEBUG
+		"build_type", "release",
+#else
+		"build_type", "debug",
+#endif
+		"timestamp", timestamp,
+		"min_time", Min_time,
+		"benchmarks", benchmarks.get()));
+
+	return root && json_dumpf(root.get(), fp, JSON_INDENT(2)) == 0;
+}
+
+}
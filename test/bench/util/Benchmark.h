@@ -0,0 +1,69 @@
+#pragma once
+
+#include <globalincs/pstypes.h>
+
+#include <cstdio>
+#include <functional>
+
+namespace bench {
+
+/**
+ * @brief The timing of one benchmark
+ */
+struct result {
+	SCP_string name;
+	size_t calls = 0;         // how often the benchmarked function was called in total
+	size_t items = 1;         // how many items (vectors, pairs, tokens...) one call processes
+	double mean_ns = 0.0;     // the average time of one call over all repetitions
+	double min_ns = 0.0;      // the average time of one call in the fastest repetition
+};
+
+/**
+ * @brief Sets how long each repetition of a benchmark runs at least
+ */
+void set_min_time(double seconds);
+
+/**
+ * @brief Times a function and records the result under the name of the current test
+ *
+ * The function is called once to warm up, then in batches which are grown until a batch takes the minimum time.
+ * That batch is then repeated a few times. The fastest repetition is usually the most stable number to compare
+ * between builds.
+ *
+ * @param func   The function to time. Every call should do the same amount of work.
+ * @param items  The number of items one call of func processes
+ * @param suffix Appended to the name of the test to tell several benchmarks of one test apart
+ */
+void run(const std::function<void()>& func, size_t items = 1, const char* suffix = nullptr);
+
+/**
+ * @brief Keeps the compiler from optimizing away the computation of a value that is not used otherwise
+ */
+void use_pointer(const void* ptr);
+
+template <typename T>
+void do_not_optimize(const T& value)
+{
+	use_pointer(&value);
+}
+
+/**
+ * @brief Generates vectors with components in [-scale, scale]
+ *
+ * The same seed always gives the same vectors so that the benchmarks process the same data in every build.
+ */
+SCP_vector<vec3d> random_vectors(size_t n, float scale, unsigned int seed = 1);
+
+/**
+ * @brief All results recorded so far
+ */
+const SCP_vector<result>& results();
+
+/**
+ * @brief Writes all results as JSON
+ *
+ * @returns true if the file was written
+ */
+bool write_json(FILE* fp);
+
+}
@@ -0,0 +1,247 @@
+
+#include <gtest/gtest.h>
+#include <bmpman/bmpman.h>
+#include <cmdline/cmdline.h>
+#include <ddsutils/ddsutils.h>
+#include <globalincs/systemvars.h>
+
+#include "util/FSTestFixture.h"
+
+class BmpmanTest : public test::FSTestFixture {
+ public:
+	BmpmanTest() : test::FSTestFixture(INIT_GRAPHICS | INIT_CFILE) {
+		pushModDir("bmpman");
+	}
+
+ protected:
+	void SetUp() override {
+		test::FSTestFixture::SetUp();
+
+		// A standalone server replaces every bitmap with the same placeholder so the real files need a normal client
+		Is_standalone = 0;
+
+		m_use_compression = Use_compressed_textures;
+	}
+	void TearDown() override {
+		bm_set_memory_budget(0, 0);
+		Cmdline_compress_textures = false;
+		Use_compressed_textures = m_use_compression;
+		Is_standalone = 1;
+
+		test::FSTestFixture::TearDown();
+	}
+
+	static void use_bitmap(int handle) {
+		ASSERT_NE(nullptr, bm_lock(handle, 32, BMP_TEX_OTHER));
+		bm_unlock(handle);
+	}
+
+	static SCP_vector<ubyte> lock_pixels(int handle, ushort flags, size_t size) {
+		auto bmp = bm_lock(handle, 32, flags);
+		if (bmp == nullptr) {
+			return SCP_vector<ubyte>();
+		}
+
+		auto data = reinterpret_cast<const ubyte*>(bmp->data);
+		SCP_vector<ubyte> pixels(data, data + size);
+		bm_unlock(handle);
+
+		return pixels;
+	}
+
+	static void unpack_565(int color, int* rgb) {
+		rgb[0] = ((color >> 11) & 0x1f) * 255 / 31;
+		rgb[1] = ((color >> 5) & 0x3f) * 255 / 63;
+		rgb[2] = (color & 0x1f) * 255 / 31;
+	}
+
+	int m_use_compression = 0;
+
+	// Decodes the RGB colors of a BC1 block, independent of the encoder in ddsutils
+	static void decode_color_block(const ubyte* block, int colors[16][3]) {
+		int color0 = block[0] | (block[1] << 8);
+		int color1 = block[2] | (block[3] << 8);
+
+		int palette[4][3];
+		unpack_565(color0, palette[0]);
+		unpack_565(color1, palette[1]);
+		for (int c = 0; c < 3; ++c) {
+			if (color0 > color1) {
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			} else {
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+
+		uint indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((uint)block[7] << 24);
+		for (int i = 0; i < 16; ++i) {
+			memcpy(colors[i], palette[(indices >> (i * 2)) & 3], sizeof(colors[i]));
+		}
+	}
+
+	// Decodes the alpha values of a BC3 block
+	static void decode_alpha_block(const ubyte* block, int alphas[16]) {
+		int palette[8];
+		palette[0] = block[0];
+		palette[1] = block[1];
+		if (palette[0] > palette[1]) {
+			for (int p = 1; p < 7; ++p) {
+				palette[p + 1] = ((7 - p) * palette[0] + p * palette[1]) / 7;
+			}
+		} else {
+			for (int p = 1; p < 5; ++p) {
+				palette[p + 1] = ((5 - p) * palette[0] + p * palette[1]) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		uint64_t indices = 0;
+		for (int i = 0; i < 6; ++i) {
+			indices |= (uint64_t)block[2 + i] << (i * 8);
+		}
+		for (int i = 0; i < 16; ++i) {
+			alphas[i] = palette[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	// Compares the top level of compressed data with the 32-bit BGRA pixels it was made from
+	static void expect_similar(const SCP_vector<ubyte>& pixels, int w, int h, int compression, const ubyte* compressed) {
+		const int color_tolerance = 24;
+		const int alpha_tolerance = 8;
+
+		for (int by = 0; by < h; by += 4) {
+			for (int bx = 0; bx < w; bx += 4) {
+				int alphas[16];
+				if (compression == DDS_DXT5) {
+					decode_alpha_block(compressed, alphas);
+					compressed += 8;
+				}
+
+				int colors[16][3];
+				decode_color_block(compressed, colors);
+				compressed += 8;
+
+				for (int i = 0; i < 16; ++i) {
+					auto pixel = &pixels[((by + i / 4) * w + bx + i % 4) * 4];
+
+					EXPECT_NEAR(pixel[2], colors[i][0], color_tolerance) << "red at " << bx + i % 4 << "," << by + i / 4;
+					EXPECT_NEAR(pixel[1], colors[i][1], color_tolerance) << "green at " << bx + i % 4 << "," << by + i / 4;
+					EXPECT_NEAR(pixel[0], colors[i][2], color_tolerance) << "blue at " << bx + i % 4 << "," << by + i / 4;
+					if (compression == DDS_DXT5) {
+						EXPECT_NEAR(pixel[3], alphas[i], alpha_tolerance) << "alpha at " << bx + i % 4 << "," << by + i / 4;
+					}
+				}
+			}
+		}
+	}
+};
+
+TEST_F(BmpmanTest, eviction_keeps_current_frame) {
+	ASSERT_EQ((size_t)0, bm_texture_ram);
+
+	auto old_handle = bm_load("evict_old");
+	ASSERT_GE(old_handle, 0);
+	auto current_handle = bm_load("evict_current");
+	ASSERT_GE(current_handle, 0);
+
+	use_bitmap(old_handle);
+	bm_end_frame();
+	auto old_ram = bm_texture_ram;
+	ASSERT_GT(old_ram, (size_t)0);
+
+	use_bitmap(current_handle);
+	auto current_ram = bm_texture_ram - old_ram;
+	ASSERT_GT(current_ram, (size_t)0);
+
+	// Way over the budget, everything that is not needed right now has to go
+	bm_set_memory_budget(1, 0);
+	bm_end_frame();
+
+	ASSERT_EQ(current_ram, bm_texture_ram);
+
+	// The bitmap was not used in this frame so now it is fair game
+	bm_end_frame();
+
+	ASSERT_EQ((size_t)0, bm_texture_ram);
+}
+
+TEST_F(BmpmanTest, compress_round_trip) {
+	auto handle = bm_load("compress_source");
+	ASSERT_GE(handle, 0);
+
+	int w, h;
+	bm_get_info(handle, &w, &h);
+	ASSERT_EQ(8, w);
+	ASSERT_EQ(8, h);
+
+	auto pixels = lock_pixels(handle, BMP_TEX_OTHER, (size_t)w * h * 4);
+	ASSERT_FALSE(pixels.empty());
+
+	for (auto compression : {DDS_DXT1, DDS_DXT5}) {
+		SCOPED_TRACE(compression);
+
+		// 8x8, 4x4, 2x2 and 1x1, the last two levels are padded to full blocks
+		auto size = dds_compressed_size(w, h, 4, compression);
+		ASSERT_EQ((size_t)(4 + 1 + 1 + 1) * (compression == DDS_DXT1 ? 8 : 16), size);
+
+		// one extra byte to check that nothing is written past the end
+		SCP_vector<ubyte> compressed(size + 1, 0xcd);
+		dds_compress_image(pixels.data(), w, h, 32, 4, compression, compressed.data());
+
+		ASSERT_EQ(0xcd, compressed[size]);
+		expect_similar(pixels, w, h, compression, compressed.data());
+	}
+}
+
+TEST_F(BmpmanTest, load_compression_is_opt_in) {
+	Use_compressed_textures = 1;
+	Cmdline_compress_textures = true;
+
+	// A 32-bit TGA becomes DXT5, a JPG is always 24-bit and becomes DXT1
+	struct source {
+		const char* filename;
+		int bpp;
+		int compression;
+		ushort flags;
+	};
+	for (auto& src : {source{"compress_source", 32, DDS_DXT5, BMP_TEX_DXT5},
+	                  source{"compress_jpg", 24, DDS_DXT1, BMP_TEX_DXT1}}) {
+		SCOPED_TRACE(src.filename);
+
+		auto handle = bm_load(src.filename);
+		ASSERT_GE(handle, 0);
+
+		int w, h;
+		bm_get_info(handle, &w, &h);
+		auto pixel_size = (size_t)w * h * (src.bpp >> 3);
+
+		bm_page_in_texture(handle);
+		ASSERT_EQ(src.compression, bm_is_compressed(handle));
+
+		auto levels = bm_get_num_mipmaps(handle);
+		auto compressed_size = dds_compressed_size(w, h, levels, src.compression);
+
+		// Anything that does not ask for the compressed data still gets the pixels of the file
+		auto pixels = lock_pixels(handle, BMP_TEX_OTHER, pixel_size);
+		ASSERT_FALSE(pixels.empty());
+
+		SCP_vector<ubyte> expected(compressed_size);
+		dds_compress_image(pixels.data(), w, h, src.bpp, levels, src.compression, expected.data());
+
+		auto compressed = lock_pixels(handle, src.flags, compressed_size);
+		ASSERT_EQ(expected, compressed);
+
+		// and switching back reads the file again
+		ASSERT_EQ(pixels, lock_pixels(handle, BMP_TEX_OTHER, pixel_size));
+
+		// The data can't be exchanged while somebody else still uses it
+		ASSERT_NE(nullptr, bm_lock(handle, 32, BMP_TEX_OTHER));
+		EXPECT_EQ(nullptr, bm_lock(handle, 32, src.flags));
+		bm_unlock(handle);
+
+		bm_release(handle);
+	}
+}
@@ -719,3 +719,121 @@ TEST_F(VecmatTest, orthogonalize_matrix) {
 	}
 }
 
+
+// The batch functions must give exactly the same results as the single vector functions. The sizes cover the SIMD
+// paths as well as the remainders which don't fill a whole register.
+static const size_t batch_sizes[] = { 0, 1, 3, 4, 5, 8, 9, 17, 100 };
+
+static SCP_vector<vec3d> make_random_vectors(size_t n, float scale) {
+	SCP_vector<vec3d> out(n);
+	for (auto& v : out) {
+		static_randvec_unnormalized(Random::next(), &v);
+		vm_vec_scale(&v, scale);
+	}
+	return out;
+}
+
+static matrix make_random_matrix() {
+	matrix m;
+	for (auto& f : m.a1d)
+		f = frand() - 0.5f;
+	return m;
+}
+
+#define ASSERT_VEC3D_IDENTICAL(a, b) \
+	ASSERT_EQ((a).xyz.x, (b).xyz.x); \
+	ASSERT_EQ((a).xyz.y, (b).xyz.y); \
+	ASSERT_EQ((a).xyz.z, (b).xyz.z);
+
+TEST_F(VecmatTest, test_vm_vec_transform_batch) {
+	for (auto n : batch_sizes) {
+		auto src = make_random_vectors(n, 1000.0f);
+		auto m = make_random_matrix();
+		vec3d pos;
+		static_randvec_unnormalized(Random::next(), &pos);
+
+		SCP_vector<vec3d> rotated(n), unrotated(n), global(n), local(n);
+		vm_vec_rotate_batch(rotated.data(), src.data(), n, &m);
+		vm_vec_unrotate_batch(unrotated.data(), src.data(), n, &m);
+		vm_vec_local_to_global_batch(global.data(), src.data(), n, &m, &pos);
+		vm_vec_global_to_local_batch(local.data(), src.data(), n, &m, &pos);
+
+		for (size_t i = 0; i < n; ++i) {
+			vec3d expected, tmp;
+
+			vm_vec_rotate(&expected, &src[i], &m);
+			ASSERT_VEC3D_IDENTICAL(rotated[i], expected);
+
+			vm_vec_unrotate(&expected, &src[i], &m);
+			ASSERT_VEC3D_IDENTICAL(unrotated[i], expected);
+
+			vm_vec_unrotate(&tmp, &src[i], &m);
+			vm_vec_add(&expected, &tmp, &pos);
+			ASSERT_VEC3D_IDENTICAL(global[i], expected);
+
+			vm_vec_sub(&tmp, &src[i], &pos);
+			vm_vec_rotate(&expected, &tmp, &m);
+			ASSERT_VEC3D_IDENTICAL(local[i], expected);
+		}
+
+		// Transforming in place
+		auto in_place = src;
+		vm_vec_rotate_batch(in_place.data(), in_place.data(), n, &m);
+		for (size_t i = 0; i < n; ++i) {
+			ASSERT_VEC3D_IDENTICAL(in_place[i], rotated[i]);
+		}
+	}
+}
+
+TEST_F(VecmatTest, test_vm_vec_dot_dist_batch) {
+	for (auto n : batch_sizes) {
+		auto v = make_random_vectors(n, 1000.0f);
+		vec3d w;
+		static_randvec_unnormalized(Random::next(), &w);
+		if (n > 0)
+			v[0] = w; // distance 0
+
+		SCP_vector<float> dots(n), dists_squared(n), dists(n);
+		vm_vec_dot_batch(dots.data(), v.data(), n, &w);
+		vm_vec_dist_squared_batch(dists_squared.data(), v.data(), n, &w);
+		vm_vec_dist_batch(dists.data(), v.data(), n, &w);
+
+		for (size_t i = 0; i < n; ++i) {
+			ASSERT_EQ(dots[i], vm_vec_dot(&v[i], &w));
+			ASSERT_EQ(dists_squared[i], vm_vec_dist_squared(&v[i], &w));
+			ASSERT_EQ(dists[i], vm_vec_dist(&v[i], &w));
+		}
+	}
+}
+
+TEST_F(VecmatTest, test_vm_cull_spheres_batch) {
+	vec3d norms[4], points[4];
+	for (int p = 0; p < 4; ++p) {
+		static_randvec(Random::next(), &norms[p]);
+		static_randvec_unnormalized(Random::next(), &points[p]);
+		vm_vec_scale(&points[p], 100.0f);
+	}
+
+	for (auto n : batch_sizes) {
+		auto centers = make_random_vectors(n, 1000.0f);
+		SCP_vector<float> radii(n);
+		for (auto& r : radii)
+			r = frand_range(0.0f, 300.0f);
+
+		SCP_vector<ubyte> visible(n);
+		auto num_visible = vm_cull_spheres_batch(visible.data(), centers.data(), radii.data(), n, norms, points, 4);
+
+		size_t expected_visible = 0;
+		for (size_t i = 0; i < n; ++i) {
+			ubyte expected = 1;
+			for (int p = 0; p < 4; ++p) {
+				if (vm_dist_to_plane(&centers[i], &norms[p], &points[p]) < -radii[i])
+					expected = 0;
+			}
+			expected_visible += expected;
+
+			ASSERT_EQ(visible[i], expected);
+		}
+		ASSERT_EQ(num_visible, expected_visible);
+	}
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <math/fvi.h>
+#include <model/model.h>
+
+#include <random>
+
+#include "util/FSTestFixture.h"
+
+class ModelCollideTest : public test::FSTestFixture {
+ public:
+	ModelCollideTest() : test::FSTestFixture(INIT_CFILE | INIT_GRAPHICS) {
+		pushModDir("model");
+	}
+
+ protected:
+	void SetUp() override {
+		test::FSTestFixture::SetUp();
+
+		// The model code can only be initialized once
+		static bool model_initialized = false;
+		if (!model_initialized) {
+			model_init();
+			model_initialized = true;
+		}
+	}
+	void TearDown() override {
+		model_free_all();
+
+		test::FSTestFixture::TearDown();
+	}
+
+	// The closest shield triangle facing the ray from p0 to p1, found by checking every triangle
+	static int brute_force_shield_hit(const polymodel* pm, const vec3d* p0, const vec3d* p1, float* hit_dist) {
+		vec3d direction;
+		vm_vec_sub(&direction, p1, p0);
+
+		int closest = -1;
+		*hit_dist = FLT_MAX;
+
+		for (int i = 0; i < pm->shield.ntris; ++i) {
+			auto tri = &pm->shield.tris[i];
+
+			if (vm_vec_dot(&direction, &tri->norm) > 0.0f) {
+				continue;
+			}
+
+			const vec3d* points[3];
+			for (int j = 0; j < 3; ++j) {
+				points[j] = &pm->shield.verts[tri->verts[j]].pos;
+			}
+
+			float dist = fvi_ray_plane(nullptr, points[0], &tri->norm, p0, &direction, 0.0f);
+			if (dist < 0.0f || dist > 1.0f || dist >= *hit_dist) {
+				continue;
+			}
+
+			vec3d hit_point;
+			vm_vec_scale_add(&hit_point, p0, &direction, dist);
+
+			if (fvi_point_face(&hit_point, 3, points, &tri->norm, nullptr, nullptr, nullptr)) {
+				closest = i;
+				*hit_dist = dist;
+			}
+		}
+
+		return closest;
+	}
+};
+
+TEST_F(ModelCollideTest, shield_bvh_matches_brute_force) {
+	int model_num = model_load("sphere.pof", 0, nullptr);
+	ASSERT_GE(model_num, 0);
+
+	auto pm = model_get(model_num);
+	ASSERT_GT(pm->shield.ntris, 0);
+
+	// Without a shield collision tree the hierarchy is used
+	ASSERT_EQ(nullptr, pm->shield_collision_tree);
+	ASSERT_FALSE(pm->shield.bvh.empty());
+
+	matrix orient = vmd_identity_matrix;
+	vec3d pos = vmd_zero_vector;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+
+	int hits = 0;
+	for (int i = 0; i < 500; ++i) {
+		// From outside the shield to somewhere around the model, so some rays miss and some end before the shield
+		vec3d p0, p1;
+		for (int axis = 0; axis < 3; ++axis) {
+			p0.a1d[axis] = coordinate(random);
+			p1.a1d[axis] = coordinate(random) * pm->rad * 1.5f;
+		}
+		vm_vec_normalize_safe(&p0);
+		vm_vec_scale(&p0, 2.0f * pm->rad);
+
+		mc_info mc;
+		mc_info_init(&mc);
+
+		mc.model_num = model_num;
+		mc.orient = &orient;
+		mc.pos = &pos;
+		mc.p0 = &p0;
+		mc.p1 = &p1;
+		mc.flags = MC_CHECK_SHIELD;
+
+		int hit = model_collide(&mc);
+
+		float expected_dist;
+		int expected_tri = brute_force_shield_hit(pm, &p0, &p1, &expected_dist);
+
+		SCOPED_TRACE(i);
+		ASSERT_EQ(expected_tri >= 0, hit != 0);
+
+		if (hit) {
+			EXPECT_EQ(expected_tri, mc.shield_hit_tri);
+			EXPECT_NEAR(expected_dist, mc.hit_dist, 0.0001f);
+			++hits;
+		}
+	}
+
+	// Make sure the test is not only checking misses
+	EXPECT_GT(hits, 100);
+}
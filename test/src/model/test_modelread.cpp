@@ -27,6 +27,7 @@ protected:
 
 		pm->submodel = new bsp_info[3];
 		pmi->submodel = new submodel_instance[3];
+		pmi->transforms = new submodel_transform[3];
 
 		pm->submodel[0].parent = -1;
 		pm->submodel[1].parent = 0;
@@ -52,6 +53,7 @@ protected:
 
 		delete[] pm->submodel;
 		delete[] pmi->submodel;
+		delete[] pmi->transforms;
 		delete pm;
 		delete pmi;
 	}
@@ -87,4 +89,29 @@ TEST_F(SubmodelLocalizeTest, submodel_instance_localize_roundtrip_world) {
 
 	EXPECT_VECTOR_NEAR(global, (vec3d{ {{-1.0f, 4.0f, 1.0f}} }));
 	EXPECT_VECTOR_NEAR(roundtrip, local);
-}
\ No newline at end of file
+}
+
+TEST_F(SubmodelLocalizeTest, submodel_instance_transform_cache_invalidation) {
+
+	vec3d before;
+	vec3d after;
+	vec3d expected;
+	vec3d local{ {{0.0f, 1.0f, 0.0f}} };
+	model_instance_local_to_global_point(&before, &local, pm, pmi, 2);
+
+	// rotate the middle submodel, which has to invalidate the cached transform of its child
+	angles ang{ 0.0f, PI_2, 0.0f };
+	vm_angles_2_matrix(&pmi->submodel[1].canonical_orient, &ang);
+	pmi->submodel[1].orient_generation++;
+
+	model_instance_local_to_global_point(&after, &local, pm, pmi, 2);
+
+	// compare against walking up the submodel tree without the cache
+	auto transforms = pmi->transforms;
+	pmi->transforms = nullptr;
+	model_instance_local_to_global_point(&expected, &local, pm, pmi, 2);
+	pmi->transforms = transforms;
+
+	EXPECT_VECTOR_NEAR(before, (vec3d{ {{-1.0f, 1.0f, 1.0f}} }));
+	EXPECT_VECTOR_NEAR(after, expected);
+}
@@ -62,6 +62,39 @@ TEST_F(ParseloTest, utf8_with_bom) {
 	ASSERT_STREQ(content.c_str(), "Hello World");
 }
 
+TEST_F(ParseloTest, string_view) {
+	char text[] = "$Name:   Some Name  \t\n$List: first, second\n$Empty:\n$Name: Some Name\n";
+	reset_parse(text);
+
+	required_string("$Name:");
+	auto view = stuff_string_view();
+	ASSERT_EQ("Some Name", view.to_string());
+	ASSERT_TRUE(view.equals("some name"));
+	ASSERT_FALSE(view.equals("Some"));
+
+	// The view points into the text instead of being a copy
+	ASSERT_EQ(text + strlen("$Name:   "), view.data);
+
+	required_string("$List:");
+	view = stuff_string_view(",");
+	ASSERT_EQ("first", view.to_string());
+	ASSERT_EQ(',', *Mp);
+	Mp++;
+	view = stuff_string_view(",");
+	ASSERT_EQ("second", view.to_string());
+
+	required_string("$Empty:");
+	view = stuff_string_view();
+	ASSERT_TRUE(view.empty());
+	ASSERT_TRUE(view.equals(""));
+
+	// stuff_string reads the same
+	required_string("$Name:");
+	SCP_string content;
+	stuff_string(content, F_RAW);
+	ASSERT_EQ("Some Name", content);
+}
+
 TEST(ParseloUtilTest, drop_trailing_whitespace_cstr) {
 	char test_str[256];
 
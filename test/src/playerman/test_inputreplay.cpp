@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <cfile/cfile.h>
+#include <playerman/inputreplay.h>
+
+#include "util/FSTestFixture.h"
+
+class InputReplayTest : public test::FSTestFixture {
+ public:
+	InputReplayTest() : test::FSTestFixture(INIT_CFILE) {
+		pushModDir("playerman");
+	}
+
+ protected:
+	void TearDown() override {
+		cf_delete("frames.rpl", CF_TYPE_DEMOS);
+		cf_delete("cut.rpl", CF_TYPE_DEMOS);
+
+		test::FSTestFixture::TearDown();
+	}
+
+	static SCP_vector<input_replay_frame> make_frames() {
+		SCP_vector<input_replay_frame> frames(3);
+
+		// normal flight
+		frames[0].controls_read = true;
+		frames[0].has_control_info = true;
+		frames[0].gliding = true;
+		frames[0].time_delta = 16667;
+		frames[0].frametime = F1_0 / 60;
+		frames[0].real_frametime = 1.0f / 60.0f;
+		frames[0].state_hash = 0xdeadbeef;
+		frames[0].ci.pitch = 0.25f;
+		frames[0].ci.forward = 1.0f;
+		frames[0].ci.fire_primary_count = 1;
+		frames[0].ci.control_flags = 3;
+		frames[0].bi.status[0] = 5;
+		frames[0].keys = { 'a', 'b' };
+
+		// warping out, the keys are read but not the controls
+		frames[1].controls_read = true;
+		frames[1].time_delta = 33333;
+		frames[1].frametime = F1_0 / 30;
+		frames[1].time_compression = F1_0 * 2;
+		frames[1].state_hash = 42;
+		frames[1].bi.status[NUM_BUTTON_FIELDS - 1] = 7;
+		frames[1].keys = { 'c' };
+
+		// before the player entered
+		frames[2].time_delta = 1000;
+		frames[2].frametime = F1_0 / 1000;
+		frames[2].state_hash = 1;
+
+		return frames;
+	}
+
+	static void expect_equal(const input_replay_frame& expected, const input_replay_frame& actual) {
+		EXPECT_EQ(expected.controls_read, actual.controls_read);
+		EXPECT_EQ(expected.has_control_info, actual.has_control_info);
+		EXPECT_EQ(expected.gliding, actual.gliding);
+		EXPECT_EQ(expected.time_delta, actual.time_delta);
+		EXPECT_EQ(expected.frametime, actual.frametime);
+		EXPECT_EQ(expected.real_frametime, actual.real_frametime);
+		EXPECT_EQ(expected.time_compression, actual.time_compression);
+		EXPECT_EQ(expected.state_hash, actual.state_hash);
+		EXPECT_EQ(expected.ci.pitch, actual.ci.pitch);
+		EXPECT_EQ(expected.ci.forward, actual.ci.forward);
+		EXPECT_EQ(expected.ci.fire_primary_count, actual.ci.fire_primary_count);
+		EXPECT_EQ(expected.ci.control_flags, actual.ci.control_flags);
+		for (int i = 0; i < NUM_BUTTON_FIELDS; ++i) {
+			EXPECT_EQ(expected.bi.status[i], actual.bi.status[i]);
+		}
+		EXPECT_EQ(expected.keys, actual.keys);
+	}
+};
+
+TEST_F(InputReplayTest, frames_round_trip) {
+	auto frames = make_frames();
+
+	auto fp = cfopen("frames.rpl", "wb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	ASSERT_NE(nullptr, fp);
+	for (auto& frame : frames) {
+		input_replay_write_frame(frame, fp);
+	}
+	cfclose(fp);
+
+	fp = cfopen("frames.rpl", "rb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	ASSERT_NE(nullptr, fp);
+	for (auto& expected : frames) {
+		input_replay_frame frame;
+		ASSERT_TRUE(input_replay_read_frame(&frame, fp));
+		expect_equal(expected, frame);
+	}
+	EXPECT_TRUE(cfeof(fp));
+	cfclose(fp);
+}
+
+TEST_F(InputReplayTest, cut_short_recording) {
+	auto frames = make_frames();
+
+	// Remember where every frame ends
+	SCP_vector<int> frame_ends;
+	auto fp = cfopen("frames.rpl", "wb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	ASSERT_NE(nullptr, fp);
+	for (auto& frame : frames) {
+		input_replay_write_frame(frame, fp);
+		frame_ends.push_back(cftell(fp));
+	}
+	cfclose(fp);
+
+	fp = cfopen("frames.rpl", "rb", CFILE_NORMAL, CF_TYPE_DEMOS);
+	ASSERT_NE(nullptr, fp);
+	SCP_vector<ubyte> data(cfilelength(fp));
+	ASSERT_EQ(1, cfread(data.data(), static_cast<int>(data.size()), 1, fp));
+	cfclose(fp);
+
+	// Cut the recording after every byte, only the frames that are complete may be read back
+	for (size_t length = 0; length <= data.size(); ++length) {
+		SCOPED_TRACE(length);
+
+		fp = cfopen("cut.rpl", "wb", CFILE_NORMAL, CF_TYPE_DEMOS);
+		ASSERT_NE(nullptr, fp);
+		if (length > 0) {
+			cfwrite(data.data(), static_cast<int>(length), 1, fp);
+		}
+		cfclose(fp);
+
+		size_t complete = 0;
+		while (complete < frame_ends.size() && frame_ends[complete] <= static_cast<int>(length)) {
+			++complete;
+		}
+
+		fp = cfopen("cut.rpl", "rb", CFILE_NORMAL, CF_TYPE_DEMOS);
+		ASSERT_NE(nullptr, fp);
+
+		size_t num_read = 0;
+		input_replay_frame frame;
+		while (!cfeof(fp) && input_replay_read_frame(&frame, fp)) {
+			expect_equal(frames[num_read], frame);
+			++num_read;
+			frame = input_replay_frame();
+		}
+		cfclose(fp);
+
+		EXPECT_EQ(complete, num_read);
+	}
+}
@@ -13,6 +13,10 @@ add_file_folder("Actions\\\\Expression"
 	actions/expression/test_ExpressionParser.cpp
 )
 
+add_file_folder("bmpman"
+    bmpman/test_bmpman.cpp
+)
+
 add_file_folder("CFile"
     cfile/cfile.cpp
 )
@@ -40,6 +44,7 @@ add_file_folder("mod"
 )
 
 add_file_folder("model"
+    model/test_modelcollide.cpp
     model/test_modelread.cpp
 )
 
@@ -51,6 +56,10 @@ add_file_folder("Pilotfile"
     pilotfile/plr.cpp
 )
 
+add_file_folder("Playerman"
+    playerman/test_inputreplay.cpp
+)
+
 add_file_folder("Scripting"
     scripting/ade_args.cpp
     scripting/doc_parser.cpp
@@ -88,6 +97,7 @@ add_file_folder("Test Util"
 
 add_file_folder("Utils"
     utils/HeapAllocatorTest.cpp
+    utils/ThreadPoolTest.cpp
 )
 
 add_file_folder("Weapon"
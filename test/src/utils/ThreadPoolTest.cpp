@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include "utils/ThreadPool.h"
+
+#include <atomic>
+
+using namespace util;
+
+TEST(ThreadPoolTests, returnsResults) {
+	ThreadPool pool(4);
+
+	ASSERT_EQ((size_t)4, pool.size());
+
+	SCP_vector<std::future<int>> results;
+	for (int i = 0; i < 100; ++i) {
+		results.push_back(pool.submit([i]() { return i * i; }));
+	}
+
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(i * i, results[i].get());
+	}
+}
+
+TEST(ThreadPoolTests, finishesWorkOnDestruction) {
+	std::atomic<int> counter(0);
+
+	{
+		ThreadPool pool(2);
+		for (int i = 0; i < 50; ++i) {
+			pool.submit([&counter]() { ++counter; });
+		}
+	}
+
+	ASSERT_EQ(50, counter.load());
+}
+
+TEST(ThreadPoolTests, propagatesExceptions) {
+	ThreadPool pool(1);
+
+	auto result = pool.submit([]() -> int { throw std::runtime_error("test"); });
+
+	ASSERT_THROW(result.get(), std::runtime_error);
+}